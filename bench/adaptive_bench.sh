@@ -0,0 +1,23 @@
+#!/bin/bash
+# Compare makespan of `max_concurrent_tasks: auto` against fixed windows.
+# Usage: bench/adaptive_bench.sh [config] [binary]
+set -e
+
+CONFIG=${1:-configs/adaptive.cfg}
+BINARY=${2:-build/hw3}
+LOG_DIR=$(mktemp -d)
+TMP_CONFIG="$LOG_DIR/bench.cfg"
+trap 'rm -rf "$LOG_DIR"' EXIT
+
+run() {
+    sed "s/^max_concurrent_tasks:.*/max_concurrent_tasks: $1/" "$CONFIG" > "$TMP_CONFIG"
+    local makespan
+    makespan=$("$BINARY" -c "$TMP_CONFIG" -l "$LOG_DIR" -v NONE 2>&1 >/dev/null | sed -n 's/^Makespan: //p')
+    printf "%-8s %s\n" "$1" "$makespan"
+}
+
+echo "window   makespan"
+for window in 1 2 4 8 16 32; do
+    run "$window"
+done
+run auto
@@ -0,0 +1,24 @@
+#include <stdlib.h>
+
+#include "graph_bench.h"
+#include "scheduler_bench.h"
+#include "history_bench.h"
+#include "spawn_bench.h"
+#include "timer_wheel_bench.h"
+#include "trace_bench.h"
+#include "container_bench.h"
+#include "config_bench.h"
+
+int main(void) {
+    RunGraphBench();
+    RunSchedulerBench();
+    RunFailurePropagationBench();
+    RunHistoryBench();
+    RunSpawnBench();
+    RunTimerWheelBench();
+    RunTraceBench();
+    RunContainerBench();
+    RunConfigLoadBench();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,45 @@
+#include "bench_utils.h"
+
+// glibc's own entry points, the interposed ones below only count calls
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t num, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+
+static size_t num_allocations = 0;
+
+void* malloc(size_t size) {
+    num_allocations++;
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t num, size_t size) {
+    num_allocations++;
+    return __libc_calloc(num, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    num_allocations++;
+    return __libc_realloc(ptr, size);
+}
+
+size_t GetAllocationCount(void) {
+    return num_allocations;
+}
+
+long long GetMonotonicNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void PrintBenchHeader(const char* title) {
+    printf("\n== %s ==\n", title);
+}
+
+void PrintBenchResult(const char* name, size_t n, double ns_per_op) {
+    printf("%-40s n=%-9zu %12.1f ns/op\n", name, n, ns_per_op);
+}
+
+void PrintBenchAllocResult(const char* name, size_t n, double ns_per_op, double allocs_per_op) {
+    printf("%-40s n=%-9zu %12.1f ns/op %8.2f allocs/op\n", name, n, ns_per_op, allocs_per_op);
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Current CLOCK_MONOTONIC time in nanoseconds.
+long long GetMonotonicNs(void);
+
+// Print benchmark section header.
+void PrintBenchHeader(const char* title);
+
+// Print one benchmark result row: `<name> n=<n> <ns_per_op> ns/op`.
+void PrintBenchResult(const char* name, size_t n, double ns_per_op);
+
+// Print one benchmark result row with heap allocations per operation.
+void PrintBenchAllocResult(const char* name, size_t n, double ns_per_op, double allocs_per_op);
+
+// Get number of malloc, calloc and realloc calls made by the process so far.
+// The bench binary interposes the allocator entry points to count them.
+size_t GetAllocationCount(void);
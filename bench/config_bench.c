@@ -0,0 +1,187 @@
+#include "config_bench.h"
+
+// Single core budget for loading a million-task config, parse to cycle check
+#define CONFIG_LOAD_BUDGET_S 10.0
+#define CONFIG_LOAD_BUDGET_TASKS 1000000
+
+// Task i requires tasks i / 2 and i / 3, same layered shape as the scheduler bench
+static bool WriteBenchConfig(const char* path, size_t num_tasks, long* size) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        return false;
+    }
+
+    fprintf(file, "[main]\nmax_concurrent_tasks: 64\ndefault_timeout: 10\n\n");
+    for (size_t i = 0; i < num_tasks; ++i) {
+        fprintf(file, "[task]\nname: task-%zu\ntype: SLEEP\nsleep_duration: 0\n", i);
+        if (i > 0) {
+            fprintf(file, "requires: task-%zu", i / 2);
+            if (i / 3 != i / 2) {
+                fprintf(file, " task-%zu", i / 3);
+            }
+            fprintf(file, "\n");
+        }
+        fprintf(file, "\n");
+    }
+
+    *size = ftell(file);
+    return fclose(file) == 0;
+}
+
+// Tokenizer alone: load the text and split every line
+static long long ScanBenchConfig(const char* path, size_t* num_lines) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return -1;
+    }
+
+    ConfigBuffer buffer;
+    ConfigLineReader reader;
+    ConfigLine line;
+
+    long long start = GetMonotonicNs();
+    if (!LoadConfigBuffer(file, &buffer)) {
+        fclose(file);
+        return -1;
+    }
+
+    *num_lines = 0;
+    InitConfigLineReader(&reader, &buffer);
+    while (NextConfigLine(&reader, &line)) {
+        *num_lines += line.key.len != 0;
+    }
+    long long elapsed = GetMonotonicNs() - start;
+
+    ReleaseConfigBuffer(&buffer);
+    fclose(file);
+    return elapsed;
+}
+
+// Same steps as the master: requirements are task indices already, edges are copied and compiled
+static Graph* BuildBenchGraph(const ExecutionConfig* config) {
+    Graph* graph = NewGraph(config->num_tasks);
+    if (!graph) {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < config->num_tasks; ++i) {
+        const TaskConfig* task = config->tasks[i];
+
+        for (size_t k = 0; k < task->num_dependencies; ++k) {
+            AddDirectedEdge(graph, i, task->dependencies[k]);
+        }
+    }
+
+    CompileGraph(graph);
+    return graph;
+}
+
+// Streamed parse of the same file: sections are admitted as they arrive, cycles are checked incrementally.
+// Sets first_admitted to the time the first task could have been started.
+static long long StreamBenchConfig(const char* path, size_t num_tasks, long long* first_admitted) {
+    *first_admitted = -1;
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        return -1;
+    }
+
+    long long start = GetMonotonicNs();
+    ConfigStream* stream = NewConfigStream(fd, "/tmp");
+    size_t num_admitted = 0;
+    int status = stream ? 1 : -1;
+    int task;
+
+    while (status == 1) {
+        status = PumpConfigStream(stream);
+        while (status != -1 && NextAdmittedTask(stream, &task)) {
+            if (num_admitted++ == 0) {
+                *first_admitted = GetMonotonicNs() - start;
+            }
+        }
+    }
+    long long elapsed = GetMonotonicNs() - start;
+
+    if (stream) {
+        FreeExecutionConfig(stream->config);
+        FreeConfigStream(stream);
+    }
+    close(fd);
+    return status == 0 && num_admitted == num_tasks ? elapsed : -1;
+}
+
+void RunConfigLoadBench(void) {
+    const size_t sizes[] = {10000, 100000, 1000000};
+    const size_t num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+    const char* path = "/tmp/hw3_bench_config.cfg";
+
+    PrintBenchHeader("Config load: parse, graph build and cycle check per task");
+
+    for (size_t s = 0; s < num_sizes; ++s) {
+        size_t n = sizes[s];
+        long size;
+
+        if (!WriteBenchConfig(path, n, &size)) {
+            fprintf(stderr, "config generation failed for n=%zu\n", n);
+            return;
+        }
+
+        size_t num_keys;
+        long long scan = ScanBenchConfig(path, &num_keys);
+
+        FILE* file = fopen(path, "r");
+        if (scan < 0 || !file) {
+            fprintf(stderr, "config opening failed for n=%zu\n", n);
+            return;
+        }
+
+        long long start = GetMonotonicNs();
+        ExecutionConfig* config = ReadExecutionConfig(file, "/tmp");
+        long long parse = GetMonotonicNs() - start;
+        fclose(file);
+
+        if (!config || config->num_tasks != n) {
+            fprintf(stderr, "config loading failed for n=%zu\n", n);
+            FreeExecutionConfig(config);
+            unlink(path);
+            return;
+        }
+
+        start = GetMonotonicNs();
+        Graph* graph = BuildBenchGraph(config);
+        long long build = GetMonotonicNs() - start;
+
+        start = GetMonotonicNs();
+        bool acyclic = graph && IsAcyclic(graph);
+        long long check = GetMonotonicNs() - start;
+
+        if (!acyclic) {
+            fprintf(stderr, "graph construction failed for n=%zu\n", n);
+        }
+
+        long long first_admitted;
+        long long stream = StreamBenchConfig(path, n, &first_admitted);
+        if (stream < 0) {
+            fprintf(stderr, "config streaming failed for n=%zu\n", n);
+        }
+
+        PrintBenchResult("parse + validate", n, (double)parse / n);
+        PrintBenchResult("streamed parse + cycle check", n, (double)stream / n);
+        printf("%-40s n=%-9zu %12.3f ms\n", "streamed first task admitted", n, first_admitted / 1e6);
+        PrintBenchResult("graph build", n, (double)build / n);
+        PrintBenchResult("IsAcyclic", n, (double)check / n);
+        printf("%-40s n=%-9zu %12.1f MB/s\n", "line scan throughput", n, size / 1e6 / (scan / 1e9));
+        printf("%-40s n=%-9zu %12.1f MB/s\n", "parse + validate throughput", n, size / 1e6 / (parse / 1e9));
+
+        double total_s = (parse + build + check) / 1e9;
+        if (n == CONFIG_LOAD_BUDGET_TASKS) {
+            printf("%-40s n=%-9zu %12.3f s (budget %.1f s: %s)\n", "total load", n, total_s,
+                   CONFIG_LOAD_BUDGET_S, total_s <= CONFIG_LOAD_BUDGET_S ? "ok" : "EXCEEDED");
+        } else {
+            printf("%-40s n=%-9zu %12.3f s\n", "total load", n, total_s);
+        }
+
+        FreeGraph(graph);
+        FreeExecutionConfig(config);
+        unlink(path);
+    }
+}
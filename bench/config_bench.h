@@ -0,0 +1,11 @@
+#pragma once
+
+#include <fcntl.h>
+
+#include "bench_utils.h"
+#include "../src/config.h"
+#include "../src/graph.h"
+
+// Generate configs of up to a million tasks and time the whole load path:
+// parsing with name resolution and validation, graph build, cycle check.
+void RunConfigLoadBench(void);
@@ -0,0 +1,554 @@
+#include "container_bench.h"
+
+// Every measurement is the best of several repetitions, which is what stays comparable across commits
+#define BENCH_REPETITIONS 5
+
+// Misses walk whole probe clusters at high load, so fewer of them are timed
+#define BENCH_MAX_MISSES 10000
+
+// Loads a presized table is filled to, the last one stays below the 7/8 growth threshold
+static const double kBenchLoadFactors[] = {0.25, 0.5, 0.75, 0.85};
+#define BENCH_NUM_LOAD_FACTORS (sizeof(kBenchLoadFactors) / sizeof(kBenchLoadFactors[0]))
+
+#define QUEUE_BENCH_MAX_THREADS 4
+#define QUEUE_BENCH_HANDOFFS 1000000
+
+typedef struct BenchSample {
+    double ns_per_op;
+    double allocs_per_op;
+} BenchSample;
+
+static void KeepBest(BenchSample* best, long long elapsed_ns, size_t num_allocations, size_t num_ops) {
+    double ns_per_op = (double)elapsed_ns / num_ops;
+
+    if (best->ns_per_op == 0 || ns_per_op < best->ns_per_op) {
+        best->ns_per_op = ns_per_op;
+    }
+    best->allocs_per_op = (double)num_allocations / num_ops;
+}
+
+static char** NewBenchKeys(size_t n) {
+    char** keys = malloc(sizeof(char*) * n);
+    if (!keys) {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        keys[i] = malloc(24);
+        snprintf(keys[i], 24, "task-%zu", i * 7919);
+    }
+
+    return keys;
+}
+
+static void FreeBenchKeys(char** keys, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        free(keys[i]);
+    }
+    free(keys);
+}
+
+// capacity_hint 0 leaves the map to grow from its minimum size
+static void RunStringMapBench(size_t n, size_t capacity_hint, const char* variant, char** keys, char** missing_keys) {
+    BenchSample insert = {0}, hit = {0}, miss = {0};
+    size_t num_misses = n < BENCH_MAX_MISSES ? n : BENCH_MAX_MISSES;
+    int value;
+
+    for (int r = 0; r < BENCH_REPETITIONS; ++r) {
+        StringMap* map = NewStringMap(capacity_hint);
+
+        size_t allocations = GetAllocationCount();
+        long long start = GetMonotonicNs();
+        for (size_t i = 0; i < n; ++i) {
+            SetStringMapValue(map, keys[i], i, false);
+        }
+        KeepBest(&insert, GetMonotonicNs() - start, GetAllocationCount() - allocations, n);
+
+        allocations = GetAllocationCount();
+        start = GetMonotonicNs();
+        for (size_t i = 0; i < n; ++i) {
+            GetStringMapValue(map, keys[i], &value);
+        }
+        KeepBest(&hit, GetMonotonicNs() - start, GetAllocationCount() - allocations, n);
+
+        allocations = GetAllocationCount();
+        start = GetMonotonicNs();
+        for (size_t i = 0; i < num_misses; ++i) {
+            GetStringMapValue(map, missing_keys[i], &value);
+        }
+        KeepBest(&miss, GetMonotonicNs() - start, GetAllocationCount() - allocations, num_misses);
+
+        FreeStringMap(map);
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "StringMap insert (%s)", variant);
+    PrintBenchAllocResult(name, n, insert.ns_per_op, insert.allocs_per_op);
+    snprintf(name, sizeof(name), "StringMap lookup hit (%s)", variant);
+    PrintBenchAllocResult(name, n, hit.ns_per_op, hit.allocs_per_op);
+    snprintf(name, sizeof(name), "StringMap lookup miss (%s)", variant);
+    PrintBenchAllocResult(name, num_misses, miss.ns_per_op, miss.allocs_per_op);
+}
+
+// Hint which makes the map allocate exactly table_capacity slots, table_capacity being a power of two
+static size_t HintForTableCapacity(size_t table_capacity) {
+    return table_capacity * MAP_MAX_LOAD_NUM / MAP_MAX_LOAD_DEN;
+}
+
+// Largest power of two not above n, so that the loads of the sweep never need more than n keys
+static size_t SweepTableCapacity(size_t n) {
+    size_t capacity = 1;
+    while (capacity * 2 <= n) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+static void RunStringMapLoadBench(size_t n, char** keys, char** missing_keys) {
+    size_t table_capacity = SweepTableCapacity(n);
+    char variant[32];
+
+    for (size_t l = 0; l < BENCH_NUM_LOAD_FACTORS; ++l) {
+        snprintf(variant, sizeof(variant), "load %.2f", kBenchLoadFactors[l]);
+        RunStringMapBench(table_capacity * kBenchLoadFactors[l], HintForTableCapacity(table_capacity), variant,
+                          keys, missing_keys);
+    }
+}
+
+// What IntMap did before it had its own table: keys formatted as decimal strings
+static bool SetStringKeyedValue(StringMap* map, int key, int value) {
+    char string_key[12];
+    snprintf(string_key, 12, "%d", key);
+    return SetStringMapValue(map, string_key, value, false);
+}
+
+static bool GetStringKeyedValue(const StringMap* map, int key, int* value) {
+    char string_key[12];
+    snprintf(string_key, 12, "%d", key);
+    return GetStringMapValue(map, string_key, value);
+}
+
+static void PrintIntMapBenchResults(const char* variant, size_t n, size_t num_misses,
+                                    const BenchSample* insert, const BenchSample* hit, const BenchSample* miss) {
+    char name[64];
+    snprintf(name, sizeof(name), "%s insert", variant);
+    PrintBenchAllocResult(name, n, insert->ns_per_op, insert->allocs_per_op);
+    snprintf(name, sizeof(name), "%s lookup hit", variant);
+    PrintBenchAllocResult(name, n, hit->ns_per_op, hit->allocs_per_op);
+    snprintf(name, sizeof(name), "%s lookup miss", variant);
+    PrintBenchAllocResult(name, num_misses, miss->ns_per_op, miss->allocs_per_op);
+}
+
+static void RunStringKeyedIntMapBench(size_t n) {
+    BenchSample insert = {0}, hit = {0}, miss = {0};
+    size_t num_misses = n < BENCH_MAX_MISSES ? n : BENCH_MAX_MISSES;
+    int value;
+
+    for (int r = 0; r < BENCH_REPETITIONS; ++r) {
+        StringMap* map = NewStringMap(0);
+
+        size_t allocations = GetAllocationCount();
+        long long start = GetMonotonicNs();
+        for (size_t i = 0; i < n; ++i) {
+            SetStringKeyedValue(map, i * 7 + 1000, i);
+        }
+        KeepBest(&insert, GetMonotonicNs() - start, GetAllocationCount() - allocations, n);
+
+        allocations = GetAllocationCount();
+        start = GetMonotonicNs();
+        for (size_t i = 0; i < n; ++i) {
+            GetStringKeyedValue(map, i * 7 + 1000, &value);
+        }
+        KeepBest(&hit, GetMonotonicNs() - start, GetAllocationCount() - allocations, n);
+
+        allocations = GetAllocationCount();
+        start = GetMonotonicNs();
+        for (size_t i = 0; i < num_misses; ++i) {
+            GetStringKeyedValue(map, i * 7 + 1001, &value);
+        }
+        KeepBest(&miss, GetMonotonicNs() - start, GetAllocationCount() - allocations, num_misses);
+
+        FreeStringMap(map);
+    }
+
+    PrintIntMapBenchResults("IntMap (string keys)", n, num_misses, &insert, &hit, &miss);
+}
+
+// Hashed keys are pid-like, spread but not random; dense keys are every other id of [0, 2n)
+// Hashed keys are grown from capacity_hint, 0 leaves the map to grow from its minimum size
+static void RunIntMapBench(size_t n, size_t capacity_hint, bool dense, const char* variant) {
+    BenchSample insert = {0}, hit = {0}, miss = {0};
+    size_t num_misses = n < BENCH_MAX_MISSES ? n : BENCH_MAX_MISSES;
+    int stride = dense ? 2 : 7;
+    int offset = dense ? 0 : 1000;
+    int value;
+
+    for (int r = 0; r < BENCH_REPETITIONS; ++r) {
+        IntMap* map = dense ? NewDenseIntMap(2 * n) : NewIntMap(capacity_hint);
+
+        size_t allocations = GetAllocationCount();
+        long long start = GetMonotonicNs();
+        for (size_t i = 0; i < n; ++i) {
+            SetIntMapValue(map, i * stride + offset, i, false);
+        }
+        KeepBest(&insert, GetMonotonicNs() - start, GetAllocationCount() - allocations, n);
+
+        allocations = GetAllocationCount();
+        start = GetMonotonicNs();
+        for (size_t i = 0; i < n; ++i) {
+            GetIntMapValue(map, i * stride + offset, &value);
+        }
+        KeepBest(&hit, GetMonotonicNs() - start, GetAllocationCount() - allocations, n);
+
+        allocations = GetAllocationCount();
+        start = GetMonotonicNs();
+        for (size_t i = 0; i < num_misses; ++i) {
+            GetIntMapValue(map, i * stride + offset + 1, &value);
+        }
+        KeepBest(&miss, GetMonotonicNs() - start, GetAllocationCount() - allocations, num_misses);
+
+        FreeIntMap(map);
+    }
+
+    PrintIntMapBenchResults(variant, n, num_misses, &insert, &hit, &miss);
+}
+
+static void RunIntMapLoadBench(size_t n) {
+    size_t table_capacity = SweepTableCapacity(n);
+    char variant[32];
+
+    for (size_t l = 0; l < BENCH_NUM_LOAD_FACTORS; ++l) {
+        snprintf(variant, sizeof(variant), "IntMap (load %.2f)", kBenchLoadFactors[l]);
+        RunIntMapBench(table_capacity * kBenchLoadFactors[l], HintForTableCapacity(table_capacity), false, variant);
+    }
+}
+
+static void RunVectorBench(size_t n, char** keys) {
+    BenchSample ints = {0}, strings = {0};
+
+    for (int r = 0; r < BENCH_REPETITIONS; ++r) {
+        IntVector* int_vector = NewIntVector(1);
+        StringVector* string_vector = NewStringVector(1);
+
+        size_t allocations = GetAllocationCount();
+        long long start = GetMonotonicNs();
+        for (size_t i = 0; i < n; ++i) {
+            AppendToIntVector(int_vector, i);
+        }
+        KeepBest(&ints, GetMonotonicNs() - start, GetAllocationCount() - allocations, n);
+
+        allocations = GetAllocationCount();
+        start = GetMonotonicNs();
+        for (size_t i = 0; i < n; ++i) {
+            AppendToStringVector(string_vector, keys[i]);
+        }
+        KeepBest(&strings, GetMonotonicNs() - start, GetAllocationCount() - allocations, n);
+
+        FreeIntVector(int_vector);
+        FreeStringVector(string_vector);
+    }
+
+    PrintBenchAllocResult("AppendToIntVector from capacity 1", n, ints.ns_per_op, ints.allocs_per_op);
+    PrintBenchAllocResult("AppendToStringVector from capacity 1", n, strings.ns_per_op, strings.allocs_per_op);
+}
+
+// What Queue was before the ring buffer: a heap node per element
+typedef struct LinkedQueueNode {
+    int value;
+    struct LinkedQueueNode* next;
+} LinkedQueueNode;
+
+typedef struct LinkedQueue {
+    LinkedQueueNode* first;
+    LinkedQueueNode* last;
+} LinkedQueue;
+
+static void PushLinkedQueue(LinkedQueue* queue, int elem) {
+    LinkedQueueNode* node = malloc(sizeof(LinkedQueueNode));
+    node->value = elem;
+    node->next = NULL;
+    if (queue->last) {
+        queue->last->next = node;
+    } else {
+        queue->first = node;
+    }
+    queue->last = node;
+}
+
+static int PopLinkedQueue(LinkedQueue* queue) {
+    LinkedQueueNode* node = queue->first;
+    int value = node->value;
+    queue->first = node->next;
+    if (!queue->first) {
+        queue->last = NULL;
+    }
+    free(node);
+    return value;
+}
+
+static void PrintQueueBenchResults(const char* variant, size_t n, const BenchSample* bulk, const BenchSample* steady) {
+    char name[64];
+    snprintf(name, sizeof(name), "%s push all + pop all", variant);
+    PrintBenchAllocResult(name, n, bulk->ns_per_op, bulk->allocs_per_op);
+    snprintf(name, sizeof(name), "%s push + pop, depth 16", variant);
+    PrintBenchAllocResult(name, n, steady->ns_per_op, steady->allocs_per_op);
+}
+
+static void RunLinkedQueueBench(size_t n) {
+    BenchSample bulk = {0}, steady = {0};
+    volatile int value;
+
+    for (int r = 0; r < BENCH_REPETITIONS; ++r) {
+        LinkedQueue queue = {NULL, NULL};
+
+        size_t allocations = GetAllocationCount();
+        long long start = GetMonotonicNs();
+        for (size_t i = 0; i < n; ++i) {
+            PushLinkedQueue(&queue, i);
+        }
+        while (queue.first) {
+            value = PopLinkedQueue(&queue);
+        }
+        KeepBest(&bulk, GetMonotonicNs() - start, GetAllocationCount() - allocations, n);
+
+        for (int i = 0; i < 16; ++i) {
+            PushLinkedQueue(&queue, i);
+        }
+        allocations = GetAllocationCount();
+        start = GetMonotonicNs();
+        for (size_t i = 0; i < n; ++i) {
+            PushLinkedQueue(&queue, i);
+            value = PopLinkedQueue(&queue);
+        }
+        KeepBest(&steady, GetMonotonicNs() - start, GetAllocationCount() - allocations, n);
+
+        while (queue.first) {
+            value = PopLinkedQueue(&queue);
+        }
+    }
+
+    (void)value;
+    PrintQueueBenchResults("Queue linked", n, &bulk, &steady);
+}
+
+static void RunQueueBench(size_t n) {
+    BenchSample bulk = {0}, steady = {0};
+    int value;
+
+    for (int r = 0; r < BENCH_REPETITIONS; ++r) {
+        Queue* queue = NewQueue();
+
+        // Fill then drain, as the initial ready set is
+        size_t allocations = GetAllocationCount();
+        long long start = GetMonotonicNs();
+        for (size_t i = 0; i < n; ++i) {
+            Push(queue, i);
+        }
+        while (!IsEmpty(queue)) {
+            Front(queue, &value);
+            Pop(queue);
+        }
+        KeepBest(&bulk, GetMonotonicNs() - start, GetAllocationCount() - allocations, n);
+
+        // Short queue with a push and a pop per step, as a running dispatcher has
+        for (int i = 0; i < 16; ++i) {
+            Push(queue, i);
+        }
+        allocations = GetAllocationCount();
+        start = GetMonotonicNs();
+        for (size_t i = 0; i < n; ++i) {
+            Push(queue, i);
+            Front(queue, &value);
+            Pop(queue);
+        }
+        KeepBest(&steady, GetMonotonicNs() - start, GetAllocationCount() - allocations, n);
+
+        FreeQueue(queue);
+    }
+
+    PrintQueueBenchResults("Queue ring", n, &bulk, &steady);
+}
+
+// Same access pattern from a single thread, the price of the atomics without contention
+static void RunMpmcQueueBench(size_t n) {
+    BenchSample bulk = {0}, steady = {0};
+    int value;
+
+    for (int r = 0; r < BENCH_REPETITIONS; ++r) {
+        MpmcQueue* queue = NewMpmcQueue(n);
+
+        size_t allocations = GetAllocationCount();
+        long long start = GetMonotonicNs();
+        for (size_t i = 0; i < n; ++i) {
+            PushMpmcQueue(queue, i);
+        }
+        while (PopMpmcQueue(queue, &value)) {
+        }
+        KeepBest(&bulk, GetMonotonicNs() - start, GetAllocationCount() - allocations, n);
+
+        for (int i = 0; i < 16; ++i) {
+            PushMpmcQueue(queue, i);
+        }
+        allocations = GetAllocationCount();
+        start = GetMonotonicNs();
+        for (size_t i = 0; i < n; ++i) {
+            PushMpmcQueue(queue, i);
+            PopMpmcQueue(queue, &value);
+        }
+        KeepBest(&steady, GetMonotonicNs() - start, GetAllocationCount() - allocations, n);
+
+        FreeMpmcQueue(queue);
+    }
+
+    PrintQueueBenchResults("MpmcQueue 1 thread", n, &bulk, &steady);
+}
+
+typedef struct QueueBenchWorker {
+    MpmcQueue* mpmc;
+    Queue* queue;           // used under the mutex when mpmc is NULL
+    pthread_mutex_t* mutex;
+    atomic_size_t* popped;  // shared by the consumers
+    size_t num_ops;         // producers: elements to push; consumers: total to pop between them
+} QueueBenchWorker;
+
+static bool PushBenchWorkerQueue(QueueBenchWorker* worker, int elem) {
+    if (worker->mpmc) {
+        return PushMpmcQueue(worker->mpmc, elem);
+    }
+
+    pthread_mutex_lock(worker->mutex);
+    bool pushed = Push(worker->queue, elem);
+    pthread_mutex_unlock(worker->mutex);
+    return pushed;
+}
+
+static bool PopBenchWorkerQueue(QueueBenchWorker* worker, int* elem) {
+    if (worker->mpmc) {
+        return PopMpmcQueue(worker->mpmc, elem);
+    }
+
+    pthread_mutex_lock(worker->mutex);
+    bool popped = Front(worker->queue, elem) && Pop(worker->queue);
+    pthread_mutex_unlock(worker->mutex);
+    return popped;
+}
+
+static void* ProduceBenchValues(void* arg) {
+    QueueBenchWorker* worker = arg;
+    for (size_t i = 0; i < worker->num_ops; ++i) {
+        while (!PushBenchWorkerQueue(worker, i)) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void* ConsumeBenchValues(void* arg) {
+    QueueBenchWorker* worker = arg;
+    int value;
+
+    while (atomic_load_explicit(worker->popped, memory_order_relaxed) < worker->num_ops) {
+        if (PopBenchWorkerQueue(worker, &value)) {
+            atomic_fetch_add_explicit(worker->popped, 1, memory_order_relaxed);
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+// n elements spread over num_threads producers and as many consumers, reported per element handed over
+static void RunQueueThroughputBench(size_t n, int num_threads, bool lock_free) {
+    double best = 0;
+
+    for (int r = 0; r < BENCH_REPETITIONS; ++r) {
+        pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+        atomic_size_t popped;
+        atomic_init(&popped, 0);
+
+        QueueBenchWorker producer = {.mutex = &mutex, .popped = &popped, .num_ops = n / num_threads};
+        if (lock_free) {
+            producer.mpmc = NewMpmcQueue(1024);
+        } else {
+            producer.queue = NewQueue();
+        }
+        QueueBenchWorker consumer = producer;
+        consumer.num_ops = producer.num_ops * num_threads;
+
+        pthread_t threads[2 * QUEUE_BENCH_MAX_THREADS];
+        long long start = GetMonotonicNs();
+        for (int i = 0; i < num_threads; ++i) {
+            pthread_create(&threads[i], NULL, ConsumeBenchValues, &consumer);
+            pthread_create(&threads[num_threads + i], NULL, ProduceBenchValues, &producer);
+        }
+        for (int i = 0; i < 2 * num_threads; ++i) {
+            pthread_join(threads[i], NULL);
+        }
+        double ns_per_op = (double)(GetMonotonicNs() - start) / consumer.num_ops;
+        if (best == 0 || ns_per_op < best) {
+            best = ns_per_op;
+        }
+
+        FreeMpmcQueue(producer.mpmc);
+        FreeQueue(producer.queue);
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "%s %dP/%dC", lock_free ? "MpmcQueue" : "Queue + mutex", num_threads, num_threads);
+    PrintBenchResult(name, n, best);
+}
+
+void RunContainerBench(void) {
+    const size_t sizes[] = {1000, 100000};
+    // Lookups into the growing map should cost the same at every size
+    const size_t map_sizes[] = {1000, 100000, 1000000};
+    const size_t num_map_sizes = sizeof(map_sizes) / sizeof(map_sizes[0]);
+    const size_t num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+
+    PrintBenchHeader("Containers: StringMap, IntMap, vectors, Queue and MpmcQueue");
+
+    for (size_t s = 0; s < num_sizes; ++s) {
+        size_t n = sizes[s];
+        char** keys = NewBenchKeys(n);
+        char** missing_keys = NewBenchKeys(2 * n);
+        if (!keys || !missing_keys) {
+            fprintf(stderr, "key generation failed for n=%zu\n", n);
+            return;
+        }
+
+        // Keys past the first n are never inserted
+        RunStringMapLoadBench(n, keys, missing_keys + n);
+        RunStringKeyedIntMapBench(n);
+        RunIntMapLoadBench(n);
+        RunIntMapBench(n, 0, false, "IntMap (hashed)");
+        RunIntMapBench(n, 0, true, "IntMap (dense)");
+        RunVectorBench(n, keys);
+        RunLinkedQueueBench(n);
+        RunQueueBench(n);
+        RunMpmcQueueBench(n);
+
+        FreeBenchKeys(keys, n);
+        FreeBenchKeys(missing_keys, 2 * n);
+    }
+
+    // Threads take turns on a single core, the spread between the queues is what matters there
+    for (int num_threads = 1; num_threads <= QUEUE_BENCH_MAX_THREADS; num_threads *= 2) {
+        RunQueueThroughputBench(QUEUE_BENCH_HANDOFFS, num_threads, false);
+        RunQueueThroughputBench(QUEUE_BENCH_HANDOFFS, num_threads, true);
+    }
+
+    for (size_t s = 0; s < num_map_sizes; ++s) {
+        size_t n = map_sizes[s];
+        char** keys = NewBenchKeys(2 * n);
+        if (!keys) {
+            fprintf(stderr, "key generation failed for n=%zu\n", n);
+            return;
+        }
+
+        // Keys past the first n are never inserted
+        RunStringMapBench(n, n, "presized", keys, keys + n);
+        RunStringMapBench(n, 0, "grown", keys, keys + n);
+
+        FreeBenchKeys(keys, 2 * n);
+    }
+}
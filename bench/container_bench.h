@@ -0,0 +1,16 @@
+#pragma once
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "bench_utils.h"
+#include "../src/vector.h"
+#include "../src/queue.h"
+#include "../src/mpmc_queue.h"
+#include "../src/map.h"
+
+// Measure throughput and heap allocations of the container library:
+// StringMap and IntMap at several loads, StringMap presized and grown up to a million keys,
+// IntMap hashed and dense against string-formatted keys, vector growth, and queue push/pop:
+// linked nodes against the ring buffer and the lock-free MPMC queue, alone and with threads.
+void RunContainerBench(void);
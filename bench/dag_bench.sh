@@ -0,0 +1,46 @@
+#!/bin/bash
+# End-to-end scheduler benchmark on generated DAGs of zero-duration tasks.
+# Reports startup phases and the per-task scheduling overhead, i.e. makespan / tasks.
+# Every config is run twice, the second run starts from the compiled DAG cache left by the first.
+# Usage: bench/dag_bench.sh [sizes] [shapes] [binary] [generator]
+#   SIZES and SHAPES are space separated lists, e.g. bench/dag_bench.sh "1000 1000000" "chain random"
+#   DAG_BENCH_EXEC=1 runs EXEC tasks (`true`) instead of SLEEP tasks.
+set -e
+
+SIZES=${1:-10 100 1000 10000}
+SHAPES=${2:-chain fan diamond layered random}
+BINARY=${3:-build/hw3}
+GENERATOR=${4:-build/dag_gen}
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+GEN_FLAGS=""
+if [ -n "$DAG_BENCH_EXEC" ]; then
+    GEN_FLAGS="--exec"
+fi
+
+printf "%-8s %8s %10s %10s %10s %10s %11s %14s\n" "shape" "tasks" "parse ms" "graph ms" "cycle ms" "cached ms" "makespan s" "overhead us/task"
+for shape in $SHAPES; do
+    for size in $SIZES; do
+        config="$WORK_DIR/$shape-$size.cfg"
+        log_dir="$WORK_DIR/logs"
+        rm -rf "$log_dir" && mkdir "$log_dir"
+
+        "$GENERATOR" "$shape" "$size" $GEN_FLAGS > "$config"
+        output=$("$BINARY" -c "$config" -l "$log_dir" -v NONE -L 2>&1 >/dev/null || true)
+        cached=$("$BINARY" -c "$config" -l "$log_dir" -v NONE -L 2>&1 >/dev/null | grep "^Startup, ms: cache load" || true)
+
+        if ! grep -q "^Makespan: " <<< "$output"; then
+            printf "%-8s %8s   %s\n" "$shape" "$size" "$(tail -n 1 <<< "$output")"
+            continue
+        fi
+
+        awk -v shape="$shape" -v size="$size" -v cached="${cached##* }" '
+            /^Makespan: / { makespan = $2 }
+            /^Startup, ms: parse/ { parse = $4; graph = $7; cycle = $10; gsub(",", "", parse); gsub(",", "", graph) }
+            END {
+                printf "%-8s %8d %10.3f %10.3f %10.3f %10.3f %11.3f %14.2f\n",
+                       shape, size, parse, graph, cycle, cached, makespan, makespan * 1e6 / size
+            }' <<< "$output"
+    done
+done
@@ -0,0 +1,54 @@
+#include "graph_bench.h"
+
+// Memory held by the compiled graph, staged edge lists included
+static size_t GraphMemoryBytes(const Graph* graph) {
+    size_t num_vertices = GetGraphSize(graph);
+
+    return sizeof(Graph) +
+           2 * sizeof(size_t) * (num_vertices + 1) +
+           2 * sizeof(int) * (GetEdgeCount(graph) + 1) +
+           sizeof(int) * (graph->edges_from_->capacity_ + graph->edges_to_->capacity_);
+}
+
+void RunGraphBench(void) {
+    const size_t sizes[] = {1000, 10000, 100000, 1000000};
+    const size_t num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+    const size_t edges_per_vertex = 4;
+
+    PrintBenchHeader("Graph: CSR build, cycle check and memory vs dense matrix");
+
+    for (size_t s = 0; s < num_sizes; ++s) {
+        size_t n = sizes[s];
+        Graph* graph = NewGraph(n);
+        if (!graph) {
+            fprintf(stderr, "graph construction failed for n=%zu\n", n);
+            return;
+        }
+
+        long long start = GetMonotonicNs();
+        for (size_t v = 1; v < n; ++v) {
+            for (size_t k = 1; k <= edges_per_vertex && k <= v; ++k) {
+                AddDirectedEdge(graph, v, (v * k) / (k + 1));
+            }
+        }
+        CompileGraph(graph);
+        long long build = GetMonotonicNs() - start;
+
+        start = GetMonotonicNs();
+        bool acyclic = IsAcyclic(graph);
+        long long check = GetMonotonicNs() - start;
+
+        if (!acyclic) {
+            fprintf(stderr, "unexpected cycle for n=%zu\n", n);
+        }
+
+        PrintBenchResult("build per vertex", n, (double)build / n);
+        PrintBenchResult("IsAcyclic per vertex", n, (double)check / n);
+        printf("%-40s n=%-9zu %12.1f MiB (matrix would take %.1f MiB)\n",
+               "memory", n,
+               GraphMemoryBytes(graph) / (1024.0 * 1024.0),
+               (double)n * n * sizeof(int) / (1024.0 * 1024.0));
+
+        FreeGraph(graph);
+    }
+}
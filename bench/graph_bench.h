@@ -0,0 +1,7 @@
+#pragma once
+
+#include "bench_utils.h"
+#include "../src/graph.h"
+
+// Measure CSR graph build and cycle check time and compare its memory with a dense matrix.
+void RunGraphBench(void);
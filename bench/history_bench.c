@@ -0,0 +1,80 @@
+#include "history_bench.h"
+
+#define BENCH_HISTORY_TASKS 1000
+
+static bool WriteHistoryFile(const char* path, size_t num_records, char** names) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        return false;
+    }
+
+    HistoryHeader header = {
+        .magic = HISTORY_MAGIC,
+        .version = HISTORY_VERSION,
+        .record_size = sizeof(TaskRunRecord)
+    };
+    fwrite(&header, sizeof(header), 1, file);
+
+    for (size_t i = 0; i < num_records; ++i) {
+        TaskRunRecord record = {
+            .name_hash = HashTaskName(names[i % BENCH_HISTORY_TASKS]),
+            .start_ns = i * 1000000LL,
+            .end_ns = i * 1000000LL + (i % 997) * 1000000LL,
+            .wait_status = 0
+        };
+        fwrite(&record, sizeof(record), 1, file);
+    }
+
+    fclose(file);
+    return true;
+}
+
+void RunHistoryBench(void) {
+    const size_t sizes[] = {10000, 1000000, 4000000};
+    const size_t num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+    const char* path = "/tmp/hw3_bench_history.bin";
+
+    char* names[BENCH_HISTORY_TASKS];
+    TaskConfig tasks[BENCH_HISTORY_TASKS];
+    TaskConfig* task_ptrs[BENCH_HISTORY_TASKS];
+    for (int i = 0; i < BENCH_HISTORY_TASKS; ++i) {
+        names[i] = malloc(16);
+        snprintf(names[i], 16, "task-%d", i);
+        tasks[i].name = names[i];
+        task_ptrs[i] = &tasks[i];
+    }
+
+    ExecutionConfig config = {
+        .max_concurrent_tasks = 1,
+        .num_tasks = BENCH_HISTORY_TASKS,
+        .tasks = task_ptrs
+    };
+
+    PrintBenchHeader("RuntimeHistory: load time");
+
+    for (size_t s = 0; s < num_sizes; ++s) {
+        if (!WriteHistoryFile(path, sizes[s], names)) {
+            fprintf(stderr, "history file writing failed\n");
+            break;
+        }
+
+        long long start = GetMonotonicNs();
+        RuntimeHistory* history = NewRuntimeHistory(path, &config);
+        long long elapsed = GetMonotonicNs() - start;
+
+        if (!history) {
+            fprintf(stderr, "history loading failed\n");
+            break;
+        }
+
+        printf("%-40s n=%-9zu %12.2f ms total, %.1f ns/record\n",
+               "load", sizes[s], elapsed / 1e6, (double)elapsed / sizes[s]);
+
+        FreeRuntimeHistory(history);
+    }
+
+    unlink(path);
+    for (int i = 0; i < BENCH_HISTORY_TASKS; ++i) {
+        free(names[i]);
+    }
+}
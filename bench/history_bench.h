@@ -0,0 +1,7 @@
+#pragma once
+
+#include "bench_utils.h"
+#include "../src/history.h"
+
+// Measure loading time of a runtime history file with millions of records.
+void RunHistoryBench(void);
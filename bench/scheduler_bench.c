@@ -0,0 +1,134 @@
+#include "scheduler_bench.h"
+
+// Layered DAG with bounded degree: task i requires i / 2 and i / 3.
+static Graph* NewBenchGraph(size_t num_tasks) {
+    Graph* graph = NewGraph(num_tasks);
+    if (!graph) {
+        return NULL;
+    }
+
+    for (size_t i = 1; i < num_tasks; ++i) {
+        AddDirectedEdge(graph, i, i / 2);
+        if (i / 3 != i / 2) {
+            AddDirectedEdge(graph, i, i / 3);
+        }
+    }
+
+    return graph;
+}
+
+// Run every task to completion in Kahn order, returns number of completions.
+static size_t SimulateRun(DependencyTracker* tracker, Queue* queue) {
+    size_t completed = 0;
+    int task;
+
+    for (size_t i = 0; i < GetTrackedTaskCount(tracker); ++i) {
+        if (IsTaskReady(tracker, i)) {
+            Push(queue, i);
+        }
+    }
+
+    while (!IsEmpty(queue)) {
+        Front(queue, &task);
+        Pop(queue);
+        completed++;
+
+        size_t num_dependents;
+        const int* dependents = GetDependents(tracker, task, &num_dependents);
+
+        for (size_t k = 0; k < num_dependents; ++k) {
+            if (ResolveRequirement(tracker, dependents[k]) == 0) {
+                Push(queue, dependents[k]);
+            }
+        }
+    }
+
+    return completed;
+}
+
+void RunSchedulerBench(void) {
+    const size_t sizes[] = {100, 1000, 10000, 100000};
+    const size_t num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+
+    PrintBenchHeader("DependencyTracker: cost per task completion");
+
+    for (size_t s = 0; s < num_sizes; ++s) {
+        Graph* graph = NewBenchGraph(sizes[s]);
+        if (!graph) {
+            fprintf(stderr, "graph construction failed for n=%zu\n", sizes[s]);
+            return;
+        }
+
+        DependencyTracker* tracker = NewDependencyTracker(graph);
+        Queue* queue = NewQueue();
+        if (!tracker || !queue) {
+            fprintf(stderr, "tracker construction failed for n=%zu\n", sizes[s]);
+            FreeDependencyTracker(tracker);
+            FreeQueue(queue);
+            FreeGraph(graph);
+            return;
+        }
+
+        long long start = GetMonotonicNs();
+        size_t completed = SimulateRun(tracker, queue);
+        long long elapsed = GetMonotonicNs() - start;
+
+        if (completed != sizes[s]) {
+            fprintf(stderr, "only %zu of %zu tasks completed\n", completed, sizes[s]);
+        }
+        PrintBenchResult("completion", sizes[s], (double)elapsed / completed);
+
+        FreeQueue(queue);
+        FreeDependencyTracker(tracker);
+        FreeGraph(graph);
+    }
+}
+
+// Diamond lattice of the given depth and width: every task requires the whole previous layer.
+static Graph* NewLatticeGraph(size_t depth, size_t width) {
+    Graph* graph = NewGraph(depth * width);
+    if (!graph) {
+        return NULL;
+    }
+
+    for (size_t layer = 1; layer < depth; ++layer) {
+        for (size_t k = 0; k < width; ++k) {
+            for (size_t j = 0; j < width; ++j) {
+                AddDirectedEdge(graph, layer * width + k, (layer - 1) * width + j);
+            }
+        }
+    }
+
+    return graph;
+}
+
+void RunFailurePropagationBench(void) {
+    const size_t depths[] = {10, 100, 1000, 10000};
+    const size_t num_depths = sizeof(depths) / sizeof(depths[0]);
+    const size_t width = 2;
+
+    PrintBenchHeader("SkipDependents: failure of the lattice root, cost per task");
+
+    for (size_t d = 0; d < num_depths; ++d) {
+        size_t num_tasks = depths[d] * width;
+        Graph* graph = NewLatticeGraph(depths[d], width);
+        DependencyTracker* tracker = graph ? NewDependencyTracker(graph) : NULL;
+        if (!tracker) {
+            fprintf(stderr, "tracker construction failed for n=%zu\n", num_tasks);
+            FreeGraph(graph);
+            return;
+        }
+
+        long long start = GetMonotonicNs();
+        int num_skipped = SkipDependents(tracker, 0, NULL);
+        long long elapsed = GetMonotonicNs() - start;
+
+        if (num_skipped != (int)(num_tasks - width)) {
+            fprintf(stderr, "skipped %d of %zu tasks\n", num_skipped, num_tasks - width);
+        }
+        PrintBenchResult("skip", num_tasks, (double)elapsed / num_tasks);
+
+        FreeDependencyTracker(tracker);
+        FreeGraph(graph);
+    }
+}
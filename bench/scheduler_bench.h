@@ -0,0 +1,10 @@
+#pragma once
+
+#include "bench_utils.h"
+#include "../src/scheduler.h"
+
+// Measure per-completion cost of the dependency tracker on growing DAGs.
+void RunSchedulerBench(void);
+
+// Measure failure propagation over deep diamond lattices, which have exponentially many paths.
+void RunFailurePropagationBench(void);
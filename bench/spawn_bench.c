@@ -0,0 +1,74 @@
+#include "spawn_bench.h"
+
+#define BENCH_SPAWN_COUNT 200
+
+extern char** environ;
+
+static char* const kTrueArgv[] = {"/bin/true", NULL};
+
+// Old worker path: fork a worker which forks again and execs.
+static void RunDoubleFork(void) {
+    pid_t worker = fork();
+    if (worker == 0) {
+        pid_t child = fork();
+        if (child == 0) {
+            execv(kTrueArgv[0], kTrueArgv);
+            _exit(127);
+        }
+        waitpid(child, NULL, 0);
+        _exit(0);
+    }
+    waitpid(worker, NULL, 0);
+}
+
+static void RunForkExec(void) {
+    pid_t child = fork();
+    if (child == 0) {
+        execv(kTrueArgv[0], kTrueArgv);
+        _exit(127);
+    }
+    waitpid(child, NULL, 0);
+}
+
+static void RunPosixSpawn(void) {
+    pid_t child;
+    if (posix_spawn(&child, kTrueArgv[0], NULL, NULL, kTrueArgv, environ) == 0) {
+        waitpid(child, NULL, 0);
+    }
+}
+
+static double MeasureSpawns(void (*run)(void)) {
+    long long start = GetMonotonicNs();
+    for (int i = 0; i < BENCH_SPAWN_COUNT; ++i) {
+        run();
+    }
+    return (double)(GetMonotonicNs() - start) / BENCH_SPAWN_COUNT;
+}
+
+void RunSpawnBench(void) {
+    const size_t heap_sizes_mb[] = {0, 64, 512};
+    const size_t num_sizes = sizeof(heap_sizes_mb) / sizeof(heap_sizes_mb[0]);
+
+    PrintBenchHeader("Task start: /bin/true per start, by master resident heap in MiB");
+
+    for (size_t s = 0; s < num_sizes; ++s) {
+        size_t size = heap_sizes_mb[s] * 1024 * 1024;
+        char* heap = NULL;
+
+        // Touched pages must be mapped in the page tables fork copies
+        if (size) {
+            heap = malloc(size);
+            if (!heap) {
+                fprintf(stderr, "heap allocation failed for %zu MiB\n", heap_sizes_mb[s]);
+                return;
+            }
+            memset(heap, 1, size);
+        }
+
+        PrintBenchResult("double fork + execv", heap_sizes_mb[s], MeasureSpawns(RunDoubleFork));
+        PrintBenchResult("fork + execv", heap_sizes_mb[s], MeasureSpawns(RunForkExec));
+        PrintBenchResult("posix_spawn", heap_sizes_mb[s], MeasureSpawns(RunPosixSpawn));
+
+        free(heap);
+    }
+}
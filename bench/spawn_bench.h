@@ -0,0 +1,12 @@
+#pragma once
+
+#include <string.h>
+#include <spawn.h>
+#include <sys/wait.h>
+
+#include "bench_utils.h"
+#include "../src/task_process.h"
+
+// Compare double fork, single fork and posix_spawn of a trivial command
+// while the master holds a growing resident heap.
+void RunSpawnBench(void);
@@ -0,0 +1,52 @@
+#include "timer_wheel_bench.h"
+
+void RunTimerWheelBench(void) {
+    const size_t sizes[] = {1000, 10000, 100000, 1000000};
+    const size_t num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+
+    PrintBenchHeader("TimerWheel: deadlines spread over an hour");
+
+    for (size_t s = 0; s < num_sizes; ++s) {
+        size_t n = sizes[s];
+        WheelTimer* timers = malloc(sizeof(WheelTimer) * n);
+        TimerWheel* wheel = NewTimerWheel(0);
+        if (!timers || !wheel) {
+            fprintf(stderr, "wheel construction failed for n=%zu\n", n);
+            free(timers);
+            FreeTimerWheel(wheel);
+            return;
+        }
+
+        srand(1);
+        for (size_t i = 0; i < n; ++i) {
+            InitWheelTimer(&timers[i], NULL);
+        }
+
+        long long start = GetMonotonicNs();
+        for (size_t i = 0; i < n; ++i) {
+            ArmWheelTimer(wheel, &timers[i], 1 + rand() % 3600000);
+        }
+        PrintBenchResult("arm", n, (double)(GetMonotonicNs() - start) / n);
+
+        // Cancel every other timer, as completed tasks do with their timeouts
+        start = GetMonotonicNs();
+        for (size_t i = 0; i < n; i += 2) {
+            CancelWheelTimer(wheel, &timers[i]);
+        }
+        PrintBenchResult("cancel", n / 2, (double)(GetMonotonicNs() - start) / (n / 2));
+
+        // Walk the hour in 10 ms steps, like a busy master would
+        size_t expired = 0;
+        start = GetMonotonicNs();
+        for (uint64_t now = 10; now <= 3600000; now += 10) {
+            AdvanceTimerWheel(wheel, now);
+            while (PopExpiredWheelTimer(wheel)) {
+                expired++;
+            }
+        }
+        PrintBenchResult("advance + expire", expired, (double)(GetMonotonicNs() - start) / expired);
+
+        FreeTimerWheel(wheel);
+        free(timers);
+    }
+}
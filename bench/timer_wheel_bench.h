@@ -0,0 +1,7 @@
+#pragma once
+
+#include "bench_utils.h"
+#include "../src/timer_wheel.h"
+
+// Measure arm, cancel and expiry costs with tens of thousands of armed deadlines.
+void RunTimerWheelBench(void);
@@ -0,0 +1,38 @@
+#include "trace_bench.h"
+
+void RunTraceBench(void) {
+    const size_t sizes[] = {1000, 100000, 1000000};
+    const size_t num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+
+    PrintBenchHeader("TraceRecorder: full task lifecycles");
+
+    for (size_t s = 0; s < num_sizes; ++s) {
+        size_t num_tasks = sizes[s];
+        TraceRecorder* recorder = NewTraceRecorder(num_tasks);
+        if (!recorder) {
+            fprintf(stderr, "trace recorder construction failed for n=%zu\n", num_tasks);
+            return;
+        }
+
+        long long start = GetMonotonicNs();
+        for (size_t i = 0; i < num_tasks; ++i) {
+            RecordTraceEvent(recorder, TRACE_EVENT_QUEUED, i, -1);
+            RecordTraceEvent(recorder, TRACE_EVENT_SPAWN, i, -1);
+            RecordTraceEvent(recorder, TRACE_EVENT_RUNNING, i, -1);
+            RecordTraceEvent(recorder, TRACE_EVENT_EXITED, i, -1);
+            RecordTraceEvent(recorder, TRACE_EVENT_DONE, i, -1);
+            RecordTraceEvent(recorder, TRACE_EVENT_RELEASE, i, i ? i - 1 : -1);
+        }
+        size_t num_events = GetTraceEventCount(recorder);
+        PrintBenchResult("record", num_events, (double)(GetMonotonicNs() - start) / num_events);
+
+        // Disabled tracing is what every untraced run pays
+        start = GetMonotonicNs();
+        for (size_t i = 0; i < num_events; ++i) {
+            RecordTraceEvent(NULL, TRACE_EVENT_QUEUED, i, -1);
+        }
+        PrintBenchResult("record (disabled)", num_events, (double)(GetMonotonicNs() - start) / num_events);
+
+        FreeTraceRecorder(recorder);
+    }
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "bench_utils.h"
+#include "../src/trace.h"
+
+// Measure the cost of recording a trace event, which has to stay well below a microsecond.
+void RunTraceBench(void);
@@ -9,12 +9,17 @@
 #include "src/master.h"
 
 
-const int FLAGS_AMOUNT = 4;
+const int FLAGS_AMOUNT = 9;
 const char* flags[] = {
     "--config", "-c",
     "--log", "-l",
     "--verbosity-type", "-v",
-    "--sleep-duration", "-s"
+    "--sleep-duration", "-s",
+    "--schedule", "-S",
+    "--report", "-r",
+    "--usage", "-u",
+    "--trace", "-t",
+    "--stats", "-L"
 };
 
 typedef struct CmdArgs {
@@ -22,6 +27,11 @@ typedef struct CmdArgs {
     char* log_folder;
     int verbosity_type;
     int sleep_duration;
+    ScheduleType schedule_type;
+    char* report_path;
+    bool show_usage;
+    char* trace_path;
+    bool show_stats;
 } CmdArgs;
 
 static void CheckingSecondArgument(int cur, int argc, char** argv) {
@@ -40,6 +50,18 @@ static void CheckingSecondArgument(int cur, int argc, char** argv) {
     }
 }
 
+static ScheduleType ParseScheduleType(const char* value) {
+    if (strcmp(value, "fifo") == 0) {
+        return SCHEDULE_TYPE_FIFO;
+    } else if (strcmp(value, "critical-path") == 0) {
+        return SCHEDULE_TYPE_CRITICAL_PATH;
+    }
+
+    errno = EINVAL;
+    perror("Unknown schedule type");
+    exit(1);
+}
+
 CmdArgs ParseArgs(int argc, char** argv) {
     CmdArgs args;
     int i = 1;
@@ -48,6 +70,11 @@ CmdArgs ParseArgs(int argc, char** argv) {
     args.log_folder = NULL;
     args.verbosity_type = VERBOSITY_TYPE_TABLE;
     args.sleep_duration = 1;
+    args.schedule_type = SCHEDULE_TYPE_FIFO;
+    args.report_path = NULL;
+    args.show_usage = false;
+    args.trace_path = NULL;
+    args.show_stats = false;
 
     while (i < argc) {
         if (strcmp(argv[i], flags[0]) == 0 || strcmp(argv[i], flags[1]) == 0) {
@@ -85,6 +112,27 @@ CmdArgs ParseArgs(int argc, char** argv) {
                 perror("Wrong sleep duration agrument");
                 exit(1);
             } 
+        } else if (strcmp(argv[i], flags[8]) == 0 || strcmp(argv[i], flags[9]) == 0) {
+            i++;
+            CheckingSecondArgument(i, argc, argv);
+
+            args.schedule_type = ParseScheduleType(argv[i]);
+        } else if (strncmp(argv[i], "--schedule=", strlen("--schedule=")) == 0) {
+            args.schedule_type = ParseScheduleType(argv[i] + strlen("--schedule="));
+        } else if (strcmp(argv[i], flags[10]) == 0 || strcmp(argv[i], flags[11]) == 0) {
+            i++;
+            CheckingSecondArgument(i, argc, argv);
+
+            args.report_path = argv[i];
+        } else if (strcmp(argv[i], flags[12]) == 0 || strcmp(argv[i], flags[13]) == 0) {
+            args.show_usage = true;
+        } else if (strcmp(argv[i], flags[14]) == 0 || strcmp(argv[i], flags[15]) == 0) {
+            i++;
+            CheckingSecondArgument(i, argc, argv);
+
+            args.trace_path = argv[i];
+        } else if (strcmp(argv[i], flags[16]) == 0 || strcmp(argv[i], flags[17]) == 0) {
+            args.show_stats = true;
         }
 
         i++;
@@ -109,6 +157,11 @@ int main(int argc, char** argv) {
     master_args.log_path = args.log_folder;
     master_args.drawer_sleep_duration = args.sleep_duration;
     master_args.verbosity_type = args.verbosity_type;
+    master_args.schedule_type = args.schedule_type;
+    master_args.report_path = args.report_path;
+    master_args.show_usage = args.show_usage;
+    master_args.trace_path = args.trace_path;
+    master_args.show_stats = args.show_stats;
 
     MasterResult res = RunMaster(&master_args);
     fprintf(stderr, "\nMaster aborted with code %d: %s\n", res.status, res.message);
@@ -0,0 +1,109 @@
+#include "arena.h"
+
+#define ARENA_ALIGNMENT _Alignof(max_align_t)
+
+static ArenaBlock* NewArenaBlock(size_t size, ArenaBlock* prev) {
+    ArenaBlock* block = malloc(sizeof(ArenaBlock) + size);
+    if (!block) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    block->prev_ = prev;
+    block->size_ = size;
+    block->used_ = 0;
+    return block;
+}
+
+Arena* NewArena(size_t capacity) {
+    Arena* arena = malloc(sizeof(Arena));
+    if (!arena) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    arena->head_ = NewArenaBlock(capacity > ARENA_MIN_BLOCK_SIZE ? capacity : ARENA_MIN_BLOCK_SIZE, NULL);
+    if (!arena->head_) {
+        free(arena);
+        return NULL;
+    }
+
+    arena->num_blocks_ = 1;
+    arena->num_bytes_ = 0;
+    return arena;
+}
+
+void FreeArena(Arena* arena) {
+    if (!arena) {
+        return;
+    }
+
+    ArenaBlock* block = arena->head_;
+    while (block) {
+        ArenaBlock* prev = block->prev_;
+        free(block);
+        block = prev;
+    }
+
+    free(arena);
+}
+
+// Bump the head block, chaining a bigger one when it can't fit the request
+static void* AllocFromArena(Arena* arena, size_t size, size_t alignment) {
+    if (!arena) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    ArenaBlock* block = arena->head_;
+    size_t offset = (block->used_ + alignment - 1) & ~(alignment - 1);
+
+    if (offset > block->size_ || block->size_ - offset < size) {
+        // Doubling keeps the number of blocks logarithmic in the total size
+        size_t new_size = block->size_ * 2;
+        if (new_size < size) {
+            new_size = size;
+        }
+
+        block = NewArenaBlock(new_size, block);
+        if (!block) {
+            return NULL;
+        }
+
+        arena->head_ = block;
+        arena->num_blocks_++;
+        offset = 0;
+    }
+
+    arena->num_bytes_ += offset + size - block->used_;
+    block->used_ = offset + size;
+    return (char*)block->data_ + offset;
+}
+
+void* ArenaAlloc(Arena* arena, size_t size) {
+    return AllocFromArena(arena, size, ARENA_ALIGNMENT);
+}
+
+char* ArenaStrndup(Arena* arena, const char* str, size_t len) {
+    // Strings need no alignment, they are packed back to back
+    char* copy = AllocFromArena(arena, len + 1, 1);
+    if (!copy) {
+        return NULL;
+    }
+
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+    return copy;
+}
+
+char* ArenaStrdup(Arena* arena, const char* str) {
+    return ArenaStrndup(arena, str, strlen(str));
+}
+
+size_t GetArenaUsedBytes(const Arena* arena) {
+    return arena ? arena->num_bytes_ : 0;
+}
+
+size_t GetArenaBlockCount(const Arena* arena) {
+    return arena ? arena->num_blocks_ : 0;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#define ARENA_MIN_BLOCK_SIZE 4096
+
+typedef struct ArenaBlock ArenaBlock;
+
+typedef struct ArenaBlock {
+    ArenaBlock* prev_;
+    size_t size_;
+    size_t used_;
+    max_align_t data_[];
+} ArenaBlock;
+
+// Bump allocator, everything allocated from it is released at once by FreeArena.
+// Sized right, the whole lifetime fits one block, later blocks are chained when it runs out.
+typedef struct Arena {
+    ArenaBlock* head_;
+    size_t num_blocks_;
+    size_t num_bytes_;  // allocated bytes including alignment padding
+} Arena;
+
+// Create new arena with the first block holding at least capacity bytes.
+// Returns NULL on error.
+Arena* NewArena(size_t capacity);
+
+// Free arena instance and every allocation made from it.
+// Ignores NULL instance.
+void FreeArena(Arena* arena);
+
+// Allocate size bytes aligned for any type.
+// Returns NULL on error.
+void* ArenaAlloc(Arena* arena, size_t size);
+
+// Copy len bytes of str into a new NUL-terminated string.
+// Returns NULL on error.
+char* ArenaStrndup(Arena* arena, const char* str, size_t len);
+
+// Copy NUL-terminated str.
+// Returns NULL on error.
+char* ArenaStrdup(Arena* arena, const char* str);
+
+// Get number of bytes handed out so far.
+size_t GetArenaUsedBytes(const Arena* arena);
+
+// Get number of blocks the arena had to allocate.
+size_t GetArenaBlockCount(const Arena* arena);
@@ -1,89 +1,92 @@
 #include "config.h"
 
+// Fields point into the config buffer, absent ones have NULL data
 typedef struct MainSection {
-    char* max_concurrent_tasks;
-    char* default_timeout;
+    StringView max_concurrent_tasks;
+    StringView default_timeout;
+    StringView cpu_budget;
+    StringView memory_budget_mb;
 } MainSection;
 
 typedef struct TaskSection {
-    char* name;
-    StringVector* requires;
-    char* timeout;
-    char* type;
-    char* sleep_duration;
-    StringVector* exec_command;
+    StringView name;
+    StringView requires;      // space separated task names
+    StringView timeout;
+    StringView timeout_ms;
+    StringView type;
+    StringView sleep_duration;
+    StringView exec_command;  // space separated command tokens
+    StringView cpus;
+    StringView memory_mb;
+
+    int name_id;              // interned name, -1 if the name is missing
+    size_t requires_offset;   // interned requirements are in RawConfig requirement_ids from here
+    size_t num_requires;
+    bool requires_none;       // `none` keyword occured among requirements
 } TaskSection;
 
+// Section the field lines go to
+typedef enum RawConfigSection {
+    RAW_SECTION_NONE,
+    RAW_SECTION_MAIN,
+    RAW_SECTION_TASK,
+} RawConfigSection;
+
 typedef struct RawConfig {
-    MainSection* main;
+    ConfigBuffer buffer;  // text every section field points into
+    bool has_main;
+    MainSection main;
+    RawConfigSection open_section;
 
     size_t num_tasks;
-    TaskSection** tasks;
-} RawConfig;
-
-
-MainSection* NewMainSection(void) {
-    MainSection* main_section = malloc(sizeof(MainSection));
-    if (!main_section) {
-        errno = ENOMEM;
-        return NULL;
-    }
+    size_t tasks_capacity;
+    TaskSection* tasks;
 
-    main_section->default_timeout = NULL;
-    main_section->max_concurrent_tasks = NULL;
-
-    return main_section;
-}
-
-void FreeMainSection(MainSection* main_section) {
-    if (main_section == NULL) {
-        return;
-    }
-    
-    free(main_section->default_timeout);
-    free(main_section->max_concurrent_tasks);
-    free(main_section);
-}
-
-TaskSection* NewTaskSection(void) {
-    TaskSection* task_section = malloc(sizeof(TaskSection));
-    if (!task_section) {
-        errno = ENOMEM;
-        return NULL;
-    }
-
-    task_section->requires = NewStringVector(1);
-    if (!task_section->requires) {
-        free(task_section);
-        return NULL;
-    }
+    NameTable* names;             // task names and requirements, interned as they are parsed
+    IntVector* requirement_ids;   // requirements of all tasks back to back
+    Arena* names_arena;           // copies of interned names when the text is transient, NULL if it outlives the table
+} RawConfig;
 
-    task_section->exec_command = NewStringVector(1);
-    if (!task_section->exec_command) {
-        FreeStringVector(task_section->requires);
-        free(task_section);
-        return NULL;
-    }
+// Known `key:` of a section and where its value goes
+typedef struct SectionField {
+    const char* key;
+    size_t offset;
+    bool is_list;                   // takes one or more values instead of exactly one
+    const char* duplicate_message;  // NULL if a later value overrides an earlier one
+} SectionField;
+
+static const SectionField kMainFields[] = {
+    {"max_concurrent_tasks:", offsetof(MainSection, max_concurrent_tasks), false, NULL},
+    {"default_timeout:", offsetof(MainSection, default_timeout), false, NULL},
+    {"cpu_budget:", offsetof(MainSection, cpu_budget), false, NULL},
+    {"memory_budget_mb:", offsetof(MainSection, memory_budget_mb), false, NULL},
+    {NULL, 0, false, NULL},
+};
+
+static const SectionField kTaskFields[] = {
+    {"name:", offsetof(TaskSection, name), false, "multipule name fields occured"},
+    {"timeout:", offsetof(TaskSection, timeout), false, "multipule timeout fields occured"},
+    {"timeout_ms:", offsetof(TaskSection, timeout_ms), false, "multipule timeout_ms fields occured"},
+    {"type:", offsetof(TaskSection, type), false, "multipule type fields occured"},
+    {"sleep_duration:", offsetof(TaskSection, sleep_duration), false, "multipule sleep duration fields occured"},
+    {"cpus:", offsetof(TaskSection, cpus), false, "multipule cpus fields occured"},
+    {"memory_mb:", offsetof(TaskSection, memory_mb), false, "multipule memory_mb fields occured"},
+    {"requires:", offsetof(TaskSection, requires), true, "multipule requires fields occured"},
+    {"exec_command:", offsetof(TaskSection, exec_command), true, "multipule exec_command fields occured"},
+    {NULL, 0, false, NULL},
+};
 
-    task_section->name = NULL;
-    task_section->sleep_duration = NULL;
-    task_section->timeout = NULL;
-    task_section->type = NULL;
-    return task_section;
-}
 
-void FreeTaskSection(TaskSection* task_section) {
-    if (!task_section) {
+void FreeRawConfig(RawConfig* raw_config) {
+    if (!raw_config) {
         return;
     }
 
-    FreeStringVector(task_section->exec_command);
-    free(task_section->name);
-    free(task_section->sleep_duration);
-    free(task_section->timeout);
-    free(task_section->type);
-    FreeStringVector(task_section->requires);
-    free(task_section);
+    ReleaseConfigBuffer(&raw_config->buffer);
+    FreeNameTable(raw_config->names);
+    FreeIntVector(raw_config->requirement_ids);
+    free(raw_config->tasks);
+    free(raw_config);
 }
 
 RawConfig* NewRawConfig(void) {
@@ -93,49 +96,46 @@ RawConfig* NewRawConfig(void) {
         return NULL;
     }
 
-    raw_config->main = NULL;
+    raw_config->buffer = (ConfigBuffer){0};
+    raw_config->has_main = false;
+    raw_config->main = (MainSection){{0}};
+    raw_config->open_section = RAW_SECTION_NONE;
+    raw_config->names_arena = NULL;
     raw_config->num_tasks = 0;
-    raw_config->tasks = malloc(sizeof(TaskSection*) * MAX_TASKS_COUNT);
-    if (!raw_config->tasks) {
+    raw_config->tasks_capacity = RAW_TASKS_INITIAL_CAPACITY;
+    raw_config->tasks = malloc(sizeof(TaskSection) * raw_config->tasks_capacity);
+    raw_config->names = NewNameTable();
+    raw_config->requirement_ids = NewIntVector(RAW_TASKS_INITIAL_CAPACITY);
+    if (!raw_config->tasks || !raw_config->names || !raw_config->requirement_ids) {
+        FreeRawConfig(raw_config);
         errno = ENOMEM;
-        FreeMainSection(raw_config->main);
-        free(raw_config);
         return NULL;
     }
 
     return raw_config;
 }
 
-void FreeRawConfig(RawConfig* raw_config) {
-    if (!raw_config) {
-        return;
-    }
+// Append an empty task section, growing the list geometrically.
+// Returns NULL on error.
+static TaskSection* AppendTaskSection(RawConfig* raw_config) {
+    if (raw_config->num_tasks == raw_config->tasks_capacity) {
+        size_t new_capacity = raw_config->tasks_capacity * 2;
+        TaskSection* new_tasks = realloc(raw_config->tasks, sizeof(TaskSection) * new_capacity);
+        if (!new_tasks) {
+            errno = ENOMEM;
+            return NULL;
+        }
 
-    if (raw_config) {
-        FreeMainSection(raw_config->main);
+        raw_config->tasks = new_tasks;
+        raw_config->tasks_capacity = new_capacity;
     }
 
-    for (int i = 0; i < raw_config->num_tasks; ++i) {
-        if (raw_config) {
-            FreeTaskSection(raw_config->tasks[i]);
-        }
-    }
-    
-    if (raw_config->tasks) {
-        free(raw_config->tasks);
-    }
-    free(raw_config);
-    
+    TaskSection* task_section = &raw_config->tasks[raw_config->num_tasks++];
+    *task_section = (TaskSection){{0}};
+    return task_section;
 }
 
-void* FailedParsingRawConfig(RawConfig* raw_config, 
-                             StringVector* vec, 
-                             int config_line_number,
-                             char* message,
-                             int errno_code,
-                             TaskSection* task_section,
-                             MainSection* main_section
-                            ) {
+void* FailedParsingRawConfig(RawConfig* raw_config, int config_line_number, char* message, int errno_code) {
     errno = errno_code;
     if (strcmp(message, "") == 0) {
         perror("raw config parsing error");
@@ -147,290 +147,274 @@ void* FailedParsingRawConfig(RawConfig* raw_config,
     if (config_line_number != -1) {
         fprintf(stderr, "In config file in line %d\n", config_line_number);
     }
-    FreeTaskSection(task_section);
-    FreeMainSection(main_section);
     FreeRawConfig(raw_config);
-    FreeStringVector(vec);
     return NULL;
 }
 
-// Parse raw config (main section and task sections).
-// Validates config syntax (`key: value` pairs), key and section names, counts tasks.
-// Returns NULL on error.
-RawConfig* ParseRawConfig(FILE* file) {
-    StringVector* vec;
-    RawConfig* raw_config = NewRawConfig();
-    if (!raw_config) {
-        errno = ENOMEM;
-        return NULL;
+static const SectionField* FindSectionField(const SectionField* fields, StringView key) {
+    for (; fields->key; ++fields) {
+        if (ViewEquals(key, fields->key)) {
+            return fields;
+        }
     }
 
-    char buffer[BUF_SIZE];
-    const char* first_token;
-    bool main_section_occured = false;
-    int vec_length;
-    int status;
-    int line_number = 0;
+    return NULL;
+}
+
+// Store a `key: value` line into the section.
+// Returns false and sets errno on error, message is set for syntax errors.
+static bool ParseSectionField(const SectionField* fields, void* section, const ConfigLine* line, char** message) {
+    const SectionField* field = FindSectionField(fields, line->key);
+    if (!field) {
+        *message = fields == kMainFields ? "config parsing error: unknown main field"
+                                         : "config parsing error: unknown task field";
+        errno = EINVAL;
+        return false;
+    }
 
-    while (fgets(buffer, BUF_SIZE, file)) {
-        vec = SplitString(buffer, " ");
-        if (!vec) {
-            return FailedParsingRawConfig(raw_config, vec, -1, "", errno, NULL, NULL);
+    size_t num_values = CountViewTokens(line->value);
+    if (field->is_list ? num_values == 0 : num_values != 1) {
+        if (fields == kMainFields) {
+            *message = "config parsing error: invalid main field";
+        } else {
+            *message = field->is_list ? "invalid requires or exec_command task field" : "invalid task field";
         }
+        errno = EINVAL;
+        return false;
+    }
+
+    StringView* value = (StringView*)((char*)section + field->offset);
+    if (field->duplicate_message && value->data) {
+        *message = (char*)field->duplicate_message;
+        errno = EINVAL;
+        return false;
+    }
+
+    *value = line->value;
+    return true;
+}
+
+// Intern the name, copying it into the names arena first if the text it points into is transient.
+// Returns -1 and sets errno on error.
+static int InternSectionName(RawConfig* raw_config, StringView name) {
+    if (!raw_config->names_arena) {
+        return InternName(raw_config->names, name);
+    }
+
+    int id = FindInternedName(raw_config->names, name);
+    if (id != -1) {
+        return id;
+    }
 
-        line_number++;
-        vec_length = GetStringVectorLength(vec);
-        if (vec_length != 0) {
-            first_token = GetStringVectorElement(vec, 0);
+    char* copy = ArenaStrndup(raw_config->names_arena, name.data, name.len);
+    if (!copy) {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    return InternName(raw_config->names, (StringView){copy, name.len});
+}
+
+// Intern the name and requirements of a parsed task section.
+// Returns false on error.
+static bool InternTaskSection(RawConfig* raw_config, TaskSection* task_section) {
+    task_section->name_id = -1;
+    if (task_section->name.data) {
+        task_section->name_id = InternSectionName(raw_config, task_section->name);
+        if (task_section->name_id == -1) {
+            return false;
         }
-        
-        // printf("%ld %s\n", GetStringVectorLength(vec), first_token);
+    }
+
+    StringView requires = task_section->requires;
+    StringView requirement;
+
+    task_section->requires_offset = GetIntVectorLength(raw_config->requirement_ids);
+    task_section->num_requires = 0;
+    task_section->requires_none = false;
 
-        if ((vec_length == 0) || (first_token[0] == '#')) {
-            FreeStringVector(vec);
+    while (NextViewToken(&requires, &requirement)) {
+        // `none` is a keyword, not a task name
+        if (ViewEquals(requirement, "none")) {
+            task_section->requires_none = true;
             continue;
+        }
 
-        } else if (strcmp(first_token, "[main]") == 0) {
-            if (vec_length != 1 || main_section_occured) {
-                return FailedParsingRawConfig(raw_config, vec, line_number, 
-                                              "config parsing error: invalid main section header (or duplicate)", 
-                                              EINVAL, NULL, NULL);
-            }
+        int id = InternSectionName(raw_config, requirement);
+        if (id == -1 || !AppendToIntVector(raw_config->requirement_ids, id)) {
+            return false;
+        }
+        task_section->num_requires++;
+    }
 
-            main_section_occured = true;
+    return true;
+}
 
-            // Getting ready for main section parsing
-            FreeStringVector(vec);
-            MainSection* main_section = NewMainSection();
-            if (!main_section) {
-                return FailedParsingRawConfig(raw_config, vec, -1, "config parsing error", errno, NULL, NULL);
-            }
+// Close the open section, a task section gets its names interned.
+// Sets closed_task if it was a task section, which is the last one of the list.
+// Returns false and sets errno on error.
+static bool CloseRawConfigSection(RawConfig* raw_config, bool* closed_task) {
+    *closed_task = raw_config->open_section == RAW_SECTION_TASK;
+    raw_config->open_section = RAW_SECTION_NONE;
 
-            // Parsing
-            while (fgets(buffer, BUF_SIZE, file)) {
-                vec = SplitString(buffer, " ");
-                if (!vec) {
-                    return FailedParsingRawConfig(raw_config, vec, -1, "config parsing error", errno, NULL, NULL);
-                }
-
-                line_number++;
-                vec_length = GetStringVectorLength(vec);
-                if (vec_length != 0) {
-                    first_token = GetStringVectorElement(vec, 0);
-                }
-                
-                if (vec_length == 0) {
-                    FreeStringVector(vec);
-                    break;
-
-                } else if (first_token[0] == '#') {
-                    FreeStringVector(vec);
-                    continue;
-                    
-                } else if (strcmp(first_token, "max_concurrent_tasks:") == 0 ||
-                           strcmp(first_token, "default_timeout:") == 0
-                        ) {
-                    
-                    if (vec_length != 2) {
-                        return FailedParsingRawConfig(raw_config, vec, line_number, 
-                                                      "config parsing error: invalid main field", EINVAL, NULL, main_section);
-                    }
-
-                    char* tmp_string_ptr;
-
-                    if (strcmp(first_token, "max_concurrent_tasks:") == 0) {
-                        main_section->max_concurrent_tasks = strdup(GetStringVectorElement(vec, 1));
-                        tmp_string_ptr = main_section->max_concurrent_tasks;
-                    } else if (strcmp(first_token, "default_timeout:") == 0) {
-                        main_section->default_timeout = strdup(GetStringVectorElement(vec, 1));
-                        tmp_string_ptr = main_section->default_timeout;
-                    }
-                    
-                    if (!tmp_string_ptr) {
-                        return FailedParsingRawConfig(raw_config, vec, -1, "config parsing error", ENOMEM, NULL, main_section);
-                    }
-
-                    tmp_string_ptr = NULL;
-
-                } else {
-                    return FailedParsingRawConfig(raw_config, vec, line_number,
-                                                  "config parsing error: unknown main field", EINVAL, NULL, main_section);
-                }
-
-                FreeStringVector(vec);
-            }
+    if (*closed_task) {
+        return InternTaskSection(raw_config, &raw_config->tasks[raw_config->num_tasks - 1]);
+    }
+
+    return true;
+}
 
-            raw_config->main = main_section;
+// Feed one line: a header opens a section, a blank line closes it, any other line is a field of the open one.
+// Sets closed_task if the line closed a task section.
+// Returns false and sets errno on error, message is set for syntax errors.
+static bool ParseRawConfigLine(RawConfig* raw_config, const ConfigLine* line, bool* closed_task, char** message) {
+    *closed_task = false;
 
-        } else if (strcmp(first_token, "[task]") == 0) {
-            if (vec_length != 1) {
-                return FailedParsingRawConfig(raw_config, vec, line_number, 
-                                              "invalid task section header", EINVAL, NULL, NULL);
-            }
+    if (line->first.len == 0) {
+        if (!CloseRawConfigSection(raw_config, closed_task)) {
+            *message = "config parsing error";
+            return false;
+        }
+        return true;
+    } else if (line->first.data[0] == '#') {
+        return true;
+    }
 
-            // Getting ready for task section parsing
-            FreeStringVector(vec);
-            TaskSection* task_section = NewTaskSection();
-            if (!task_section) {
-                return FailedParsingRawConfig(raw_config, vec, -1, "", errno, NULL, NULL);
-            }
+    if (raw_config->open_section == RAW_SECTION_MAIN) {
+        return ParseSectionField(kMainFields, &raw_config->main, line, message);
+    } else if (raw_config->open_section == RAW_SECTION_TASK) {
+        return ParseSectionField(kTaskFields, &raw_config->tasks[raw_config->num_tasks - 1], line, message);
+    }
 
-            // Parsing
-            while (fgets(buffer, BUF_SIZE, file)) {
-                vec = SplitString(buffer, " ");
-                if (!vec) {
-                    return FailedParsingRawConfig(raw_config, vec, -1, "", errno, NULL, NULL);
-                }
-
-                line_number++;
-                vec_length = GetStringVectorLength(vec);
-                if (vec_length != 0) {
-                    first_token = GetStringVectorElement(vec, 0);
-                }
-
-                if (vec_length == 0) {
-                    FreeStringVector(vec);
-                    break;
-                } else if (first_token[0] == '#') {
-                    FreeStringVector(vec);
-                    continue;
-                    
-                } else if (strcmp(first_token, "name:") == 0 || 
-                           strcmp(first_token, "timeout:") == 0 ||
-                           strcmp(first_token, "type:") == 0 ||
-                           strcmp(first_token, "sleep_duration:") == 0
-                        ) {
-                    
-                    if (vec_length != 2) {
-                        return FailedParsingRawConfig(raw_config, vec, line_number,
-                                                      "invalid task field", EINVAL, task_section, NULL);
-                    }
-
-                    char* tmp_string_ptr;
-
-                    if (strcmp(first_token, "name:") == 0) {
-                        if (task_section->name) {
-                            return FailedParsingRawConfig(raw_config, vec, line_number,
-                                                      "multipule name fields occured", EINVAL, task_section, NULL);
-                        }
-
-                        task_section->name = strdup(GetStringVectorElement(vec, 1));
-                        tmp_string_ptr = task_section->name;
-                    } else if (strcmp(first_token, "timeout:") == 0) {
-                        if (task_section->timeout) {
-                            return FailedParsingRawConfig(raw_config, vec, line_number,
-                                                      "multipule timeout fields occured", EINVAL, task_section, NULL);
-                        }
-
-                        task_section->timeout = strdup(GetStringVectorElement(vec, 1));
-                        tmp_string_ptr = task_section->timeout;
-                    } else if (strcmp(first_token, "type:") == 0) {
-                        if (task_section->type) {
-                            return FailedParsingRawConfig(raw_config, vec, line_number,
-                                                      "multipule type fields occured", EINVAL, task_section, NULL);
-                        }
-
-                        task_section->type = strdup(GetStringVectorElement(vec, 1));
-                        tmp_string_ptr = task_section->type;
-                    } else if (strcmp(first_token, "sleep_duration:") == 0) {
-                        if (task_section->sleep_duration) {
-                            return FailedParsingRawConfig(raw_config, vec, line_number,
-                                                      "multipule sleep duration fields occured", EINVAL, task_section, NULL);
-                        }
-
-                        task_section->sleep_duration = strdup(GetStringVectorElement(vec, 1));
-                        tmp_string_ptr = task_section->sleep_duration;
-                    }
-
-                    if (!tmp_string_ptr) {
-                        return FailedParsingRawConfig(raw_config, vec, -1, "", ENOMEM, task_section, NULL);
-                    }
-
-                    tmp_string_ptr = NULL;
-
-                } else if (strcmp(first_token, "requires:") == 0 ||
-                           strcmp(first_token, "exec_command:") == 0
-                        ) {
-                    
-                    if (vec_length == 1) {
-                        return FailedParsingRawConfig(raw_config, vec, line_number, 
-                                                      "invalid requires or exec_command task field", EINVAL, task_section, NULL);
-                    }
-
-                    StringVector* tmp_string_vector_ptr;
-                    if (strcmp(first_token, "requires:") == 0) {
-                        if (GetStringVectorLength(task_section->requires) != 0) {
-                            return FailedParsingRawConfig(raw_config, vec, line_number,
-                                                      "multipule requires fields occured", EINVAL, task_section, NULL);
-                        }
-
-                        tmp_string_vector_ptr = task_section->requires;
-                    } else if (strcmp(first_token, "exec_command:") == 0) {
-                        if (GetStringVectorLength(task_section->exec_command) != 0) {
-                            return FailedParsingRawConfig(raw_config, vec, line_number,
-                                                      "multipule exec_command fields occured", EINVAL, task_section, NULL);
-                        }
-
-                        tmp_string_vector_ptr = task_section->exec_command;
-                    }
-
-                    for (int k = 1; k < vec_length; ++k) {
-                        status = AppendToStringVector(tmp_string_vector_ptr, GetStringVectorElement(vec, k));
-                        if (!status) {
-                            return FailedParsingRawConfig(raw_config, vec, -1, "config parsing error", errno, task_section, NULL);
-                        }
-                    }
-
-                    tmp_string_vector_ptr = NULL;
-
-                } else {
-                    return FailedParsingRawConfig(raw_config, vec, line_number, 
-                                                  "config parsing error: unknown task field", EINVAL, task_section, NULL);
-                };
-
-                FreeStringVector(vec);
-            }
+    if (ViewEquals(line->first, "[main]")) {
+        if (CountViewTokens(line->value) != 0 || raw_config->has_main) {
+            *message = "config parsing error: invalid main section header (or duplicate)";
+            errno = EINVAL;
+            return false;
+        }
 
-            raw_config->tasks[raw_config->num_tasks] = task_section;
-            raw_config->num_tasks++;
+        raw_config->has_main = true;
+        raw_config->open_section = RAW_SECTION_MAIN;
+    } else if (ViewEquals(line->first, "[task]")) {
+        if (CountViewTokens(line->value) != 0) {
+            *message = "invalid task section header";
+            errno = EINVAL;
+            return false;
+        }
 
-        } else {
-            return FailedParsingRawConfig(raw_config, vec, line_number, 
-                                          "config parsing error: unknown record", EINVAL, NULL, NULL);
+        if (!AppendTaskSection(raw_config)) {
+            *message = "config parsing error";
+            return false;
+        }
+        raw_config->open_section = RAW_SECTION_TASK;
+    } else {
+        *message = "config parsing error: unknown record";
+        errno = EINVAL;
+        return false;
+    }
+
+    return true;
+}
+
+// Parse raw config (main section and task sections).
+// Validates config syntax (`key: value` pairs), key and section names, counts tasks.
+// The text is tokenized in place and taken over, sections keep views into it.
+// Returns NULL on error.
+RawConfig* ParseRawConfig(ConfigBuffer* buffer) {
+    RawConfig* raw_config = NewRawConfig();
+    if (!raw_config) {
+        ReleaseConfigBuffer(buffer);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    raw_config->buffer = *buffer;
+    *buffer = (ConfigBuffer){0};
+
+    ConfigLineReader reader;
+    ConfigLine line;
+    char* message = "";
+    bool closed_task;
+
+    InitConfigLineReader(&reader, &raw_config->buffer);
+    while (NextConfigLine(&reader, &line)) {
+        if (!ParseRawConfigLine(raw_config, &line, &closed_task, &message)) {
+            return FailedParsingRawConfig(raw_config, GetConfigLineNumber(&reader), message, errno);
         }
     }
 
+    // The last section ends with the text
+    if (!CloseRawConfigSection(raw_config, &closed_task)) {
+        return FailedParsingRawConfig(raw_config, -1, "config parsing error", errno);
+    }
+
     return raw_config;
 }
 
-void FreeTaskConfig(TaskConfig* config) {
-    if (!config) {
-        return;
+// Copy space separated tokens of the view into a string, one space between each.
+// Returns NULL on error.
+static char* JoinViewTokens(Arena* arena, StringView view) {
+    char* str = ArenaStrndup(arena, view.data, view.len);
+    if (!str) {
+        return NULL;
     }
-    
-    free(config->name);
-    FreeStringVector(config->requirements);
-    free(config->log_path);
-
-    if (config->type == TASK_TYPE_SLEEP) {
-        if (config->sleep_args) {
-            free(config->sleep_args);
-        }  
-    } else if (config->type == TASK_TYPE_EXEC) {
-        
-        if (config->exec_args) {
-            if (config->exec_args->argv) {
-                FreeStringVector(config->exec_args->argv);
-            }
 
-            free(config->exec_args);
+    StringView token;
+    size_t len = 0;
+    while (NextViewToken(&view, &token)) {
+        if (len) {
+            str[len++] = ' ';
         }
+        memcpy(str + len, token.data, token.len);
+        len += token.len;
     }
 
-    free(config);
+    str[len] = '\0';
+    return str;
 }
 
-void* FailedTaskConfigCreation(TaskConfig* config, const char* message, int error_code) {
+// Build `{log_prefix}{task_name}.log`, squashing a leading dot or slash of the name like JoinPath.
+// Returns NULL on error.
+static char* NewLogPath(Arena* arena, const char* log_prefix, const char* name) {
+    if (name[0] == '/' || name[0] == '.') {
+        name++;
+    }
+
+    size_t prefix_len = strlen(log_prefix);
+    size_t name_len = strlen(name);
+    char* path = ArenaAlloc(arena, prefix_len + name_len + sizeof(".log"));
+    if (!path) {
+        return NULL;
+    }
+
+    memcpy(path, log_prefix, prefix_len);
+    memcpy(path + prefix_len, name, name_len);
+    memcpy(path + prefix_len + name_len, ".log", sizeof(".log"));
+    return path;
+}
+
+ExecTaskArgs* NewExecTaskArgs(Arena* arena, char* command) {
+    ExecTaskArgs* exec_args = ArenaAlloc(arena, sizeof(ExecTaskArgs));
+    char** argv = ArenaAlloc(arena, sizeof(char*) * 4);
+    if (!exec_args || !argv) {
+        return NULL;
+    }
+
+    size_t argc = 0;
+    argv[argc++] = PATH_TO_EXECUTABLE;
+    if (strcmp(PATH_TO_EXECUTABLE, "/bin/bash") == 0) {
+        argv[argc++] = "-c";
+    }
+    argv[argc++] = command;
+    argv[argc] = NULL;
+
+    exec_args->binary_path = PATH_TO_EXECUTABLE;
+    exec_args->argv = argv;
+    exec_args->command = command;
+    return exec_args;
+}
+
+void* FailedTaskConfigCreation(const char* message, int error_code) {
     errno = error_code;
     if (strcmp(message, "") == 0) {
         perror("task config creation failed");
@@ -439,188 +423,159 @@ void* FailedTaskConfigCreation(TaskConfig* config, const char* message, int erro
         perror(message);
     }
 
-    FreeTaskConfig(config);
     return NULL;
 }
 
-TaskConfig* NewTaskConfig(TaskSection* task_section, int general_timeout, const char* log_directory) {
-    TaskConfig* config = malloc(sizeof(TaskConfig));
-    config->name = NULL;
-    config->log_path = NULL;
-    config->sleep_args = NULL;
-    config->exec_args = NULL;
-    config->requirements = NULL;
-    config->type = 0;
+// Materialize the task section into the arena, nothing has to be freed on error.
+// Dependencies are left as interned name IDs, ResolveTaskDependencies turns them into task indices.
+// Returns NULL on error.
+TaskConfig* NewTaskConfig(
+    Arena* arena,
+    const RawConfig* raw_config,
+    const TaskSection* task_section,
+    int general_timeout,
+    const char* log_prefix)
+{
+    TaskConfig* config = ArenaAlloc(arena, sizeof(TaskConfig));
     if (!config) {
-        return FailedTaskConfigCreation(config, "memory error", ENOMEM);
+        return FailedTaskConfigCreation("memory error", ENOMEM);
     }
 
     // REQUIRED FIELDS: name, type: SLEEP --> sleep_duration, EXEC --> exec_command
 
     // Name
-    if (!task_section->name) {
-        return FailedTaskConfigCreation(config, "task name missing", EINVAL);
+    if (!task_section->name.data) {
+        return FailedTaskConfigCreation("task name missing", EINVAL);
     }
 
-    config->name = strdup(task_section->name);
+    config->name = ArenaStrndup(arena, task_section->name.data, task_section->name.len);
     if (!config->name) {
-        return FailedTaskConfigCreation(config, "memory error", ENOMEM);
+        return FailedTaskConfigCreation("memory error", ENOMEM);
     }
 
     // Task type
-    if (task_section->type) {
-        if (strcmp(task_section->type, "SLEEP") == 0) {
-            config->type = TASK_TYPE_SLEEP;
-
-            config->sleep_args = malloc(sizeof(SleepTaskArgs));
-            if (!config->sleep_args) {
-                return FailedTaskConfigCreation(config, "memory error", ENOMEM);
-            }
-
-            config->sleep_args->duration = MyAtoi(task_section->sleep_duration);
-            if (config->sleep_args->duration == -1) {
-                return FailedTaskConfigCreation(config, "invalid or missing sleep duration argument", EINVAL);
-            }
-        } else if (strcmp(task_section->type, "EXEC") == 0){
-            int status;
-
-            size_t argv_len = GetStringVectorLength(task_section->exec_command);
-            if (argv_len == 0) {
-                return FailedTaskConfigCreation(config, "invalid or missing exec arguments", EINVAL);
-            }
-
-            config->type = TASK_TYPE_EXEC;
-
-            config->exec_args = malloc(sizeof(ExecTaskArgs));
-            if (!config->exec_args) {
-                return FailedTaskConfigCreation(config, "memory error", ENOMEM);
-            }
-
-            config->exec_args->binary_path = PATH_TO_EXECUTABLE;
-            
-            config->exec_args->argv = NewStringVector(argv_len);
-            if (!config->exec_args->argv) {
-                return FailedTaskConfigCreation(config, "memory error", EINVAL);
-            }
-
-            status = AppendToStringVector(config->exec_args->argv, PATH_TO_EXECUTABLE);
-            if (!status) {
-                return FailedTaskConfigCreation(config, "memory error", errno);
-            }
-            
-            if (strcmp(PATH_TO_EXECUTABLE, "/bin/bash") == 0) {
-                status = AppendToStringVector(config->exec_args->argv, "-c");
-                if (!status) {
-                    return FailedTaskConfigCreation(config, "memory error", errno);
-                }
-            }
-
-            const char* buf_ptr;
-            StringVector* buffer_for_gluing = NewStringVector(GetStringVectorLength(task_section->exec_command));
-            if (!buffer_for_gluing) {
-                return FailedTaskConfigCreation(config, "memory error", EINVAL);
-            }
-
-            for (int i = 0; i < argv_len; ++i) {
-                buf_ptr = GetStringVectorElement(task_section->exec_command, i);
-
-                status = AppendToStringVector(buffer_for_gluing, buf_ptr);
-                if (!status) {
-                    FreeStringVector(buffer_for_gluing);
-                    return FailedTaskConfigCreation(config, "memory error", EINVAL);
-                }
-            }
-
-            char* buf_ptr2 = GlueStringVectorWithDelimeter(buffer_for_gluing, " ");
-            if (!buf_ptr2) {
-                FreeStringVector(buffer_for_gluing);
-                return FailedTaskConfigCreation(config, "memory error", EINVAL);
-            }
+    if (!task_section->type.data) {
+        return FailedTaskConfigCreation("missing task type", EINVAL);
+    } else if (ViewEquals(task_section->type, "SLEEP")) {
+        config->type = TASK_TYPE_SLEEP;
+
+        config->sleep_args = ArenaAlloc(arena, sizeof(SleepTaskArgs));
+        if (!config->sleep_args) {
+            return FailedTaskConfigCreation("memory error", ENOMEM);
+        }
 
-            AppendToStringVector(config->exec_args->argv, buf_ptr2);
+        // Slept in milliseconds, the duration has to stay in range once multiplied
+        config->sleep_args->duration = ViewToUnsigned(task_section->sleep_duration);
+        if (config->sleep_args->duration == -1 || config->sleep_args->duration > UINT_MAX / 1000) {
+            return FailedTaskConfigCreation("invalid or missing sleep duration argument", EINVAL);
+        }
+    } else if (ViewEquals(task_section->type, "EXEC")) {
+        if (!task_section->exec_command.data) {
+            return FailedTaskConfigCreation("invalid or missing exec arguments", EINVAL);
+        }
 
-            FreeStringVector(buffer_for_gluing);
-            free(buf_ptr2);
+        config->type = TASK_TYPE_EXEC;
 
-            // Appending NULL for execv command 
-            status = AppendToStringVector(config->exec_args->argv, NULL);
-            if (!status) {
-                return FailedTaskConfigCreation(config, "memory error", EINVAL);
-            }
-        } else {
-            return FailedTaskConfigCreation(config, "unknown task type", EINVAL);
+        // Command tokens are glued back with single spaces
+        char* command = JoinViewTokens(arena, task_section->exec_command);
+        config->exec_args = command ? NewExecTaskArgs(arena, command) : NULL;
+        if (!config->exec_args) {
+            return FailedTaskConfigCreation("memory error", ENOMEM);
         }
     } else {
-        return FailedTaskConfigCreation(config, "missing task type", EINVAL);
+        return FailedTaskConfigCreation("unknown task type", EINVAL);
     }
 
-    // Requirements
-    size_t rec_len = GetStringVectorLength(task_section->requires);
-    int status;
-
-    config->requirements = NewStringVector(rec_len);
-    if (!config->requirements) {
-        return FailedTaskConfigCreation(config, "memory error", errno);
+    // Requirements, `none` is only allowed alone
+    if (task_section->requires_none && task_section->num_requires > 0) {
+        return FailedTaskConfigCreation("none occured in task requirements", EINVAL);
     }
 
-    const char* buf_ptr;
+    config->num_dependencies = task_section->num_requires;
+    config->dependencies = ArenaAlloc(arena, sizeof(int) * config->num_dependencies);
+    if (!config->dependencies) {
+        return FailedTaskConfigCreation("memory error", ENOMEM);
+    }
 
-    for (int i = 0; i < rec_len; ++i) {
-        buf_ptr = GetStringVectorElement(task_section->requires, i);
-        status = AppendToStringVector(config->requirements, buf_ptr);
-        if (!status) {
-            return FailedTaskConfigCreation(config, "memory error", errno);
-        }
+    for (size_t i = 0; i < config->num_dependencies; ++i) {
+        config->dependencies[i] = GetIntVectorElement(raw_config->requirement_ids, task_section->requires_offset + i);
     }
 
-    // Timeout
-    if (task_section->timeout) {
-        config->timeout = MyAtoi(task_section->timeout);
-        if (config->timeout == -1) {
-            return FailedTaskConfigCreation(config, "invalid task timeout argument", EINVAL);
+    // Timeout, either in seconds or in milliseconds
+    unsigned int general_timeout_ms = general_timeout * 1000;
+    bool has_timeout = task_section->timeout.data;
+
+    if (has_timeout && task_section->timeout_ms.data) {
+        return FailedTaskConfigCreation("both timeout and timeout_ms task fields occured", EINVAL);
+    } else if (has_timeout || task_section->timeout_ms.data) {
+        unsigned int timeout = ViewToUnsigned(has_timeout ? task_section->timeout : task_section->timeout_ms);
+        if (timeout == -1 || (has_timeout && timeout > UINT_MAX / 1000)) {
+            return FailedTaskConfigCreation("invalid task timeout argument", EINVAL);
         }
 
-        if (config->timeout > general_timeout || config->timeout == 0) {
-            config->timeout = general_timeout;
+        config->timeout_ms = has_timeout ? timeout * 1000 : timeout;
+        if (config->timeout_ms > general_timeout_ms || config->timeout_ms == 0) {
+            config->timeout_ms = general_timeout_ms;
         }
     } else {
-        config->timeout = general_timeout;
+        config->timeout_ms = general_timeout_ms;
     }
-    
-    // Log path
-    char* log_file_name = malloc(sizeof(char) * (strlen(config->name) + 4 + 1));
-    if (!log_file_name) {
-        return FailedTaskConfigCreation(config, "memory error", errno);
+
+    // Declared resources, undeclared ones are not accounted
+    config->cpus = 0;
+    if (task_section->cpus.data) {
+        config->cpus = ViewToUnsigned(task_section->cpus);
+        if (config->cpus == -1) {
+            return FailedTaskConfigCreation("invalid task cpus argument", EINVAL);
+        }
     }
 
-    log_file_name[0] = '\0';
-    strcat(log_file_name, config->name);
-    strcat(log_file_name, ".log");
+    config->memory_mb = 0;
+    if (task_section->memory_mb.data) {
+        config->memory_mb = ViewToUnsigned(task_section->memory_mb);
+        if (config->memory_mb == -1) {
+            return FailedTaskConfigCreation("invalid task memory_mb argument", EINVAL);
+        }
+    }
 
-    config->log_path = JoinPath(log_directory, log_file_name);
+    // Log path
+    config->log_path = NewLogPath(arena, log_prefix, config->name);
     if (!config->log_path) {
-        return FailedTaskConfigCreation(config, "invalid log path argument", errno);
+        return FailedTaskConfigCreation("memory error", ENOMEM);
     }
 
-    free(log_file_name);
-
     return config;
 }
 
+// Replace requirement name IDs of the task with task indices.
+// task_by_name maps interned names to task indices, -1 for names no task has.
+// Returns false on error.
+static bool ResolveTaskDependencies(TaskConfig* config, const int* task_by_name) {
+    for (size_t i = 0; i < config->num_dependencies; ++i) {
+        config->dependencies[i] = task_by_name[config->dependencies[i]];
+        if (config->dependencies[i] == -1) {
+            FailedTaskConfigCreation("invalid task requirements", EINVAL);
+            return false;
+        }
+    }
+
+    return true;
+}
+
 void FreeExecutionConfig(ExecutionConfig* config) {
     if (!config) {
         return;
     }
-   
-    for (int i = 0; i < config->num_tasks; ++i) {
-        FreeTaskConfig(config->tasks[i]);
-    } 
 
-    free(config->tasks);
-    free(config);
+    if (config->cache_map_) {
+        munmap(config->cache_map_, config->cache_map_size_);
+    }
+
+    // The config itself lives in its arena
+    FreeArena(config->arena_);
 }
 
-void* ExecutionConfigCreationFailed(ExecutionConfig* config, char* message, int error_code) {
+void* ExecutionConfigCreationFailed(Arena* arena, char* message, int error_code) {
     errno = error_code;
     if (strcmp(message, "") == 0) {
         perror("execution config creation failed");
@@ -628,65 +583,153 @@ void* ExecutionConfigCreationFailed(ExecutionConfig* config, char* message, int
         fprintf(stderr, "execution config creation failed: ");
         perror(message);
     }
-    FreeExecutionConfig(config);   
+    FreeArena(arena);
     return NULL;
 }
 
+// Set concurrency, budgets and the general timeout from the main section, defaults if it is NULL.
+// Returns false and sets message on an invalid value.
+static bool ApplyMainSection(
+    ExecutionConfig* exec_config,
+    const MainSection* main_section,
+    int* general_timeout,
+    char** message)
+{
+    int max_concurrent_tasks = DEFAULT_MAX_CUNCURRENT_TASKS;
+    *general_timeout = DEFAULT_TIMEOUT;
+    exec_config->adaptive_concurrency = false;
+
+    if (main_section) {
+        if (ViewEquals(main_section->max_concurrent_tasks, ADAPTIVE_CONCURRENCY_VALUE)) {
+            exec_config->adaptive_concurrency = true;
+        } else if (main_section->max_concurrent_tasks.data) {
+            max_concurrent_tasks = ViewToUnsigned(main_section->max_concurrent_tasks);
+            if (max_concurrent_tasks == -1) {
+                *message = "invalid argument for max concurrent tasks";
+                return false;
+            }
+        } else {
+            max_concurrent_tasks = DEFAULT_MAX_CUNCURRENT_TASKS;
+        }
+
+        if (main_section->default_timeout.data) {
+            // Applied in milliseconds, same bound as the task timeout field
+            unsigned int timeout = ViewToUnsigned(main_section->default_timeout);
+            if (timeout == -1 || timeout > UINT_MAX / 1000) {
+                *message = "invalid argument for general timeout";
+                return false;
+            }
+            *general_timeout = timeout;
+        } else {
+            *general_timeout = DEFAULT_TIMEOUT;
+        }
+    }
+
+    exec_config->max_concurrent_tasks = max_concurrent_tasks;
+
+    // Resource budget, defaults to the whole machine
+    long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    long long memory_mb = (long long)sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGESIZE) / (1024 * 1024);
+    exec_config->cpu_budget = num_cpus > 0 ? num_cpus : 1;
+    exec_config->memory_budget_mb = memory_mb > 0 ? memory_mb : 0;
+
+    if (main_section && main_section->cpu_budget.data) {
+        exec_config->cpu_budget = ViewToUnsigned(main_section->cpu_budget);
+        if (exec_config->cpu_budget == -1 || exec_config->cpu_budget == 0) {
+            *message = "invalid argument for cpu budget";
+            return false;
+        }
+    }
+
+    if (main_section && main_section->memory_budget_mb.data) {
+        exec_config->memory_budget_mb = ViewToUnsigned(main_section->memory_budget_mb);
+        if (exec_config->memory_budget_mb == -1 || exec_config->memory_budget_mb == 0) {
+            *message = "invalid argument for memory budget";
+            return false;
+        }
+    }
+
+    // Adaptive window moves between one task and a multiple of the CPU budget
+    if (exec_config->adaptive_concurrency) {
+        exec_config->max_concurrent_tasks = exec_config->cpu_budget * ADAPTIVE_CONCURRENCY_FACTOR;
+    }
+
+    return true;
+}
+
+// Log paths share the directory part, `{log_directory}/`.
+// Returns NULL on error.
+static char* NewLogPrefix(Arena* arena, const char* log_directory) {
+    char* joined_prefix = JoinPath(log_directory, "");
+    char* log_prefix = joined_prefix ? ArenaStrdup(arena, joined_prefix) : NULL;
+    free(joined_prefix);
+    return log_prefix;
+}
+
 ExecutionConfig* NewExecutionConfig(RawConfig* raw_config, const char* log_directory) {
-    ExecutionConfig* exec_config = malloc(sizeof(ExecutionConfig));
-    if (!exec_config) {
+    size_t num_tasks = raw_config->num_tasks;
+
+    // Every field is a piece of the text plus fixed per task parts, so this is enough for one block
+    Arena* arena = NewArena(sizeof(ExecutionConfig) + raw_config->buffer.size +
+                            num_tasks * (sizeof(TaskConfig*) + sizeof(TaskConfig) + sizeof(ExecTaskArgs) +
+                                         sizeof(char*) * 4 + strlen(log_directory) + 2 * _Alignof(max_align_t)));
+    if (!arena) {
         errno = ENOMEM;
         return NULL;
     }
 
-    size_t num_tasks = raw_config->num_tasks;
-    exec_config->num_tasks = num_tasks;
+    ExecutionConfig* exec_config = ArenaAlloc(arena, sizeof(ExecutionConfig));
+    if (!exec_config) {
+        return ExecutionConfigCreationFailed(arena, "memory error", ENOMEM);
+    }
 
-    exec_config->tasks = malloc(sizeof(TaskConfig*) * num_tasks);
+    exec_config->arena_ = arena;
+    exec_config->cache_map_ = NULL;
+    exec_config->num_tasks = num_tasks;
+    exec_config->tasks = ArenaAlloc(arena, sizeof(TaskConfig*) * num_tasks);
     if (!exec_config->tasks) {
-        free(exec_config);
-        errno = ENOMEM;
-        return NULL;
+        return ExecutionConfigCreationFailed(arena, "memory error", ENOMEM);
     }
 
-    for (int i = 0; i < num_tasks; ++i) {
-        exec_config->tasks[i] = NULL;
+    int general_timeout;
+    char* message;
+    if (!ApplyMainSection(exec_config, raw_config->has_main ? &raw_config->main : NULL, &general_timeout, &message)) {
+        return ExecutionConfigCreationFailed(arena, message, EINVAL);
     }
 
-    int general_timeout = DEFAULT_TIMEOUT;
-    int max_concurrent_tasks = DEFAULT_MAX_CUNCURRENT_TASKS;
+    char* log_prefix = NewLogPrefix(arena, log_directory);
+    if (!log_prefix) {
+        return ExecutionConfigCreationFailed(arena, "invalid log path argument", errno);
+    }
 
-    // Main section
-    if (raw_config->main) {
-        if (raw_config->main->max_concurrent_tasks) {
-            max_concurrent_tasks = MyAtoi(raw_config->main->max_concurrent_tasks);
-            if (max_concurrent_tasks == -1) {
-                return ExecutionConfigCreationFailed(exec_config, "invalid argument for max concurrent tasks", EINVAL);
-            }
-        } else {
-            max_concurrent_tasks = DEFAULT_MAX_CUNCURRENT_TASKS;
+    // Interned names resolve to task indices, so requirements are just looked up
+    size_t num_names = GetInternedNameCount(raw_config->names);
+    int* task_by_name = ArenaAlloc(arena, sizeof(int) * num_names);
+    if (!task_by_name) {
+        return ExecutionConfigCreationFailed(arena, "memory error", ENOMEM);
+    }
+
+    for (size_t i = 0; i < num_names; ++i) {
+        task_by_name[i] = -1;
+    }
+
+    for (int i = 0; i < num_tasks; ++i) {
+        int name_id = raw_config->tasks[i].name_id;
+        if (name_id == -1) {
+            continue;
         }
 
-        if (raw_config->main->default_timeout) {
-            general_timeout = MyAtoi(raw_config->main->default_timeout);
-            if (general_timeout == -1) {
-                return ExecutionConfigCreationFailed(exec_config, "invalid argument for general timeout", EINVAL);
-            }
-        } else {
-            general_timeout = DEFAULT_TIMEOUT;
+        if (task_by_name[name_id] != -1) {
+            return ExecutionConfigCreationFailed(arena, "tasks with the same name occured", EINVAL);
         }
+        task_by_name[name_id] = i;
     }
 
-    exec_config->max_concurrent_tasks = max_concurrent_tasks;
-
     for (int i = 0; i < num_tasks; ++i) {
-        TaskConfig* new_task_config = NewTaskConfig(raw_config->tasks[i], general_timeout, log_directory);
-        if (!new_task_config) {
-            exec_config->tasks[i] = NULL;
-            return ExecutionConfigCreationFailed(exec_config, "failed creating one of the task configs", errno);
+        exec_config->tasks[i] = NewTaskConfig(arena, raw_config, &raw_config->tasks[i], general_timeout, log_prefix);
+        if (!exec_config->tasks[i] || !ResolveTaskDependencies(exec_config->tasks[i], task_by_name)) {
+            return ExecutionConfigCreationFailed(arena, "failed creating one of the task configs", errno);
         }
-
-        exec_config->tasks[i] = new_task_config;
     }
 
     return exec_config;
@@ -710,11 +753,20 @@ void* FailedReadingExecutionConfig(
     return NULL;
 }
 
+ExecutionConfig* ReadExecutionConfig(FILE* file, const char* log_directory) {
+    ConfigBuffer buffer;
+    if (!LoadConfigBuffer(file, &buffer)) {
+        return FailedReadingExecutionConfig("config reading error", errno, NULL);
+    }
+
+    return ParseExecutionConfig(&buffer, log_directory);
+}
+
 // Parse ExecutionConfig.
 // Validates required fields, value types and restrictions.
 // Returns NULL on error.
-ExecutionConfig* ReadExecutionConfig(FILE* file, const char* log_directory) {
-    RawConfig* raw_config = ParseRawConfig(file);
+ExecutionConfig* ParseExecutionConfig(ConfigBuffer* buffer, const char* log_directory) {
+    RawConfig* raw_config = ParseRawConfig(buffer);
     if (!raw_config) {
         return FailedReadingExecutionConfig("", errno, NULL);
     }
@@ -727,4 +779,645 @@ ExecutionConfig* ReadExecutionConfig(FILE* file, const char* log_directory) {
     FreeRawConfig(raw_config);
 
     return exec_config;
-}
\ No newline at end of file
+}
+// Report the failure once, later pumps keep returning it.
+static int FailedPumpingConfigStream(ConfigStream* stream, const char* message, int line_number, int error_code) {
+    errno = error_code;
+    fprintf(stderr, "config stream error: ");
+    perror(message);
+    if (line_number != -1) {
+        fprintf(stderr, "In config stream in line %d\n", line_number);
+    }
+
+    stream->error = message;
+    errno = error_code;
+    return -1;
+}
+
+void FreeConfigStream(ConfigStream* stream) {
+    if (!stream) {
+        return;
+    }
+
+    FreeRawConfig(stream->raw_);
+    free(stream->buffer_);
+    FreeIntVector(stream->task_by_name_);
+    FreeIntVector(stream->name_by_task_);
+    FreeIntVector(stream->pending_);
+    FreeIntVector(stream->pending_tasks_);
+    FreeIntVector(stream->pending_slots_);
+    FreeIntVector(stream->waiters_);
+    FreeIntVector(stream->waiter_edges_);
+    FreeIntVector(stream->admitted_);
+    FreeIntVector(stream->visit_marks_);
+    FreeIntVector(stream->stack_);
+    FreeIntVector(stream->back_stack_);
+    free(stream);
+}
+
+ConfigStream* NewConfigStream(int fd, const char* log_directory) {
+    if (fd < 0 || !log_directory) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    ConfigStream* stream = calloc(1, sizeof(ConfigStream));
+    if (!stream) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    stream->fd_ = fd;
+    stream->buffer_capacity_ = 2 * CONFIG_STREAM_CHUNK_SIZE;
+    stream->buffer_ = malloc(stream->buffer_capacity_);
+    stream->tasks_capacity_ = RAW_TASKS_INITIAL_CAPACITY;
+    stream->raw_ = NewRawConfig();
+    stream->task_by_name_ = NewIntVector(RAW_TASKS_INITIAL_CAPACITY);
+    stream->name_by_task_ = NewIntVector(RAW_TASKS_INITIAL_CAPACITY);
+    stream->pending_ = NewIntVector(RAW_TASKS_INITIAL_CAPACITY);
+    stream->pending_tasks_ = NewIntVector(RAW_TASKS_INITIAL_CAPACITY);
+    stream->pending_slots_ = NewIntVector(RAW_TASKS_INITIAL_CAPACITY);
+    stream->waiters_ = NewIntVector(RAW_TASKS_INITIAL_CAPACITY);
+    stream->waiter_edges_ = NewIntVector(RAW_TASKS_INITIAL_CAPACITY);
+    stream->admitted_ = NewIntVector(RAW_TASKS_INITIAL_CAPACITY);
+    stream->visit_marks_ = NewIntVector(RAW_TASKS_INITIAL_CAPACITY);
+    stream->stack_ = NewIntVector(RAW_TASKS_INITIAL_CAPACITY);
+    stream->back_stack_ = NewIntVector(RAW_TASKS_INITIAL_CAPACITY);
+    if (!stream->buffer_ || !stream->raw_ || !stream->task_by_name_ || !stream->name_by_task_ ||
+        !stream->pending_ || !stream->pending_tasks_ || !stream->pending_slots_ || !stream->waiters_ ||
+        !stream->waiter_edges_ || !stream->admitted_ || !stream->visit_marks_ || !stream->stack_ || !stream->back_stack_)
+    {
+        FreeConfigStream(stream);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    // Tasks are materialized one by one, so the config grows its arena block by block
+    Arena* arena = NewArena(CONFIG_STREAM_CHUNK_SIZE);
+    ExecutionConfig* config = arena ? ArenaAlloc(arena, sizeof(ExecutionConfig)) : NULL;
+    TaskConfig** tasks = arena ? ArenaAlloc(arena, sizeof(TaskConfig*) * stream->tasks_capacity_) : NULL;
+    char* log_prefix = arena ? NewLogPrefix(arena, log_directory) : NULL;
+    if (!config || !tasks || !log_prefix) {
+        int saved_errno = arena ? errno : ENOMEM;
+        FreeArena(arena);
+        FreeConfigStream(stream);
+        errno = saved_errno;
+        return NULL;
+    }
+
+    config->arena_ = arena;
+    config->cache_map_ = NULL;
+    config->num_tasks = 0;
+    config->tasks = tasks;
+
+    // Defaults hold until the main section, if there is any
+    char* message;
+    ApplyMainSection(config, NULL, &stream->general_timeout_, &message);
+
+    stream->config = config;
+    stream->log_prefix_ = log_prefix;
+    stream->raw_->names_arena = arena;
+    return stream;
+}
+
+bool IsConfigStreamSettled(const ConfigStream* stream) {
+    return stream && stream->main_applied_;
+}
+
+bool NextAdmittedTask(ConfigStream* stream, int* task) {
+    if (!stream || !task) {
+        errno = EINVAL;
+        return false;
+    }
+
+    if (stream->admitted_head_ == GetIntVectorLength(stream->admitted_)) {
+        TruncateIntVector(stream->admitted_, 0);
+        stream->admitted_head_ = 0;
+        return false;
+    }
+
+    *task = GetIntVectorElement(stream->admitted_, stream->admitted_head_++);
+    return true;
+}
+
+// Move the views of the open section along with the text they point into.
+static void RebaseOpenSection(ConfigStream* stream, const char* old_base, const char* new_base) {
+    RawConfig* raw_config = stream->raw_;
+    const SectionField* fields;
+    void* section;
+
+    if (raw_config->open_section == RAW_SECTION_MAIN) {
+        fields = kMainFields;
+        section = &raw_config->main;
+    } else if (raw_config->open_section == RAW_SECTION_TASK) {
+        fields = kTaskFields;
+        section = &raw_config->tasks[raw_config->num_tasks - 1];
+    } else {
+        return;
+    }
+
+    for (; fields->key; ++fields) {
+        StringView* view = (StringView*)((char*)section + fields->offset);
+        if (view->data) {
+            view->data = new_base + (view->data - old_base);
+        }
+    }
+}
+
+// Make room for a chunk after the buffered input.
+// Parsed lines are dropped unless the open section points into them, the rest moves to the buffer start.
+// Returns false on error.
+static bool ReserveConfigStreamChunk(ConfigStream* stream) {
+    if (stream->buffer_capacity_ - stream->buffer_len_ >= CONFIG_STREAM_CHUNK_SIZE) {
+        return true;
+    }
+
+    size_t keep_from = stream->raw_->open_section != RAW_SECTION_NONE ? stream->section_start_ : stream->parsed_;
+    size_t keep_len = stream->buffer_len_ - keep_from;
+    char* buffer = stream->buffer_;
+
+    if (keep_len + CONFIG_STREAM_CHUNK_SIZE > stream->buffer_capacity_) {
+        size_t capacity = stream->buffer_capacity_ * 2;
+        if (capacity < keep_len + CONFIG_STREAM_CHUNK_SIZE) {
+            capacity = keep_len + CONFIG_STREAM_CHUNK_SIZE;
+        }
+
+        buffer = malloc(capacity);
+        if (!buffer) {
+            errno = ENOMEM;
+            return false;
+        }
+        stream->buffer_capacity_ = capacity;
+    }
+
+    memmove(buffer, stream->buffer_ + keep_from, keep_len);
+    RebaseOpenSection(stream, stream->buffer_ + keep_from, buffer);
+    if (buffer != stream->buffer_) {
+        free(stream->buffer_);
+        stream->buffer_ = buffer;
+    }
+
+    stream->buffer_len_ = keep_len;
+    stream->parsed_ -= keep_from;
+    if (stream->raw_->open_section != RAW_SECTION_NONE) {
+        stream->section_start_ -= keep_from;
+    }
+    return true;
+}
+
+// Append task to the config, growing the task list in the arena.
+// Returns false on error.
+static bool AppendStreamedTask(ConfigStream* stream, TaskConfig* task_config) {
+    ExecutionConfig* config = stream->config;
+
+    if (config->num_tasks == stream->tasks_capacity_) {
+        // The old list stays in the arena, lists of all sizes together take at most twice the last one
+        TaskConfig** tasks = ArenaAlloc(config->arena_, sizeof(TaskConfig*) * stream->tasks_capacity_ * 2);
+        if (!tasks) {
+            errno = ENOMEM;
+            return false;
+        }
+
+        memcpy(tasks, config->tasks, sizeof(TaskConfig*) * config->num_tasks);
+        config->tasks = tasks;
+        stream->tasks_capacity_ *= 2;
+    }
+
+    config->tasks[config->num_tasks++] = task_config;
+    return true;
+}
+
+typedef enum CycleSearchResult {
+    CYCLE_NOT_FOUND,
+    CYCLE_FOUND,
+    CYCLE_UNDECIDED,  // the search ran out of credit
+} CycleSearchResult;
+
+// Expand one task of a cycle search side: requirements going forward, waiting tasks going backward.
+// Sets found if a task the other side has visited, or the new task itself, is reached.
+// Returns false on error.
+static bool ExpandCycleSearch(ConfigStream* stream, IntVector* stack, int task, bool forward, bool* found) {
+    int current = GetIntVectorElement(stack, GetIntVectorLength(stack) - 1);
+    int mark = 2 * stream->visit_epoch_ + forward;
+    int other_mark = 2 * stream->visit_epoch_ + !forward;
+    TruncateIntVector(stack, GetIntVectorLength(stack) - 1);
+    stream->search_credit_--;
+
+    // Tasks that aren't admitted still have their requirements as name IDs
+    const TaskConfig* task_config = stream->config->tasks[current];
+    int edge = forward ? -1 : GetIntVectorElement(stream->waiters_, GetIntVectorElement(stream->name_by_task_, current));
+    size_t i = 0;
+
+    while (forward ? i < task_config->num_dependencies : edge != -1) {
+        int next;
+        if (forward) {
+            next = GetIntVectorElement(stream->task_by_name_, task_config->dependencies[i++]);
+        } else {
+            next = GetIntVectorElement(stream->waiter_edges_, 2 * edge);
+            edge = GetIntVectorElement(stream->waiter_edges_, 2 * edge + 1);
+        }
+
+        if (next == -1 || GetIntVectorElement(stream->pending_, next) == 0) {
+            continue;
+        }
+
+        int next_mark = GetIntVectorElement(stream->visit_marks_, next);
+        if (next == task || next_mark == other_mark) {
+            *found = true;
+            return true;
+        } else if (next_mark == mark) {
+            continue;
+        }
+
+        SetIntVectorElement(stream->visit_marks_, next, mark);
+        if (!AppendToIntVector(stack, next)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Check whether the new task closes a cycle, i.e. some task it requires is waiting for it.
+// Requirements and waiting tasks are searched in turns, stopping as soon as either side runs out,
+// so joining two long pending chains costs the shorter one.
+// The search gives up once the credit is spent, so that sections arriving in random order stay linear overall.
+// Returns false on error.
+static bool FindRequirementCycle(ConfigStream* stream, int task, CycleSearchResult* result) {
+    IntVector* forward = stream->stack_;
+    IntVector* backward = stream->back_stack_;
+    bool found = false;
+
+    stream->visit_epoch_++;
+    TruncateIntVector(forward, 0);
+    TruncateIntVector(backward, 0);
+    if (!AppendToIntVector(forward, task) || !AppendToIntVector(backward, task)) {
+        return false;
+    }
+
+    while (GetIntVectorLength(forward) > 0 && GetIntVectorLength(backward) > 0 && !found) {
+        if (stream->search_credit_ == 0) {
+            *result = CYCLE_UNDECIDED;
+            return true;
+        }
+
+        if (!ExpandCycleSearch(stream, forward, task, true, &found) ||
+            (!found && GetIntVectorLength(backward) > 0 && !ExpandCycleSearch(stream, backward, task, false, &found)))
+        {
+            return false;
+        }
+    }
+
+    *result = found ? CYCLE_FOUND : CYCLE_NOT_FOUND;
+    return true;
+}
+
+// Check all pending tasks for a cycle: tasks whose pending requirements have all been peeled off are peeled
+// in turn, whatever is left over is on a cycle or waits for one. Undefined names can't be on a cycle.
+// Visit marks serve as the counts of requirements not peeled yet and are reset afterwards.
+// Returns false on error.
+static bool FindPendingCycle(ConfigStream* stream, bool* found) {
+    IntVector* stack = stream->stack_;
+    size_t num_pending = GetIntVectorLength(stream->pending_tasks_);
+    size_t num_peeled = 0;
+
+    TruncateIntVector(stack, 0);
+    for (size_t i = 0; i < num_pending; ++i) {
+        int task = GetIntVectorElement(stream->pending_tasks_, i);
+        const TaskConfig* task_config = stream->config->tasks[task];
+        int count = 0;
+
+        for (size_t j = 0; j < task_config->num_dependencies; ++j) {
+            int required = GetIntVectorElement(stream->task_by_name_, task_config->dependencies[j]);
+            count += required != -1 && GetIntVectorElement(stream->pending_, required) > 0;
+        }
+
+        SetIntVectorElement(stream->visit_marks_, task, count);
+        if (count == 0 && !AppendToIntVector(stack, task)) {
+            return false;
+        }
+    }
+
+    while (GetIntVectorLength(stack) > 0) {
+        int current = GetIntVectorElement(stack, GetIntVectorLength(stack) - 1);
+        TruncateIntVector(stack, GetIntVectorLength(stack) - 1);
+        num_peeled++;
+
+        int name_id = GetIntVectorElement(stream->name_by_task_, current);
+        for (int edge = GetIntVectorElement(stream->waiters_, name_id); edge != -1;
+             edge = GetIntVectorElement(stream->waiter_edges_, 2 * edge + 1))
+        {
+            int waiting = GetIntVectorElement(stream->waiter_edges_, 2 * edge);
+            if (ChangeIntVectorElement(stream->visit_marks_, waiting, -1) == 0 && !AppendToIntVector(stack, waiting)) {
+                return false;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < num_pending; ++i) {
+        SetIntVectorElement(stream->visit_marks_, GetIntVectorElement(stream->pending_tasks_, i), -1);
+    }
+
+    *found = num_peeled < num_pending;
+    stream->cycle_check_owed_ = false;
+    stream->checked_pending_ = num_pending;
+    return true;
+}
+
+// Admit the task and every waiting task it was the last missing requirement of.
+// Returns false on error.
+static bool AdmitStreamedTask(ConfigStream* stream, int task) {
+    IntVector* stack = stream->stack_;
+
+    TruncateIntVector(stack, 0);
+    if (!AppendToIntVector(stack, task)) {
+        return false;
+    }
+
+    while (GetIntVectorLength(stack) > 0) {
+        int current = GetIntVectorElement(stack, GetIntVectorLength(stack) - 1);
+        TruncateIntVector(stack, GetIntVectorLength(stack) - 1);
+
+        // Every requirement is defined by now
+        if (!ResolveTaskDependencies(stream->config->tasks[current], GetIntVectorData(stream->task_by_name_)) ||
+            !AppendToIntVector(stream->admitted_, current))
+        {
+            return false;
+        }
+        stream->num_admitted_++;
+
+        // Swap the task out of the pending list, unless it never was on it
+        int slot = GetIntVectorElement(stream->pending_slots_, current);
+        if (slot != -1) {
+            size_t last = GetIntVectorLength(stream->pending_tasks_) - 1;
+            int moved = GetIntVectorElement(stream->pending_tasks_, last);
+            SetIntVectorElement(stream->pending_tasks_, slot, moved);
+            SetIntVectorElement(stream->pending_slots_, moved, slot);
+            TruncateIntVector(stream->pending_tasks_, last);
+            SetIntVectorElement(stream->pending_slots_, current, -1);
+        }
+
+        int name_id = GetIntVectorElement(stream->name_by_task_, current);
+        for (int edge = GetIntVectorElement(stream->waiters_, name_id); edge != -1;
+             edge = GetIntVectorElement(stream->waiter_edges_, 2 * edge + 1))
+        {
+            int waiting = GetIntVectorElement(stream->waiter_edges_, 2 * edge);
+            if (ChangeIntVectorElement(stream->pending_, waiting, -1) == 0 && !AppendToIntVector(stack, waiting)) {
+                return false;
+            }
+        }
+        SetIntVectorElement(stream->waiters_, name_id, -1);
+    }
+
+    return true;
+}
+
+// Materialize the task section closed at line_number and admit whatever it unblocks.
+// Returns -1 and sets error on error.
+static int FinishStreamedTask(ConfigStream* stream, int line_number) {
+    RawConfig* raw_config = stream->raw_;
+    const TaskSection* task_section = &raw_config->tasks[0];
+
+    // Names interned by the section get their slots
+    while (GetIntVectorLength(stream->task_by_name_) < GetInternedNameCount(raw_config->names)) {
+        if (!AppendToIntVector(stream->task_by_name_, -1) || !AppendToIntVector(stream->waiters_, -1)) {
+            return FailedPumpingConfigStream(stream, "memory error", -1, ENOMEM);
+        }
+    }
+
+    int name_id = task_section->name_id;
+    if (name_id != -1 && GetIntVectorElement(stream->task_by_name_, name_id) != -1) {
+        return FailedPumpingConfigStream(stream, "tasks with the same name occured", line_number, EINVAL);
+    }
+
+    TaskConfig* task_config = NewTaskConfig(
+        raw_config->names_arena, raw_config, task_section, stream->general_timeout_, stream->log_prefix_);
+    if (!task_config) {
+        return FailedPumpingConfigStream(stream, "failed creating one of the task configs", line_number, errno);
+    }
+
+    int task = stream->config->num_tasks;
+    if (!AppendStreamedTask(stream, task_config) ||
+        !AppendToIntVector(stream->name_by_task_, name_id) ||
+        !AppendToIntVector(stream->pending_, 0) ||
+        !AppendToIntVector(stream->pending_slots_, -1) ||
+        !AppendToIntVector(stream->visit_marks_, -1))
+    {
+        return FailedPumpingConfigStream(stream, "memory error", -1, ENOMEM);
+    }
+    SetIntVectorElement(stream->task_by_name_, name_id, task);
+
+    // The section is done with, the next one reuses its slot
+    raw_config->num_tasks = 0;
+    TruncateIntVector(raw_config->requirement_ids, 0);
+
+    // Requirements which aren't admitted yet get the task on their waiting list
+    int num_pending = 0;
+    for (size_t i = 0; i < task_config->num_dependencies; ++i) {
+        int required_name = task_config->dependencies[i];
+        int required = GetIntVectorElement(stream->task_by_name_, required_name);
+
+        if (required != -1 && required != task && GetIntVectorElement(stream->pending_, required) == 0) {
+            continue;
+        }
+
+        int edge = GetIntVectorLength(stream->waiter_edges_) / 2;
+        if (!AppendToIntVector(stream->waiter_edges_, task) ||
+            !AppendToIntVector(stream->waiter_edges_, GetIntVectorElement(stream->waiters_, required_name)))
+        {
+            return FailedPumpingConfigStream(stream, "memory error", -1, ENOMEM);
+        }
+        SetIntVectorElement(stream->waiters_, required_name, edge);
+        num_pending++;
+    }
+    SetIntVectorElement(stream->pending_, task, num_pending);
+    stream->search_credit_ += CYCLE_SEARCH_CREDIT;
+
+    if (num_pending == 0) {
+        if (!AdmitStreamedTask(stream, task)) {
+            return FailedPumpingConfigStream(stream, "memory error", -1, ENOMEM);
+        }
+        return 0;
+    }
+
+    SetIntVectorElement(stream->pending_slots_, task, GetIntVectorLength(stream->pending_tasks_));
+    if (!AppendToIntVector(stream->pending_tasks_, task)) {
+        return FailedPumpingConfigStream(stream, "memory error", -1, ENOMEM);
+    }
+
+    // A cycle through the task needs both a requirement and a task waiting for it
+    CycleSearchResult result = CYCLE_NOT_FOUND;
+    if (GetIntVectorElement(stream->waiters_, name_id) != -1 && !FindRequirementCycle(stream, task, &result)) {
+        return FailedPumpingConfigStream(stream, "memory error", -1, ENOMEM);
+    }
+    stream->cycle_check_owed_ |= result == CYCLE_UNDECIDED;
+
+    // Each full check is paid for by the tasks that doubled the pending list since the last one
+    size_t num_waiting = GetIntVectorLength(stream->pending_tasks_);
+    bool found = result == CYCLE_FOUND;
+    if (stream->cycle_check_owed_ && num_waiting >= CYCLE_CHECK_MIN_PENDING &&
+        num_waiting >= 2 * stream->checked_pending_ && !FindPendingCycle(stream, &found))
+    {
+        return FailedPumpingConfigStream(stream, "memory error", -1, ENOMEM);
+    }
+
+    if (found) {
+        return FailedPumpingConfigStream(stream, "cycle in requirements exists", line_number, EINVAL);
+    }
+    return 0;
+}
+
+// Settle the config once the main section is over or can't come anymore.
+// Returns -1 and sets error on error.
+static int SettleConfigStream(ConfigStream* stream, int line_number) {
+    RawConfig* raw_config = stream->raw_;
+    char* message;
+
+    stream->main_applied_ = true;
+    if (raw_config->has_main &&
+        !ApplyMainSection(stream->config, &raw_config->main, &stream->general_timeout_, &message))
+    {
+        return FailedPumpingConfigStream(stream, message, line_number, EINVAL);
+    }
+
+    return 0;
+}
+
+// Parse complete lines of [begin, end).
+// Returns -1 and sets error on error.
+static int ParseConfigStreamLines(ConfigStream* stream, const char* begin, const char* end) {
+    RawConfig* raw_config = stream->raw_;
+    ConfigBuffer lines = {.data = begin, .size = end - begin};
+    ConfigLineReader reader;
+    ConfigLine line;
+    char* message = "";
+    bool closed_task;
+
+    InitConfigLineReader(&reader, &lines);
+    while (NextConfigLine(&reader, &line)) {
+        RawConfigSection open_section = raw_config->open_section;
+        int line_number = stream->line_number_ + GetConfigLineNumber(&reader);
+
+        if (!ParseRawConfigLine(raw_config, &line, &closed_task, &message)) {
+            return FailedPumpingConfigStream(stream, message, line_number, errno);
+        }
+
+        if (open_section == RAW_SECTION_NONE && raw_config->open_section != RAW_SECTION_NONE) {
+            stream->section_start_ = line.first.data - stream->buffer_;
+        }
+
+        // Tasks are materialized right away, so their settings have to be known before the first one
+        if (raw_config->open_section == RAW_SECTION_MAIN && stream->main_applied_) {
+            return FailedPumpingConfigStream(stream, "main section has to come before tasks", line_number, EINVAL);
+        } else if (!stream->main_applied_ && raw_config->open_section != RAW_SECTION_MAIN &&
+                   (raw_config->has_main || raw_config->num_tasks > 0))
+        {
+            if (SettleConfigStream(stream, line_number) == -1) {
+                return -1;
+            }
+        }
+
+        if (closed_task && FinishStreamedTask(stream, line_number) == -1) {
+            return -1;
+        }
+    }
+
+    stream->line_number_ += GetConfigLineNumber(&reader);
+    stream->parsed_ = end - stream->buffer_;
+    return 0;
+}
+
+// Input is over: close the last section and check that every requirement got defined.
+// Returns -1 and sets error on error.
+static int FinishConfigStream(ConfigStream* stream) {
+    RawConfig* raw_config = stream->raw_;
+    bool closed_task;
+
+    if (!CloseRawConfigSection(raw_config, &closed_task)) {
+        return FailedPumpingConfigStream(stream, "config parsing error", -1, errno);
+    }
+
+    if (!stream->main_applied_ && SettleConfigStream(stream, stream->line_number_) == -1) {
+        return -1;
+    }
+
+    if (closed_task && FinishStreamedTask(stream, stream->line_number_) == -1) {
+        return -1;
+    }
+
+    if (stream->num_admitted_ == stream->config->num_tasks) {
+        return 0;
+    }
+
+    bool found;
+    if (!FindPendingCycle(stream, &found)) {
+        return FailedPumpingConfigStream(stream, "memory error", -1, ENOMEM);
+    } else if (found) {
+        return FailedPumpingConfigStream(stream, "cycle in requirements exists", -1, EINVAL);
+    }
+
+    // Tasks left are waiting, directly or through other tasks, for names nobody defined
+    for (size_t name_id = 0; name_id < GetIntVectorLength(stream->task_by_name_); ++name_id) {
+        if (GetIntVectorElement(stream->task_by_name_, name_id) == -1 &&
+            GetIntVectorElement(stream->waiters_, name_id) != -1)
+        {
+            StringView name = GetInternedName(raw_config->names, name_id);
+            fprintf(stderr, "Task %.*s is required, but never defined\n", (int)name.len, name.data);
+            break;
+        }
+    }
+
+    return FailedPumpingConfigStream(stream, "invalid task requirements", -1, EINVAL);
+}
+
+int PumpConfigStream(ConfigStream* stream) {
+    if (!stream) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (stream->error) {
+        errno = EINVAL;
+        return -1;
+    } else if (stream->eof_) {
+        return 0;
+    }
+
+    if (!ReserveConfigStreamChunk(stream)) {
+        return FailedPumpingConfigStream(stream, "memory error", -1, ENOMEM);
+    }
+
+    ssize_t nbytes;
+    do {
+        nbytes = read(stream->fd_, stream->buffer_ + stream->buffer_len_, CONFIG_STREAM_CHUNK_SIZE);
+    } while (nbytes == -1 && errno == EINTR);
+
+    if (nbytes == -1 && errno == EAGAIN) {
+        return 1;
+    } else if (nbytes == -1) {
+        return FailedPumpingConfigStream(stream, "config reading error", -1, errno);
+    }
+
+    const char* begin = stream->buffer_ + stream->parsed_;
+    const char* end = stream->buffer_ + stream->buffer_len_ + nbytes;
+    stream->buffer_len_ += nbytes;
+
+    // Lines before the chunk are all parsed, so only the chunk may hold the last line end
+    if (nbytes == 0) {
+        stream->eof_ = true;
+    } else {
+        const char* chunk = end - nbytes;
+        while (end > chunk && end[-1] != '\n') {
+            end--;
+        }
+        if (end == chunk) {
+            return 1;
+        }
+    }
+
+    if (ParseConfigStreamLines(stream, begin, end) == -1) {
+        return -1;
+    }
+
+    return stream->eof_ ? FinishConfigStream(stream) : 1;
+}
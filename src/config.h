@@ -1,10 +1,16 @@
 #pragma once
 
 #include <stdio.h>
+#include <stddef.h>
+#include <limits.h>
+#include <unistd.h>
 
 #include "vector.h"
 #include "utils.h"
 #include "constants.h"
+#include "arena.h"
+#include "intern.h"
+#include "tokenizer.h"
 
 typedef enum TaskType {
     TASK_TYPE_SLEEP,
@@ -17,14 +23,18 @@ typedef struct SleepTaskArgs {
 
 typedef struct ExecTaskArgs {
     const char* binary_path;  // path to executable to run
-    StringVector* argv;       // array of cmd args to pass
+    char** argv;              // NULL-terminated array of cmd args to pass
+    char* command;            // command line run by the executable, the last of argv
 } ExecTaskArgs;
 
 typedef struct TaskConfig {
     char* name;                     // task name
-    StringVector* requirements;     // list of names of tasks which need to be run before this one
-    unsigned int timeout;           // timeout in seconds, 0 means no timeout
+    int* dependencies;              // indices of tasks which need to be run before this one
+    size_t num_dependencies;
+    unsigned int timeout_ms;        // timeout in milliseconds, 0 means no timeout
     char* log_path;                 // path to output logs, in format `{log_directory}/{task_name}.log`
+    unsigned int cpus;              // declared CPU demand, 0 means undeclared
+    unsigned int memory_mb;         // declared memory demand in MB, 0 means undeclared
 
     TaskType type;                  // task type
     union {
@@ -35,9 +45,16 @@ typedef struct TaskConfig {
 
 typedef struct ExecutionConfig {
     int max_concurrent_tasks;  // max number of tasks running in parallel
+    bool adaptive_concurrency; // `max_concurrent_tasks: auto`, window is tuned at run time up to max_concurrent_tasks
+    unsigned int cpu_budget;        // CPUs shared by running tasks, defaults to online CPUs
+    unsigned int memory_budget_mb;  // memory in MB shared by running tasks, defaults to physical memory
 
     size_t num_tasks;          // number of tasks
     TaskConfig** tasks;        // task list
+
+    Arena* arena_;             // owns the config itself and every task field
+    void* cache_map_;          // mapped DAG cache the strings point into, NULL if the config was parsed
+    size_t cache_map_size_;
 } ExecutionConfig;
 
 
@@ -45,6 +62,79 @@ typedef struct ExecutionConfig {
 // Returns NULL on error.
 ExecutionConfig* ReadExecutionConfig(FILE* file, const char* log_directory);
 
-// Free execution config instance.
-// Ignores NULL config and fields.
+// Parse execution config from an already loaded text, the buffer is taken over either way.
+// Returns NULL on error.
+ExecutionConfig* ParseExecutionConfig(ConfigBuffer* buffer, const char* log_directory);
+
+// Build args running command with PATH_TO_EXECUTABLE, command is kept as is.
+// Returns NULL on error.
+ExecTaskArgs* NewExecTaskArgs(Arena* arena, char* command);
+
+// Free execution config instance with every task config in one go.
+// Ignores NULL config.
 void FreeExecutionConfig(ExecutionConfig* config);
+
+
+typedef struct RawConfig RawConfig;
+
+// Incremental parser of a config arriving over a pipe.
+// Each task section is materialized as soon as it ends, and the task is admitted once every one of
+// its requirements is defined and admitted, so tasks are admitted in dependency order.
+// The main section has to come before the first task section.
+typedef struct ConfigStream {
+    ExecutionConfig* config;  // tasks defined so far, owned by the caller
+    const char* error;        // reason of the failure, NULL if none
+
+    int fd_;
+    char* buffer_;            // input not parsed yet, along with the open section
+    size_t buffer_len_;
+    size_t buffer_capacity_;
+    size_t parsed_;           // complete lines up to here have been parsed
+    size_t section_start_;    // header of the open section
+    int line_number_;         // lines parsed so far
+    bool eof_;
+    bool main_applied_;       // concurrency, budgets and timeouts are final
+    int general_timeout_;
+    const char* log_prefix_;
+    size_t tasks_capacity_;
+    RawConfig* raw_;          // main section, interned names and the open task section
+
+    IntVector* task_by_name_;  // name ID -> task index, -1 until a task with the name is defined
+    IntVector* name_by_task_;  // task -> name ID
+    IntVector* pending_;       // task -> number of requirements not admitted yet, 0 once admitted
+    IntVector* pending_tasks_; // defined tasks not admitted yet
+    IntVector* pending_slots_; // task -> position in pending_tasks_
+    IntVector* waiters_;       // name ID -> first edge of tasks waiting for it, -1 if none
+    IntVector* waiter_edges_;  // pairs of waiting task and next edge
+    IntVector* admitted_;      // admitted tasks not taken yet, from admitted_head_ on
+    size_t admitted_head_;
+    size_t num_admitted_;
+    IntVector* visit_marks_;   // task -> cycle search and side it has been visited by, peeling count in a full check
+    int visit_epoch_;
+    size_t search_credit_;     // tasks cycle searches may still expand
+    bool cycle_check_owed_;    // a search ran out of credit before deciding
+    size_t checked_pending_;   // pending tasks at the last full check
+    IntVector* stack_;         // admission worklist and forward side of a cycle search
+    IntVector* back_stack_;    // backward side of a cycle search
+} ConfigStream;
+
+// Start parsing a config read from fd, which is left open.
+// Returns NULL on error.
+ConfigStream* NewConfigStream(int fd, const char* log_directory);
+
+// Free stream instance, the config stays with the caller.
+// Ignores NULL instance.
+void FreeConfigStream(ConfigStream* stream);
+
+// Read one chunk of input and parse every section it completes, so the fd can be driven by an event loop.
+// A short cycle is reported as soon as the section closing it is parsed, a long one at the latest
+// once the tasks waiting have doubled, a requirement no task defines once the input is over.
+// Returns 1 if more input is expected, 0 at the end of input, -1 and sets error on error.
+int PumpConfigStream(ConfigStream* stream);
+
+// Check whether concurrency and budgets of the config are final, i.e. a task section or the end of input was reached.
+bool IsConfigStreamSettled(const ConfigStream* stream);
+
+// Take the next admitted task, its dependencies are task indices by now.
+// Returns false if there are none.
+bool NextAdmittedTask(ConfigStream* stream, int* task);
@@ -1,7 +1,28 @@
-#define MAX_TASKS_COUNT 100
+#define RAW_TASKS_INITIAL_CAPACITY 16
 #define BUF_SIZE 500
 #define DEFAULT_MAX_CUNCURRENT_TASKS 3
 #define DEFAULT_TIMEOUT 10
 
 // If PATH_TO_EXECUTABLE === "/bin/bash", flag "-c" added 
-#define PATH_TO_EXECUTABLE "/bin/bash"
\ No newline at end of file
+#define PATH_TO_EXECUTABLE "/bin/bash"
+
+// Run time assumed for EXEC tasks by the critical path scheduler
+#define DEFAULT_EXEC_ESTIMATE_MS 1000
+
+// Runtime history file, stored in the log directory
+#define HISTORY_FILE_NAME "task-history.bin"
+
+// `max_concurrent_tasks: auto` tunes the dispatch window by system pressure,
+// sampled every PRESSURE_SAMPLE_INTERVAL_MS, up to ADAPTIVE_CONCURRENCY_FACTOR tasks per CPU
+#define ADAPTIVE_CONCURRENCY_VALUE "auto"
+#define ADAPTIVE_CONCURRENCY_FACTOR 16
+#define PRESSURE_SAMPLE_INTERVAL_MS 500
+
+// `--config -` streams the config from stdin, read CONFIG_STREAM_CHUNK_SIZE bytes at a time
+#define STDIN_CONFIG_PATH "-"
+#define CONFIG_STREAM_CHUNK_SIZE (1 << 16)
+
+// Every streamed task section lets cycle searches expand this many more tasks,
+// longer searches are left to a full pass once the tasks waiting have doubled since the last one
+#define CYCLE_SEARCH_CREDIT 16
+#define CYCLE_CHECK_MIN_PENDING 1024
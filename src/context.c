@@ -3,7 +3,7 @@
 // Create new context instance.
 // Returns NULL on error.
 Context* NewContext(const Graph* dependency_graph, const ExecutionConfig* config) {
-    if (!dependency_graph || !config) {
+    if (!config) {
         errno = EINVAL;
         return NULL;
     }
@@ -14,24 +14,57 @@ Context* NewContext(const Graph* dependency_graph, const ExecutionConfig* config
         return NULL;
     }
 
-    context->tasks = malloc(sizeof(TaskInfo) * config->num_tasks);
+    context->capacity_ = config->num_tasks ? config->num_tasks : 1;
+    context->tasks = malloc(sizeof(TaskInfo) * context->capacity_);
     if (!context->tasks) {
         free(context);
         errno = ENOMEM;
         return NULL;
     }
 
-    for (int i = 0; i < config->num_tasks; ++i) {
-        context->tasks[i].task_status = TASK_STATUS_UNKNOWN;
-        context->tasks[i].worker_status = 0;
-    }
+    context->num_tasks = 0;
+    context->num_drawn_rows_ = 0;
+    context->config = config;
+    GrowContext(context);
 
     context->dependency_graph = dependency_graph;
-    context->config = config;
+    context->history = NULL;
+    context->concurrency_window = 0;
+    context->show_usage = false;
 
     return context;
 }
 
+bool GrowContext(Context* context) {
+    if (!context) {
+        errno = EINVAL;
+        return false;
+    }
+
+    size_t num_tasks = context->config->num_tasks;
+    if (num_tasks > context->capacity_) {
+        size_t capacity = context->capacity_ * 2 > num_tasks ? context->capacity_ * 2 : num_tasks;
+        TaskInfo* tasks = realloc(context->tasks, sizeof(TaskInfo) * capacity);
+        if (!tasks) {
+            errno = ENOMEM;
+            return false;
+        }
+
+        context->tasks = tasks;
+        context->capacity_ = capacity;
+    }
+
+    for (size_t i = context->num_tasks; i < num_tasks; ++i) {
+        context->tasks[i].task_status = TASK_STATUS_UNKNOWN;
+        context->tasks[i].worker_status = 0;
+        context->tasks[i].start_ns = 0;
+        memset(&context->tasks[i].run, 0, sizeof(TaskRunRecord));
+    }
+
+    context->num_tasks = num_tasks;
+    return true;
+}
+
 // Free context instance.
 // Ignores NULL instance and fields.
 void FreeContext(Context* context) {
@@ -53,21 +86,48 @@ void ClearLines(int n) {
     fflush(stderr); // Применяем изменения немедленно
 }
 
+// Finish the row of a finished task, with resource usage columns if they are enabled.
+static void DrawTaskUsage(const Context* context, int task) {
+    const TaskRunRecord* run = &context->tasks[task].run;
+
+    if (context->show_usage) {
+        fprintf(stderr, " | wall %.2fs user %.2fs sys %.2fs rss %.1fMB csw %u/%u io %u/%u",
+                (run->end_ns - run->start_ns) / 1e9,
+                run->user_cpu_us / 1e6,
+                run->system_cpu_us / 1e6,
+                run->max_rss_kb / 1024.0,
+                run->voluntary_switches,
+                run->involuntary_switches,
+                run->block_input,
+                run->block_output);
+    }
+
+    fprintf(stderr, "\n");
+}
+
 // Render task statuses to stdout.
 // Clears previous rendering if redraw is true.
-void DrawContext(const Context* context, VerbosityType verbosity_type, bool redraw) {
+void DrawContext(Context* context, VerbosityType verbosity_type, bool redraw) {
     if (verbosity_type == VERBOSITY_TYPE_NONE) {
         return;
     } else if (verbosity_type == VERBOSITY_TYPE_TABLE) {
+        // A streamed config may have added rows since the last rendering
         if (redraw) {
-            ClearLines(context->config->num_tasks);
+            ClearLines(context->num_drawn_rows_);
+        }
+        context->num_drawn_rows_ = context->num_tasks + (context->concurrency_window > 0);
+
+        if (context->concurrency_window > 0) {
+            fprintf(stderr, "Concurrency window: %d\n", context->concurrency_window);
         }
         
         char* task_name;
         int wait_status;
         TaskStatus task_status;
+        RuntimeStats stats;
+        int64_t elapsed_ms, eta_ms;
 
-        for (int i = 0; i < context->config->num_tasks; ++i) {
+        for (int i = 0; i < context->num_tasks; ++i) {
             task_status = context->tasks[i].task_status;
             wait_status = context->tasks[i].worker_status;
             task_name = context->config->tasks[i]->name;
@@ -77,15 +137,25 @@ void DrawContext(const Context* context, VerbosityType verbosity_type, bool redr
             } else if (task_status == TASK_STATUS_QUEUED) {
                 fprintf(stderr, "%s:\x1b[33;1m QUEUED \033[0m\n", task_name);
             } else if (task_status == TASK_STATUS_RUNNING) {
-                fprintf(stderr, "%s:\x1b[34;1m RUNNING \033[0m\n", task_name);
+                if (context->history && GetTaskRuntimeStats(context->history, i, &stats)) {
+                    elapsed_ms = (GetTimeNs(CLOCK_REALTIME) - context->tasks[i].start_ns) / 1000000;
+                    eta_ms = stats.median_ms > elapsed_ms ? stats.median_ms - elapsed_ms : 0;
+                    fprintf(stderr, "%s:\x1b[34;1m RUNNING, ETA %.1f s \033[0m\n", task_name, eta_ms / 1000.0);
+                } else {
+                    fprintf(stderr, "%s:\x1b[34;1m RUNNING \033[0m\n", task_name);
+                }
+            } else if (task_status == TASK_STATUS_SKIPPED) {
+                fprintf(stderr, "%s:\x1b[35;1m SKIPPED \033[0m\n", task_name);
             } else if (task_status == TASK_STATUS_SUCCESS) {
-                fprintf(stderr, "%s:\x1b[32;1m SUCCESS, CODE %d\033[0m\n", task_name, WEXITSTATUS(wait_status));
+                fprintf(stderr, "%s:\x1b[32;1m SUCCESS, CODE %d\033[0m", task_name, WEXITSTATUS(wait_status));
+                DrawTaskUsage(context, i);
             } else {
                 if (WIFSIGNALED(wait_status)) {
-                    fprintf(stderr, "%s:\x1b[31;1m FAILED, SIGNAL %d\033[0m\n", task_name, WTERMSIG(wait_status));
+                    fprintf(stderr, "%s:\x1b[31;1m FAILED, SIGNAL %d\033[0m", task_name, WTERMSIG(wait_status));
                 } else {
-                    fprintf(stderr, "%s:\x1b[31;1m FAILED \033[0m\n", task_name);
+                    fprintf(stderr, "%s:\x1b[31;1m FAILED \033[0m", task_name);
                 }
+                DrawTaskUsage(context, i);
             }
         }
     }
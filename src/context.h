@@ -2,6 +2,7 @@
 
 #include "config.h"
 #include "graph.h"
+#include "history.h"
 
 typedef enum VerbosityType {
     VERBOSITY_TYPE_NONE,   // do not render task statuses
@@ -15,29 +16,42 @@ typedef enum TaskStatus {
     TASK_STATUS_RUNNING,  // task is currently running
     TASK_STATUS_SUCCESS,  // task has successfully finished with exit status 0
     TASK_STATUS_FAILED,   // task has failed due to non-zero exit status or any signal
+    TASK_STATUS_SKIPPED,  // task has never been started because one of its requirements failed
 } TaskStatus;
 
 typedef struct TaskInfo {
     TaskStatus task_status;  // high level task status
     int worker_status;       // detailed worker status
+    int64_t start_ns;        // CLOCK_REALTIME when the task was started, 0 if it wasn't
+    TaskRunRecord run;       // wall time and resource usage of the finished run
 } TaskInfo;
 
 typedef struct Context {
     TaskInfo* tasks;
+    size_t num_tasks;               // tasks covered, grows while a streamed config arrives
+    size_t capacity_;
+    size_t num_drawn_rows_;         // rows of the last rendering, cleared by a redraw
 
     const ExecutionConfig* config;  // for additional task info, such as name
-    const Graph* dependency_graph;  // for VERBOSITY_TYPE_GRAPH, currently unused
+    const Graph* dependency_graph;  // for VERBOSITY_TYPE_GRAPH, currently unused, NULL for a streamed config
+    const RuntimeHistory* history;  // for ETA of running tasks, or NULL
+    int concurrency_window;         // current adaptive dispatch window, 0 if concurrency is fixed
+    bool show_usage;                // render resource usage columns of finished tasks
 } Context;
 
 
-// Create new context instance.
+// Create new context instance covering the tasks config has so far.
 // Returns NULL on error.
 Context* NewContext(const Graph* dependency_graph, const ExecutionConfig* config);
 
+// Cover tasks added to the config since, new ones have unknown status.
+// Returns false and sets errno on error.
+bool GrowContext(Context* context);
+
 // Free context instance.
 // Ignores NULL instance and fields.
 void FreeContext(Context* context);
 
 // Render task statuses to stdout.
 // Clears previous rendering if redraw is true.
-void DrawContext(const Context* context, VerbosityType verbosity_type, bool redraw);
+void DrawContext(Context* context, VerbosityType verbosity_type, bool redraw);
@@ -0,0 +1,429 @@
+#include "dag_cache.h"
+
+#define HASH_PRIME_1 0x9E3779B185EBCA87ULL
+#define HASH_PRIME_2 0xC2B2AE3D27D4EB4FULL
+
+// Section offsets, fully determined by the counts in the header
+typedef struct DagCacheLayout {
+    size_t tasks;
+    size_t dependencies;
+    size_t out_offsets;
+    size_t out_edges;
+    size_t in_offsets;
+    size_t in_edges;
+    size_t strings;
+    size_t file_size;
+} DagCacheLayout;
+
+static size_t AlignSection(size_t offset) {
+    return (offset + 7) & ~(size_t)7;
+}
+
+static DagCacheLayout GetDagCacheLayout(const DagCacheHeader* header) {
+    DagCacheLayout layout;
+
+    layout.tasks = AlignSection(sizeof(DagCacheHeader));
+    layout.dependencies = layout.tasks + header->num_tasks * sizeof(DagCacheTask);
+    layout.out_offsets = AlignSection(layout.dependencies + header->num_dependencies * sizeof(int));
+    layout.out_edges = layout.out_offsets + (header->num_tasks + 1) * sizeof(size_t);
+    layout.in_offsets = AlignSection(layout.out_edges + header->num_edges * sizeof(int));
+    layout.in_edges = layout.in_offsets + (header->num_tasks + 1) * sizeof(size_t);
+    layout.strings = AlignSection(layout.in_edges + header->num_edges * sizeof(int));
+    layout.file_size = layout.strings + header->strings_size;
+    return layout;
+}
+
+char* GetDagCachePath(const char* config_path) {
+    if (!config_path) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    size_t len = strlen(config_path);
+    char* path = malloc(len + sizeof(DAG_CACHE_SUFFIX));
+    if (!path) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    memcpy(path, config_path, len);
+    memcpy(path + len, DAG_CACHE_SUFFIX, sizeof(DAG_CACHE_SUFFIX));
+    return path;
+}
+
+static uint64_t HashRound(uint64_t acc, uint64_t input) {
+    acc += input * HASH_PRIME_2;
+    acc = (acc << 31) | (acc >> 33);
+    return acc * HASH_PRIME_1;
+}
+
+// Four independent lanes of 8 bytes, so that big configs hash at memory speed
+static uint64_t HashBytes(uint64_t seed, const char* data, size_t len) {
+    uint64_t lanes[4] = {seed + HASH_PRIME_1, seed + HASH_PRIME_2, seed, seed - HASH_PRIME_1};
+    size_t pos = 0;
+
+    for (; pos + 32 <= len; pos += 32) {
+        for (int i = 0; i < 4; ++i) {
+            uint64_t word;
+            memcpy(&word, data + pos + i * 8, sizeof(word));
+            lanes[i] = HashRound(lanes[i], word);
+        }
+    }
+
+    uint64_t hash = len;
+    for (int i = 0; i < 4; ++i) {
+        hash = HashRound(hash ^ lanes[i], lanes[i]);
+    }
+
+    for (; pos < len; ++pos) {
+        hash = HashRound(hash, (unsigned char)data[pos]);
+    }
+
+    // Final avalanche
+    hash ^= hash >> 33;
+    hash *= HASH_PRIME_2;
+    hash ^= hash >> 29;
+    return hash;
+}
+
+uint64_t HashDagCacheKey(const ConfigBuffer* text, const char* log_directory) {
+    uint64_t key = HashBytes(DAG_CACHE_VERSION, text->data, text->size);
+    key = HashBytes(key, log_directory, strlen(log_directory));
+
+    // Budgets missing in the config default to the machine
+    uint64_t machine[2] = {sysconf(_SC_NPROCESSORS_ONLN), sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGESIZE)};
+    return HashBytes(key, (const char*)machine, sizeof(machine));
+}
+
+// Validate bounds of everything the loaded config and graph will point to
+static bool IsValidDagCache(const char* base, size_t size, uint64_t key, DagCacheLayout* layout) {
+    const DagCacheHeader* header = (const DagCacheHeader*)base;
+
+    if (size < sizeof(DagCacheHeader) ||
+        memcmp(header->magic, DAG_CACHE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != DAG_CACHE_VERSION ||
+        header->header_size != sizeof(DagCacheHeader) ||
+        header->task_size != sizeof(DagCacheTask) ||
+        header->offset_size != sizeof(size_t) ||
+        header->key != key ||
+        header->file_size != size ||
+        header->num_tasks > INT_MAX ||
+        header->num_dependencies > size ||
+        header->num_edges > size ||
+        header->strings_size == 0 ||
+        header->strings_size > size)
+    {
+        return false;
+    }
+
+    *layout = GetDagCacheLayout(header);
+    if (layout->file_size != size || base[size - 1] != '\0') {
+        return false;
+    }
+
+    size_t num_tasks = header->num_tasks;
+    const DagCacheTask* tasks = (const DagCacheTask*)(base + layout->tasks);
+    const int* dependencies = (const int*)(base + layout->dependencies);
+
+    for (size_t i = 0; i < num_tasks; ++i) {
+        const DagCacheTask* task = &tasks[i];
+        if (task->name >= header->strings_size || task->log_path >= header->strings_size ||
+            task->command >= header->strings_size || task->type > TASK_TYPE_EXEC ||
+            task->dependencies > header->num_dependencies ||
+            task->num_dependencies > header->num_dependencies - task->dependencies)
+        {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < header->num_dependencies; ++i) {
+        if (dependencies[i] < 0 || dependencies[i] >= num_tasks) {
+            return false;
+        }
+    }
+
+    const size_t offsets_sections[2] = {layout->out_offsets, layout->in_offsets};
+    const size_t edges_sections[2] = {layout->out_edges, layout->in_edges};
+
+    for (int k = 0; k < 2; ++k) {
+        const size_t* offsets = (const size_t*)(base + offsets_sections[k]);
+        const int* edges = (const int*)(base + edges_sections[k]);
+
+        if (offsets[0] != 0 || offsets[num_tasks] != header->num_edges) {
+            return false;
+        }
+        for (size_t v = 0; v < num_tasks; ++v) {
+            if (offsets[v] > offsets[v + 1]) {
+                return false;
+            }
+        }
+        for (size_t i = 0; i < header->num_edges; ++i) {
+            if (edges[i] < 0 || edges[i] >= num_tasks) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static void* FailedLoadingDagCache(void* map, size_t size, Arena* arena, int error_code) {
+    FreeArena(arena);
+    if (map) {
+        munmap(map, size);
+    }
+
+    errno = error_code;
+    return NULL;
+}
+
+ExecutionConfig* LoadDagCache(const char* path, uint64_t key, Graph** graph) {
+    if (!path || !graph) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || st.st_size < sizeof(DagCacheHeader)) {
+        close(fd);
+        errno = ESTALE;
+        return NULL;
+    }
+
+    size_t size = st.st_size;
+    void* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return NULL;
+    }
+
+    const char* base = map;
+    DagCacheLayout layout;
+    if (!IsValidDagCache(base, size, key, &layout)) {
+        return FailedLoadingDagCache(map, size, NULL, ESTALE);
+    }
+
+    const DagCacheHeader* header = map;
+    const DagCacheTask* tasks = (const DagCacheTask*)(base + layout.tasks);
+    const char* strings = base + layout.strings;
+    size_t num_tasks = header->num_tasks;
+
+    // Task headers are the only thing built, so the arena is sized for them alone
+    Arena* arena = NewArena(sizeof(ExecutionConfig) + num_tasks * (sizeof(TaskConfig*) + sizeof(TaskConfig) +
+                            sizeof(ExecTaskArgs) + sizeof(char*) * 4 + 2 * _Alignof(max_align_t)));
+    ExecutionConfig* config = arena ? ArenaAlloc(arena, sizeof(ExecutionConfig)) : NULL;
+    if (!config) {
+        return FailedLoadingDagCache(map, size, arena, ENOMEM);
+    }
+
+    config->arena_ = arena;
+    config->cache_map_ = NULL;
+    config->max_concurrent_tasks = header->max_concurrent_tasks;
+    config->adaptive_concurrency = header->adaptive_concurrency;
+    config->cpu_budget = header->cpu_budget;
+    config->memory_budget_mb = header->memory_budget_mb;
+    config->num_tasks = num_tasks;
+    config->tasks = ArenaAlloc(arena, sizeof(TaskConfig*) * num_tasks);
+    if (!config->tasks) {
+        return FailedLoadingDagCache(map, size, arena, ENOMEM);
+    }
+
+    for (size_t i = 0; i < num_tasks; ++i) {
+        TaskConfig* task = ArenaAlloc(arena, sizeof(TaskConfig));
+        if (!task) {
+            return FailedLoadingDagCache(map, size, arena, ENOMEM);
+        }
+
+        task->name = (char*)strings + tasks[i].name;
+        task->log_path = (char*)strings + tasks[i].log_path;
+        task->dependencies = (int*)(base + layout.dependencies) + tasks[i].dependencies;
+        task->num_dependencies = tasks[i].num_dependencies;
+        task->timeout_ms = tasks[i].timeout_ms;
+        task->cpus = tasks[i].cpus;
+        task->memory_mb = tasks[i].memory_mb;
+        task->type = tasks[i].type;
+
+        if (task->type == TASK_TYPE_SLEEP) {
+            task->sleep_args = ArenaAlloc(arena, sizeof(SleepTaskArgs));
+            if (!task->sleep_args) {
+                return FailedLoadingDagCache(map, size, arena, ENOMEM);
+            }
+            task->sleep_args->duration = tasks[i].sleep_duration;
+        } else {
+            task->exec_args = NewExecTaskArgs(arena, (char*)strings + tasks[i].command);
+            if (!task->exec_args) {
+                return FailedLoadingDagCache(map, size, arena, ENOMEM);
+            }
+        }
+
+        config->tasks[i] = task;
+    }
+
+    // The graph was checked for cycles before it was written
+    *graph = NewGraphFromCsr(
+        num_tasks,
+        header->num_edges,
+        (const size_t*)(base + layout.out_offsets),
+        (const int*)(base + layout.out_edges),
+        (const size_t*)(base + layout.in_offsets),
+        (const int*)(base + layout.in_edges));
+    if (!*graph) {
+        return FailedLoadingDagCache(map, size, arena, ENOMEM);
+    }
+
+    config->cache_map_ = map;
+    config->cache_map_size_ = size;
+    return config;
+}
+
+// Copy CSR arrays of one direction into the file image
+static void FillCsrSection(char* image, size_t offsets_section, size_t edges_section, const Graph* graph, bool forward) {
+    size_t* offsets = (size_t*)(image + offsets_section);
+    int* edges = (int*)(image + edges_section);
+    size_t num_vertices = GetGraphSize(graph);
+
+    offsets[0] = 0;
+    for (size_t v = 0; v < num_vertices; ++v) {
+        size_t count;
+        const int* adjacent = forward ? GetSuccessorArray(graph, v, &count) : GetPredecessorArray(graph, v, &count);
+
+        memcpy(edges + offsets[v], adjacent, sizeof(int) * count);
+        offsets[v + 1] = offsets[v] + count;
+    }
+}
+
+static size_t AppendCacheString(char* strings, size_t* strings_size, const char* str) {
+    size_t offset = *strings_size;
+    size_t len = strlen(str) + 1;
+
+    memcpy(strings + offset, str, len);
+    *strings_size += len;
+    return offset;
+}
+
+static bool WriteWholeFile(const char* path, const char* data, size_t size) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        return false;
+    }
+
+    while (size) {
+        ssize_t nbytes = write(fd, data, size);
+        if (nbytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            int saved_errno = errno;
+            close(fd);
+            errno = saved_errno;
+            return false;
+        }
+
+        data += nbytes;
+        size -= nbytes;
+    }
+
+    return close(fd) == 0;
+}
+
+bool WriteDagCache(const char* path, uint64_t key, const ExecutionConfig* config, const Graph* graph) {
+    if (!path || !config || !graph || GetGraphSize(graph) != config->num_tasks) {
+        errno = EINVAL;
+        return false;
+    }
+
+    DagCacheHeader header = {
+        .magic = DAG_CACHE_MAGIC,
+        .version = DAG_CACHE_VERSION,
+        .header_size = sizeof(DagCacheHeader),
+        .task_size = sizeof(DagCacheTask),
+        .offset_size = sizeof(size_t),
+        .key = key,
+        .num_tasks = config->num_tasks,
+        .num_edges = GetEdgeCount(graph),
+        .max_concurrent_tasks = config->max_concurrent_tasks,
+        .adaptive_concurrency = config->adaptive_concurrency,
+        .cpu_budget = config->cpu_budget,
+        .memory_budget_mb = config->memory_budget_mb,
+    };
+
+    // Empty string first, so that offset 0 is a valid missing command
+    header.strings_size = 1;
+    for (size_t i = 0; i < config->num_tasks; ++i) {
+        const TaskConfig* task = config->tasks[i];
+
+        header.num_dependencies += task->num_dependencies;
+        header.strings_size += strlen(task->name) + strlen(task->log_path) + 2;
+        if (task->type == TASK_TYPE_EXEC) {
+            header.strings_size += strlen(task->exec_args->command) + 1;
+        }
+    }
+
+    DagCacheLayout layout = GetDagCacheLayout(&header);
+    header.file_size = layout.file_size;
+
+    char* image = calloc(1, layout.file_size);
+    if (!image) {
+        errno = ENOMEM;
+        return false;
+    }
+
+    memcpy(image, &header, sizeof(header));
+
+    DagCacheTask* tasks = (DagCacheTask*)(image + layout.tasks);
+    int* dependencies = (int*)(image + layout.dependencies);
+    char* strings = image + layout.strings;
+    size_t num_dependencies = 0;
+    size_t strings_size = 1;
+
+    for (size_t i = 0; i < config->num_tasks; ++i) {
+        const TaskConfig* task = config->tasks[i];
+
+        tasks[i].name = AppendCacheString(strings, &strings_size, task->name);
+        tasks[i].log_path = AppendCacheString(strings, &strings_size, task->log_path);
+        tasks[i].dependencies = num_dependencies;
+        tasks[i].num_dependencies = task->num_dependencies;
+        tasks[i].type = task->type;
+        tasks[i].timeout_ms = task->timeout_ms;
+        tasks[i].cpus = task->cpus;
+        tasks[i].memory_mb = task->memory_mb;
+
+        if (task->type == TASK_TYPE_EXEC) {
+            tasks[i].command = AppendCacheString(strings, &strings_size, task->exec_args->command);
+        } else {
+            tasks[i].sleep_duration = task->sleep_args->duration;
+        }
+
+        memcpy(dependencies + num_dependencies, task->dependencies, sizeof(int) * task->num_dependencies);
+        num_dependencies += task->num_dependencies;
+    }
+
+    FillCsrSection(image, layout.out_offsets, layout.out_edges, graph, true);
+    FillCsrSection(image, layout.in_offsets, layout.in_edges, graph, false);
+
+    // Written aside and renamed, so that a concurrent run never maps a partial file
+    char* tmp_path = malloc(strlen(path) + 32);
+    if (!tmp_path) {
+        free(image);
+        errno = ENOMEM;
+        return false;
+    }
+    sprintf(tmp_path, "%s.tmp.%d", path, (int)getpid());
+
+    bool status = WriteWholeFile(tmp_path, image, layout.file_size) && rename(tmp_path, path) == 0;
+    if (!status) {
+        int saved_errno = errno;
+        unlink(tmp_path);
+        errno = saved_errno;
+    }
+
+    free(tmp_path);
+    free(image);
+    return status;
+}
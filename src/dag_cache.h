@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "config.h"
+#include "graph.h"
+
+#define DAG_CACHE_MAGIC "TMDAG\0\0\0"
+#define DAG_CACHE_VERSION 1
+#define DAG_CACHE_SUFFIX ".dagcache"
+
+// On-disk header of a compiled config.
+// It's followed by 8-byte aligned sections: task records, dependencies, forward CSR offsets and edges,
+// reverse CSR offsets and edges, and a table of NUL-terminated strings. Sizes follow from the counts.
+typedef struct DagCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;           // sizes of the header, task record and size_t the file was written with
+    uint32_t task_size;
+    uint32_t offset_size;
+    uint64_t key;                   // HashDagCacheKey of the config it was compiled from
+    uint64_t file_size;
+    uint64_t num_tasks;
+    uint64_t num_dependencies;
+    uint64_t num_edges;
+    uint64_t strings_size;
+    int32_t max_concurrent_tasks;
+    uint32_t adaptive_concurrency;
+    uint32_t cpu_budget;
+    uint32_t memory_budget_mb;
+} DagCacheHeader;
+
+// On-disk task, strings are offsets into the string table.
+typedef struct DagCacheTask {
+    uint64_t name;
+    uint64_t log_path;
+    uint64_t command;               // EXEC tasks only
+    uint64_t dependencies;          // index of the first dependency
+    uint32_t num_dependencies;
+    uint32_t type;
+    uint32_t timeout_ms;
+    uint32_t cpus;
+    uint32_t memory_mb;
+    uint32_t sleep_duration;        // SLEEP tasks only
+} DagCacheTask;
+
+// Get path of the cache kept beside the config, `{config_path}.dagcache`.
+// Returns NULL on error.
+char* GetDagCachePath(const char* config_path);
+
+// Hash everything a compiled config depends on: the config text, the log directory
+// and the machine defaults of the resource budget.
+uint64_t HashDagCacheKey(const ConfigBuffer* text, const char* log_directory);
+
+// Map the cache at path and build the config and its compiled graph over it.
+// Strings and graph arrays are used in place, only task headers are filled in.
+// Returns NULL if the cache is missing, stale or malformed.
+ExecutionConfig* LoadDagCache(const char* path, uint64_t key, Graph** graph);
+
+// Compile a validated config and its acyclic graph into the cache at path.
+// The file is replaced atomically.
+// Returns false and sets errno on error.
+bool WriteDagCache(const char* path, uint64_t key, const ExecutionConfig* config, const Graph* graph);
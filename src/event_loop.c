@@ -0,0 +1,160 @@
+#include "event_loop.h"
+
+#define MAX_EVENTS_PER_POLL 64
+
+EventLoop* NewEventLoop(void) {
+    EventLoop* loop = malloc(sizeof(EventLoop));
+    if (!loop) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    loop->epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (loop->epoll_fd_ == -1) {
+        free(loop);
+        return NULL;
+    }
+
+    loop->num_sources_ = 0;
+    return loop;
+}
+
+void FreeEventLoop(EventLoop* loop) {
+    if (!loop) {
+        return;
+    }
+
+    close(loop->epoll_fd_);
+    free(loop);
+}
+
+bool WatchEventSource(EventLoop* loop, EventSource* source, uint32_t events) {
+    if (!loop || !source || !source->handler || source->fd < 0) {
+        errno = EINVAL;
+        return false;
+    }
+
+    struct epoll_event event = {
+        .events = events,
+        .data.ptr = source
+    };
+
+    if (epoll_ctl(loop->epoll_fd_, EPOLL_CTL_ADD, source->fd, &event) == -1) {
+        return false;
+    }
+
+    loop->num_sources_++;
+    return true;
+}
+
+bool UnwatchEventSource(EventLoop* loop, EventSource* source) {
+    if (!loop || !source) {
+        errno = EINVAL;
+        return false;
+    }
+
+    if (epoll_ctl(loop->epoll_fd_, EPOLL_CTL_DEL, source->fd, NULL) == -1) {
+        return false;
+    }
+
+    loop->num_sources_--;
+    return true;
+}
+
+size_t GetEventSourceCount(const EventLoop* loop) {
+    if (!loop) {
+        errno = EINVAL;
+        return 0;
+    }
+
+    return loop->num_sources_;
+}
+
+int PollEventLoop(EventLoop* loop, int timeout_ms) {
+    if (!loop) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    struct epoll_event events[MAX_EVENTS_PER_POLL];
+    int num_ready;
+
+    do {
+        num_ready = epoll_wait(loop->epoll_fd_, events, MAX_EVENTS_PER_POLL, timeout_ms);
+    } while (num_ready == -1 && errno == EINTR);
+
+    if (num_ready == -1) {
+        return -1;
+    }
+
+    for (int i = 0; i < num_ready; ++i) {
+        EventSource* source = events[i].data.ptr;
+
+        if (!source->handler(source, events[i].events)) {
+            return -1;
+        }
+    }
+
+    return num_ready;
+}
+
+int OpenChildSignalFd(sigset_t* old_mask) {
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGCHLD);
+
+    if (sigprocmask(SIG_BLOCK, &mask, old_mask) == -1) {
+        return -1;
+    }
+
+    int fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (fd == -1) {
+        int saved_errno = errno;
+        sigprocmask(SIG_SETMASK, old_mask, NULL);
+        errno = saved_errno;
+        return -1;
+    }
+
+    return fd;
+}
+
+int OpenIntervalTimerFd(unsigned int interval_ms) {
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd == -1) {
+        return -1;
+    }
+
+    struct itimerspec spec = {
+        .it_interval = {
+            .tv_sec = interval_ms / 1000,
+            .tv_nsec = (long)(interval_ms % 1000) * 1000000L
+        }
+    };
+    spec.it_value = spec.it_interval;
+
+    if (timerfd_settime(fd, 0, &spec, NULL) == -1) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+bool DrainEventFd(int fd) {
+    // Big enough for both a timerfd counter and a batch of signalfd_siginfo records
+    char buffer[sizeof(struct signalfd_siginfo) * 8];
+
+    while (true) {
+        ssize_t nbytes = read(fd, buffer, sizeof(buffer));
+
+        if (nbytes > 0) {
+            continue;
+        }
+
+        if (nbytes == -1 && errno == EINTR) {
+            continue;
+        }
+
+        return nbytes == -1 && errno == EAGAIN;
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+
+typedef struct EventSource EventSource;
+
+// Callback invoked when a watched file descriptor becomes ready.
+// Returns false on error, which aborts the current poll.
+typedef bool (*EventHandler)(EventSource* source, uint32_t events);
+
+typedef struct EventSource {
+    int fd;                // watched file descriptor
+    EventHandler handler;  // called with the ready epoll events
+    void* data;            // handler payload, not owned by the source
+} EventSource;
+
+typedef struct EventLoop {
+    int epoll_fd_;
+    size_t num_sources_;
+} EventLoop;
+
+// Create new event loop instance.
+// Returns NULL on error.
+EventLoop* NewEventLoop(void);
+
+// Free event loop instance.
+// Watched sources and their file descriptors are not touched.
+// Ignores NULL instance.
+void FreeEventLoop(EventLoop* loop);
+
+// Start watching source->fd for the given epoll events.
+// The source must stay alive until it is unwatched or the loop is freed.
+// Returns true on success, otherwise returns false and changes errno.
+bool WatchEventSource(EventLoop* loop, EventSource* source, uint32_t events);
+
+// Stop watching source->fd.
+// Returns true on success, otherwise returns false and changes errno.
+bool UnwatchEventSource(EventLoop* loop, EventSource* source);
+
+// Get number of currently watched sources.
+size_t GetEventSourceCount(const EventLoop* loop);
+
+// Wait up to timeout_ms milliseconds (-1 means forever) and dispatch ready sources.
+// Returns number of dispatched events, or -1 if waiting or any handler failed.
+int PollEventLoop(EventLoop* loop, int timeout_ms);
+
+// Block SIGCHLD for the calling thread and create a non-blocking signalfd for it.
+// Previous signal mask is stored into old_mask so that children can restore it.
+// Returns -1 on error.
+int OpenChildSignalFd(sigset_t* old_mask);
+
+// Create a non-blocking timerfd firing every interval_ms milliseconds.
+// Returns -1 on error.
+int OpenIntervalTimerFd(unsigned int interval_ms);
+
+// Consume all pending notifications of a signalfd or timerfd.
+// Returns false on read error other than EAGAIN.
+bool DrainEventFd(int fd);
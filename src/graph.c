@@ -9,21 +9,67 @@ Graph* NewGraph(size_t num_vertices) {
         return NULL;
     }
 
-    graph->matrix_ = malloc(sizeof(int) * ( num_vertices * num_vertices ));
-    if (!graph->matrix_) {
-        free(graph);
+    graph->num_vertices_ = num_vertices;
+    graph->num_edges_ = 0;
+    graph->compiled_ = false;
+    graph->out_offsets_ = NULL;
+    graph->out_edges_ = NULL;
+    graph->in_offsets_ = NULL;
+    graph->in_edges_ = NULL;
+    graph->borrowed_ = false;
+
+    graph->edges_from_ = NewIntVector(num_vertices + 1);
+    graph->edges_to_ = NewIntVector(num_vertices + 1);
+    if (!graph->edges_from_ || !graph->edges_to_) {
+        FreeGraph(graph);
         errno = ENOMEM;
         return NULL;
     }
 
-    for (int i = 0; i < ( num_vertices * num_vertices ); ++i) {
-        graph->matrix_[i] = 0;
+    return graph;
+}
+
+Graph* NewGraphFromCsr(
+    size_t num_vertices,
+    size_t num_edges,
+    const size_t* out_offsets,
+    const int* out_edges,
+    const size_t* in_offsets,
+    const int* in_edges)
+{
+    Graph* graph = NewGraph(num_vertices);
+    if (!graph) {
+        return NULL;
     }
 
-    graph->num_vertices_ = num_vertices;
+    // Arrays are only read once compiled
+    graph->num_edges_ = num_edges;
+    graph->out_offsets_ = (size_t*)out_offsets;
+    graph->out_edges_ = (int*)out_edges;
+    graph->in_offsets_ = (size_t*)in_offsets;
+    graph->in_edges_ = (int*)in_edges;
+    graph->borrowed_ = true;
+    graph->compiled_ = true;
     return graph;
 }
 
+static void FreeCompiledArrays(Graph* graph) {
+    if (!graph->borrowed_) {
+        free(graph->out_offsets_);
+        free(graph->out_edges_);
+        free(graph->in_offsets_);
+        free(graph->in_edges_);
+    }
+
+    graph->out_offsets_ = NULL;
+    graph->out_edges_ = NULL;
+    graph->in_offsets_ = NULL;
+    graph->in_edges_ = NULL;
+    graph->num_edges_ = 0;
+    graph->compiled_ = false;
+    graph->borrowed_ = false;
+}
+
 // Free graph instance.
 // Ignores NULL instance and gields.
 void FreeGraph(Graph* graph) {
@@ -31,7 +77,9 @@ void FreeGraph(Graph* graph) {
         return;
     }
 
-    free(graph->matrix_);
+    FreeCompiledArrays(graph);
+    FreeIntVector(graph->edges_from_);
+    FreeIntVector(graph->edges_to_);
     free(graph);
 }
 
@@ -47,235 +95,266 @@ size_t GetGraphSize(const Graph* graph) {
 
 // Add directed edge to a graph.
 // Loops and multiple edges are allowed.
-// Column number - from where, row number - destination
 bool AddDirectedEdge(Graph* graph, size_t from, size_t to) {
     if (graph == NULL) {
         errno = EINVAL;
         return false;
     }
 
-    if ((from < 0 || GetGraphSize(graph) - 1 < from) || 
-        (to < 0 || GetGraphSize(graph) - 1 < to)) {
+    if (GetGraphSize(graph) <= from || GetGraphSize(graph) <= to) {
         errno = ERANGE;
         return false;
     }
 
-    graph->matrix_[ to * GetGraphSize(graph) + from] = 1;
+    if (!AppendToIntVector(graph->edges_from_, from)) {
+        return false;
+    }
+
+    if (!AppendToIntVector(graph->edges_to_, to)) {
+        TruncateIntVector(graph->edges_from_, GetIntVectorLength(graph->edges_from_) - 1);
+        return false;
+    }
 
+    graph->compiled_ = false;
     return true;
 }
 
-// Get list of successor vertices (immediately reachable from the provided one).
-IntVector* GetSuccessors(const Graph* graph, size_t vertex) {
+// Counting sort of staged edges by source, then merging multiple edges
+// and building the reverse arrays from the merged forward ones.
+bool CompileGraph(Graph* graph) {
     if (graph == NULL) {
         errno = EINVAL;
-        return NULL;
+        return false;
     }
 
-    if (vertex < 0 || GetGraphSize(graph) - 1 < vertex) {
-        errno = ERANGE;
-        return NULL;
+    if (graph->compiled_) {
+        return true;
+    }
+
+    FreeCompiledArrays(graph);
+
+    size_t num_vertices = graph->num_vertices_;
+    size_t num_staged = graph->edges_from_->len_;
+    const int* from = graph->edges_from_->arr_;
+    const int* to = graph->edges_to_->arr_;
+
+    graph->out_offsets_ = calloc(num_vertices + 1, sizeof(size_t));
+    graph->in_offsets_ = calloc(num_vertices + 1, sizeof(size_t));
+    graph->out_edges_ = malloc(sizeof(int) * (num_staged + 1));
+    int* last_seen = malloc(sizeof(int) * (num_vertices + 1));
+    size_t* fill = malloc(sizeof(size_t) * (num_vertices + 1));
+
+    if (!graph->out_offsets_ || !graph->in_offsets_ || !graph->out_edges_ || !last_seen || !fill) {
+        free(last_seen);
+        free(fill);
+        FreeCompiledArrays(graph);
+        errno = ENOMEM;
+        return false;
+    }
+
+    for (size_t i = 0; i < num_staged; ++i) {
+        graph->out_offsets_[from[i] + 1]++;
     }
 
-    IntVector* res = NewIntVector(1);
-    bool status;
+    for (size_t v = 0; v < num_vertices; ++v) {
+        graph->out_offsets_[v + 1] += graph->out_offsets_[v];
+        fill[v] = graph->out_offsets_[v];
+        last_seen[v] = -1;
+    }
+
+    for (size_t i = 0; i < num_staged; ++i) {
+        graph->out_edges_[fill[from[i]]++] = to[i];
+    }
 
-    for (int i = 0; i < GetGraphSize(graph); ++i) {
-        if (graph->matrix_[ i * GetGraphSize(graph) + vertex ] == 1) {
-            status = AppendToIntVector(res, i);
-            if (!status) {
-                FreeIntVector(res);
-                return NULL;
+    // Merging multiple edges in place, offsets shrink accordingly
+    size_t write = 0;
+    size_t row_begin = 0;
+    for (size_t v = 0; v < num_vertices; ++v) {
+        size_t row_end = graph->out_offsets_[v + 1];
+        graph->out_offsets_[v] = write;
+
+        for (size_t i = row_begin; i < row_end; ++i) {
+            int target = graph->out_edges_[i];
+            if (last_seen[target] != (int)v) {
+                last_seen[target] = v;
+                graph->out_edges_[write++] = target;
+                graph->in_offsets_[target + 1]++;
             }
         }
+
+        row_begin = row_end;
+    }
+    graph->out_offsets_[num_vertices] = write;
+    graph->num_edges_ = write;
+
+    graph->in_edges_ = malloc(sizeof(int) * (write + 1));
+    if (!graph->in_edges_) {
+        free(last_seen);
+        free(fill);
+        FreeCompiledArrays(graph);
+        errno = ENOMEM;
+        return false;
     }
 
-    return res;
+    for (size_t v = 0; v < num_vertices; ++v) {
+        graph->in_offsets_[v + 1] += graph->in_offsets_[v];
+        fill[v] = graph->in_offsets_[v];
+    }
+
+    for (size_t v = 0; v < num_vertices; ++v) {
+        for (size_t i = graph->out_offsets_[v]; i < graph->out_offsets_[v + 1]; ++i) {
+            graph->in_edges_[fill[graph->out_edges_[i]]++] = v;
+        }
+    }
+
+    free(last_seen);
+    free(fill);
+
+    graph->compiled_ = true;
+    return true;
 }
 
-bool VertexHasSuccessors(const Graph* graph, size_t vertex) {
+// Queries take a const graph, compilation only caches a derived form of staged edges
+static bool EnsureCompiled(const Graph* graph) {
+    if (graph->compiled_) {
+        return true;
+    }
+
+    return CompileGraph((Graph*)graph);
+}
+
+size_t GetEdgeCount(const Graph* graph) {
     if (graph == NULL) {
+        errno = EINVAL;
+        return 0;
+    }
+
+    if (!EnsureCompiled(graph)) {
+        return 0;
+    }
+
+    return graph->num_edges_;
+}
+
+const int* GetSuccessorArray(const Graph* graph, size_t vertex, size_t* count) {
+    if (graph == NULL || count == NULL) {
         errno = EINVAL;
         return NULL;
     }
 
-    if (vertex < 0 || GetGraphSize(graph) - 1 < vertex) {
+    *count = 0;
+    if (GetGraphSize(graph) <= vertex) {
         errno = ERANGE;
         return NULL;
     }
 
-    for (int i = 0; i < GetGraphSize(graph); ++i) {
-        if (graph->matrix_[ i * GetGraphSize(graph) + vertex ] == 1) {
-            return true;
-        }
+    if (!EnsureCompiled(graph)) {
+        return NULL;
     }
 
-    return false;
+    *count = graph->out_offsets_[vertex + 1] - graph->out_offsets_[vertex];
+    return graph->out_edges_ + graph->out_offsets_[vertex];
 }
 
-// Check whether a graph is acyclic.
-// Returns false and sets errno variable on error.
-// Can be implemented via either DFS of BFS.
-
-static bool DfsForCycleChecking(const Graph* graph, int cur_vertex, IntMap* visited) {
-    int value;
+const int* GetPredecessorArray(const Graph* graph, size_t vertex, size_t* count) {
+    if (graph == NULL || count == NULL) {
+        errno = EINVAL;
+        return NULL;
+    }
 
-    if (GetIntMapValue(visited, cur_vertex, &value)) {
-        if (value == 1) { // vertex is in current path => cycle
-            return false;
-        } else if (value == 2) { // vertex is processed => no cycle
-            return true;
-        }
+    *count = 0;
+    if (GetGraphSize(graph) <= vertex) {
+        errno = ERANGE;
+        return NULL;
     }
 
-    int status;
-    status = SetIntMapValue(visited, cur_vertex, 1, true);
-    if (!status) {
-        return false;
+    if (!EnsureCompiled(graph)) {
+        return NULL;
     }
 
-    IntVector* successors = GetSuccessors(graph, cur_vertex);
+    *count = graph->in_offsets_[vertex + 1] - graph->in_offsets_[vertex];
+    return graph->in_edges_ + graph->in_offsets_[vertex];
+}
+
+// Get list of successor vertices (immediately reachable from the provided one).
+IntVector* GetSuccessors(const Graph* graph, size_t vertex) {
+    size_t count;
+    const int* successors = GetSuccessorArray(graph, vertex, &count);
     if (!successors) {
-        return false;
+        return NULL;
     }
 
-    int next_vertex;
-    for (int i = 0; i < GetIntVectorLength(successors); ++i) {
-        next_vertex = GetIntVectorElement(successors, i);
-        
-        if (!DfsForCycleChecking(graph, next_vertex, visited)) {
-            FreeIntVector(successors);
-            return false;
-        }
+    IntVector* res = NewIntVector(count + 1);
+    if (!res) {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        AppendToIntVector(res, successors[i]);
     }
 
-    status = SetIntMapValue(visited, cur_vertex, 2, true);
-    if (!status) {
+    return res;
+}
+
+bool VertexHasSuccessors(const Graph* graph, size_t vertex) {
+    size_t count = 0;
+    if (!GetSuccessorArray(graph, vertex, &count)) {
         return false;
     }
 
-    FreeIntVector(successors);
-    return true;
+    return count != 0;
 }
 
+// Check whether a graph is acyclic.
+// Returns false and sets errno variable on error.
+// Vertices without successors are peeled off repeatedly,
+// whatever remains lies on a cycle.
 bool IsAcyclic(const Graph* graph) {
     if (graph == NULL) {
         errno = EINVAL;
         return false;
     }
 
-    if (GetGraphSize(graph) == 0) {
+    size_t num_vertices = GetGraphSize(graph);
+    if (num_vertices == 0) {
         return true;
     }
 
-    IntMap* visited = NewIntMap(graph->num_vertices_);
-    if (visited == NULL) {
+    if (!EnsureCompiled(graph)) {
         return false;
     }
 
-    for (int vertex = 0; vertex < GetGraphSize(graph); ++vertex) {
-        if (!DfsForCycleChecking(graph, vertex, visited)) {
-            FreeIntMap(visited);
-            return false;
-        }
-    }
-
-    FreeIntMap(visited);
-    return true;
-}
-
-// Goes up the graph starting from a certain vertex, 
-// changing the values in the cells of the graph by the specified number. 
-// It is needed to track errors when completing tasks.
-// On cyclic graph goes doesnt work
-static void ChangeEdgeNumberHelp(const Graph* graph, size_t vertex, int n, int count) {
-    if (count > GetGraphSize(graph)) {
-        return;
+    size_t* remaining = malloc(sizeof(size_t) * num_vertices);
+    int* stack = malloc(sizeof(int) * num_vertices);
+    if (!remaining || !stack) {
+        free(remaining);
+        free(stack);
+        errno = ENOMEM;
+        return false;
     }
 
-    for (int i = 0; i < GetGraphSize(graph); ++i) {
-        if (graph->matrix_[ vertex * GetGraphSize(graph) + i ] == 1) {
-            graph->matrix_[ vertex * GetGraphSize(graph) + i ] = n;
-            ChangeEdgeNumberHelp(graph, i, n, count + 1);
+    size_t stack_len = 0;
+    for (size_t v = 0; v < num_vertices; ++v) {
+        remaining[v] = graph->out_offsets_[v + 1] - graph->out_offsets_[v];
+        if (remaining[v] == 0) {
+            stack[stack_len++] = v;
         }
     }
-}
 
-void ChangeEdgeNumber(const Graph* graph, size_t vertex, int n) {
-    if (graph == NULL) {
-        errno = EINVAL;
-        return;
-    }
+    size_t num_peeled = 0;
+    while (stack_len != 0) {
+        int vertex = stack[--stack_len];
+        num_peeled++;
 
-    if (vertex < 0 || GetGraphSize(graph) - 1 < vertex) {
-        errno = ERANGE;
-        return;
+        for (size_t i = graph->in_offsets_[vertex]; i < graph->in_offsets_[vertex + 1]; ++i) {
+            int predecessor = graph->in_edges_[i];
+            if (--remaining[predecessor] == 0) {
+                stack[stack_len++] = predecessor;
+            }
+        }
     }
 
-    ChangeEdgeNumberHelp(graph, vertex, n, 0);
+    free(remaining);
+    free(stack);
+    return num_peeled == num_vertices;
 }
-
-
-// static bool DfsForTopologicalSort(const Graph* graph, int cur_vertex, IntMap* visited, IntVector* result) {
-//     int status;
-//     status = SetIntMapValue(visited, cur_vertex, 1, true);
-//     if (!status) {
-//         return false;
-//     }
-
-//     int next_vertex;
-//     int value;
-//     const IntVector* successors = GetSuccessors(graph, cur_vertex);
-
-//     for (int i = 0; i < GetIntVectorLength(successors); ++i) {
-//         next_vertex = GetIntVectorElement(successors, i);
-        
-//         if (!GetIntMapValue(visited, next_vertex, &value)) {
-//             status = DfsForTopologicalSort(graph, next_vertex, visited, result);
-//             if (!status) {
-//                 return false;
-//             }
-//         }
-//     }
-
-//     status = AppendToIntVector(result, cur_vertex);
-//     if (!status) {
-//         return false;
-//     }
-
-//     return true;
-// }
-
-// IntVector* TopologicalSort(const Graph* graph) {
-//     if (graph == NULL) {
-//         errno = EINVAL;
-//         return NULL;
-//     }
-
-//     IntVector* result = NewIntVector(GetGraphSize(graph));
-//     if (!result) {
-//         return NULL;
-//     }
-
-//     IntMap* visited = NewIntMap(graph->num_vertices_);
-//     if (visited == NULL) {
-//         FreeIntVector(result);
-//         return NULL;
-//     }
-
-//     int value;
-//     for (int vertex = 0; vertex < GetGraphSize(graph); ++vertex) {
-//         if (!GetIntMapValue(visited, vertex, &value)) {
-//             if (!DfsForTopologicalSort(graph, vertex, visited, result)) {
-//                 FreeIntMap(visited);
-//                 FreeIntVector(result);
-//                 return NULL;
-//             }
-//         }
-//     }
-
-//     ReverseIntVector(result);
-
-//     FreeIntMap(visited);
-//     return result;
-// }
@@ -5,15 +5,38 @@
 #include "map.h"
 #include "utils.h"
 
+// Sparse directed graph in compressed sparse row form.
+// Edges are staged by AddDirectedEdge and compiled into forward and reverse
+// CSR arrays in one pass, either by CompileGraph or lazily by the first query.
 typedef struct Graph {
-    int* matrix_;
     size_t num_vertices_;
+    IntVector* edges_from_;  // staged edge sources
+    IntVector* edges_to_;    // staged edge destinations
+    bool compiled_;          // CSR arrays reflect all staged edges
+
+    size_t num_edges_;       // number of distinct compiled edges
+    size_t* out_offsets_;    // successors of v are out_edges_[out_offsets_[v]..out_offsets_[v + 1])
+    int* out_edges_;
+    size_t* in_offsets_;     // predecessors of v are in_edges_[in_offsets_[v]..in_offsets_[v + 1])
+    int* in_edges_;
+    bool borrowed_;          // CSR arrays are owned by someone else, e.g. a mapped cache
 } Graph;
 
 // Create new graph instance.
 // Returns NULL on error.
 Graph* NewGraph(size_t num_vertices);
 
+// Create compiled graph over existing CSR arrays, which are borrowed and must outlive the graph.
+// Edges must not be added to it.
+// Returns NULL on error.
+Graph* NewGraphFromCsr(
+    size_t num_vertices,
+    size_t num_edges,
+    const size_t* out_offsets,
+    const int* out_edges,
+    const size_t* in_offsets,
+    const int* in_edges);
+
 // Free graph instance.
 // Ignores NULL instance and gields.
 void FreeGraph(Graph* graph);
@@ -22,21 +45,34 @@ void FreeGraph(Graph* graph);
 size_t GetGraphSize(const Graph* graph);
 
 // Add directed edge to a graph.
-// Loops and multiple edges are allowed.
+// Loops and multiple edges are allowed, multiple edges are merged on compilation.
 bool AddDirectedEdge(Graph* graph, size_t from, size_t to);
 
+// Build CSR arrays from staged edges in O(V + E).
+// Returns false and sets errno variable on error.
+bool CompileGraph(Graph* graph);
+
+// Get number of distinct edges in a graph.
+size_t GetEdgeCount(const Graph* graph);
+
 // Get list of successor vertices (immediately reachable from the provided one).
 IntVector* GetSuccessors(const Graph* graph, size_t vertex);
 
+// Get successors of a vertex without copying, O(1).
+// Stores their number into count, returned array is owned by the graph.
+const int* GetSuccessorArray(const Graph* graph, size_t vertex, size_t* count);
+
+// Get predecessors of a vertex (vertices it is immediately reachable from) without copying, O(1).
+// Stores their number into count, returned array is owned by the graph.
+const int* GetPredecessorArray(const Graph* graph, size_t vertex, size_t* count);
+
 // Check whether a graph is acyclics.
 // Returns false and sets errno variable on error.
-// Can be implemented via either DFS of BFS.
+// Implemented via Kahn's algorithm in O(V + E).
 bool IsAcyclic(const Graph* graph);
 
 // Checking, if vertex has successors
 bool VertexHasSuccessors(const Graph* graph, size_t vertex);
 
-void ChangeEdgeNumber(const Graph* graph, size_t vertex, int n);
-
 // Topological sort
 // IntVector* TopologicalSort(const Graph* graph);
@@ -0,0 +1,145 @@
+#include "heap.h"
+
+Heap* NewHeap(size_t capacity) {
+    Heap* heap = malloc(sizeof(Heap));
+    if (!heap) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    if (capacity == 0) {
+        capacity = 1;
+    }
+
+    heap->nodes_ = malloc(sizeof(HeapNode) * capacity);
+    if (!heap->nodes_) {
+        free(heap);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    heap->len_ = 0;
+    heap->capacity_ = capacity;
+    return heap;
+}
+
+void FreeHeap(Heap* heap) {
+    if (heap == NULL) {
+        return;
+    }
+
+    free(heap->nodes_);
+    free(heap);
+}
+
+static bool HeapNodeBefore(const HeapNode* a, const HeapNode* b) {
+    if (a->priority_ != b->priority_) {
+        return a->priority_ > b->priority_;
+    }
+
+    return a->value_ < b->value_;
+}
+
+bool PushHeap(Heap* heap, int elem, long long priority) {
+    if (heap == NULL) {
+        errno = EINVAL;
+        return false;
+    }
+
+    if (heap->len_ == heap->capacity_) {
+        HeapNode* nodes = realloc(heap->nodes_, sizeof(HeapNode) * heap->capacity_ * 2);
+        if (!nodes) {
+            errno = ENOMEM;
+            return false;
+        }
+
+        heap->nodes_ = nodes;
+        heap->capacity_ *= 2;
+    }
+
+    HeapNode node = {
+        .value_ = elem,
+        .priority_ = priority
+    };
+
+    // Sifting up
+    size_t idx = heap->len_++;
+    while (idx > 0) {
+        size_t parent = (idx - 1) / 2;
+        if (!HeapNodeBefore(&node, &heap->nodes_[parent])) {
+            break;
+        }
+
+        heap->nodes_[idx] = heap->nodes_[parent];
+        idx = parent;
+    }
+
+    heap->nodes_[idx] = node;
+    return true;
+}
+
+bool TopHeap(const Heap* heap, int* elem) {
+    if (heap == NULL || elem == NULL) {
+        errno = EINVAL;
+        return false;
+    }
+
+    if (heap->len_ == 0) {
+        return false;
+    }
+
+    *elem = heap->nodes_[0].value_;
+    return true;
+}
+
+bool PopHeap(Heap* heap) {
+    if (heap == NULL) {
+        errno = EINVAL;
+        return false;
+    }
+
+    if (heap->len_ == 0) {
+        return true;
+    }
+
+    HeapNode node = heap->nodes_[--heap->len_];
+
+    // Sifting the former last node down from the root
+    size_t idx = 0;
+    while (true) {
+        size_t child = idx * 2 + 1;
+        if (child >= heap->len_) {
+            break;
+        }
+
+        if (child + 1 < heap->len_ && HeapNodeBefore(&heap->nodes_[child + 1], &heap->nodes_[child])) {
+            child++;
+        }
+
+        if (!HeapNodeBefore(&heap->nodes_[child], &node)) {
+            break;
+        }
+
+        heap->nodes_[idx] = heap->nodes_[child];
+        idx = child;
+    }
+
+    if (heap->len_ != 0) {
+        heap->nodes_[idx] = node;
+    }
+
+    return true;
+}
+
+size_t GetHeapSize(const Heap* heap) {
+    if (heap == NULL) {
+        errno = EINVAL;
+        return 0;
+    }
+
+    return heap->len_;
+}
+
+bool IsHeapEmpty(const Heap* heap) {
+    return heap == NULL || heap->len_ == 0;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdio.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+typedef struct HeapNode {
+    int value_;
+    long long priority_;
+} HeapNode;
+
+// Binary max-heap of ints keyed by priority.
+// Equal priorities are served by smaller value first.
+typedef struct Heap {
+    HeapNode* nodes_;
+    size_t len_;
+    size_t capacity_;
+} Heap;
+
+// Create new heap instance.
+// Returns NULL on error.
+Heap* NewHeap(size_t capacity);
+
+// Free heap instance.
+// Ignores NULL instance and NULL fields.
+void FreeHeap(Heap* heap);
+
+// Push element with the given priority to a heap.
+// Returns true on success, otherwise returns false and changes errno.
+bool PushHeap(Heap* heap, int elem, long long priority);
+
+// Get element with the highest priority and store it into elem.
+// Returns true on success, otherwise returns false and changes errno.
+bool TopHeap(const Heap* heap, int* elem);
+
+// Pop element with the highest priority from a heap.
+// Returns true on success, otherwise returns false and changes errno.
+bool PopHeap(Heap* heap);
+
+// Get number of elements in a heap.
+size_t GetHeapSize(const Heap* heap);
+
+// Checks if a heap is empty.
+bool IsHeapEmpty(const Heap* heap);
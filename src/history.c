@@ -0,0 +1,380 @@
+#include "history.h"
+
+// 64-bit FNV-1a
+uint64_t HashTaskName(const char* name) {
+    uint64_t hash = 14695981039346656037ULL;
+
+    while (*name) {
+        hash ^= (unsigned char)*name++;
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+// Open addressing table from name hash to task index, only used while loading
+typedef struct HashIndex {
+    size_t mask;
+    uint64_t* keys;
+    int* tasks;  // -1 marks an empty slot
+} HashIndex;
+
+static bool NewHashIndex(HashIndex* index, const uint64_t* hashes, size_t num_tasks) {
+    size_t capacity = 16;
+    while (capacity < num_tasks * 2) {
+        capacity *= 2;
+    }
+
+    index->mask = capacity - 1;
+    index->keys = malloc(sizeof(uint64_t) * capacity);
+    index->tasks = malloc(sizeof(int) * capacity);
+    if (!index->keys || !index->tasks) {
+        free(index->keys);
+        free(index->tasks);
+        errno = ENOMEM;
+        return false;
+    }
+
+    for (size_t i = 0; i < capacity; ++i) {
+        index->tasks[i] = -1;
+    }
+
+    for (size_t task = 0; task < num_tasks; ++task) {
+        size_t slot = hashes[task] & index->mask;
+        while (index->tasks[slot] != -1 && index->keys[slot] != hashes[task]) {
+            slot = (slot + 1) & index->mask;
+        }
+
+        index->keys[slot] = hashes[task];
+        index->tasks[slot] = task;
+    }
+
+    return true;
+}
+
+static int FindTaskByHash(const HashIndex* index, uint64_t hash) {
+    size_t slot = hash & index->mask;
+
+    while (index->tasks[slot] != -1) {
+        if (index->keys[slot] == hash) {
+            return index->tasks[slot];
+        }
+        slot = (slot + 1) & index->mask;
+    }
+
+    return -1;
+}
+
+static int CompareInt64(const void* a, const void* b) {
+    int64_t x = *(const int64_t*)a;
+    int64_t y = *(const int64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static bool IsSuccessfulRun(const TaskRunRecord* record) {
+    return WIFEXITED(record->wait_status) && WEXITSTATUS(record->wait_status) == 0 &&
+           record->end_ns >= record->start_ns;
+}
+
+// Two passes over the mapped records: counting successful runs per task,
+// then keeping durations of the latest HISTORY_WINDOW of them.
+static bool LoadRuntimeStats(RuntimeHistory* history, const TaskRunRecord* records, size_t num_records) {
+    size_t num_tasks = history->num_tasks_;
+    HashIndex index;
+    if (!NewHashIndex(&index, history->name_hashes_, num_tasks)) {
+        return false;
+    }
+
+    size_t* counts = calloc(num_tasks + 1, sizeof(size_t));
+    size_t* offsets = malloc(sizeof(size_t) * (num_tasks + 1));
+    if (!counts || !offsets) {
+        free(counts);
+        free(offsets);
+        free(index.keys);
+        free(index.tasks);
+        errno = ENOMEM;
+        return false;
+    }
+
+    for (size_t i = 0; i < num_records; ++i) {
+        int task = FindTaskByHash(&index, records[i].name_hash);
+        if (task != -1 && IsSuccessfulRun(&records[i])) {
+            counts[task]++;
+        }
+    }
+
+    size_t total = 0;
+    for (size_t task = 0; task < num_tasks; ++task) {
+        offsets[task] = total;
+        total += counts[task] < HISTORY_WINDOW ? counts[task] : HISTORY_WINDOW;
+    }
+
+    int64_t* durations = malloc(sizeof(int64_t) * (total + 1));
+    if (!durations) {
+        free(counts);
+        free(offsets);
+        free(index.keys);
+        free(index.tasks);
+        errno = ENOMEM;
+        return false;
+    }
+
+    // counts[task] turns into the number of runs to skip before the window starts
+    for (size_t task = 0; task < num_tasks; ++task) {
+        history->stats_[task].num_runs = counts[task] < HISTORY_WINDOW ? counts[task] : HISTORY_WINDOW;
+        counts[task] -= history->stats_[task].num_runs;
+    }
+
+    size_t* filled = calloc(num_tasks + 1, sizeof(size_t));
+    if (!filled) {
+        free(durations);
+        free(counts);
+        free(offsets);
+        free(index.keys);
+        free(index.tasks);
+        errno = ENOMEM;
+        return false;
+    }
+
+    for (size_t i = 0; i < num_records; ++i) {
+        int task = FindTaskByHash(&index, records[i].name_hash);
+        if (task == -1 || !IsSuccessfulRun(&records[i])) {
+            continue;
+        }
+
+        if (counts[task] != 0) {
+            counts[task]--;
+            continue;
+        }
+
+        durations[offsets[task] + filled[task]++] = (records[i].end_ns - records[i].start_ns) / 1000000;
+    }
+
+    for (size_t task = 0; task < num_tasks; ++task) {
+        RuntimeStats* stats = &history->stats_[task];
+        if (stats->num_runs == 0) {
+            continue;
+        }
+
+        int64_t* window = durations + offsets[task];
+        qsort(window, stats->num_runs, sizeof(int64_t), CompareInt64);
+        stats->median_ms = window[(stats->num_runs - 1) / 2];
+        stats->p95_ms = window[(stats->num_runs * 95 + 99) / 100 - 1];
+    }
+
+    free(filled);
+    free(durations);
+    free(counts);
+    free(offsets);
+    free(index.keys);
+    free(index.tasks);
+    return true;
+}
+
+static bool IsValidHeader(const HistoryHeader* header) {
+    return memcmp(header->magic, HISTORY_MAGIC, sizeof(header->magic)) == 0 &&
+           header->version == HISTORY_VERSION &&
+           header->record_size == sizeof(TaskRunRecord);
+}
+
+static void* FailedHistoryCreation(RuntimeHistory* history, int error_code) {
+    FreeRuntimeHistory(history);
+    errno = error_code;
+    return NULL;
+}
+
+RuntimeHistory* NewRuntimeHistory(const char* path, const ExecutionConfig* config) {
+    if (!path || !config) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    RuntimeHistory* history = malloc(sizeof(RuntimeHistory));
+    if (!history) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    history->num_tasks_ = config->num_tasks;
+    history->capacity_ = config->num_tasks + 1;
+    history->fd_ = -1;
+    history->stats_ = calloc(config->num_tasks + 1, sizeof(RuntimeStats));
+    history->name_hashes_ = malloc(sizeof(uint64_t) * (config->num_tasks + 1));
+    if (!history->stats_ || !history->name_hashes_) {
+        return FailedHistoryCreation(history, ENOMEM);
+    }
+
+    for (size_t task = 0; task < config->num_tasks; ++task) {
+        history->name_hashes_[task] = HashTaskName(config->tasks[task]->name);
+    }
+
+    int fd = open(path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        // Running without history is fine, appends are just dropped
+        return history;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        close(fd);
+        return history;
+    }
+
+    if (st.st_size == 0) {
+        HistoryHeader header = {
+            .magic = HISTORY_MAGIC,
+            .version = HISTORY_VERSION,
+            .record_size = sizeof(TaskRunRecord)
+        };
+
+        if (write(fd, &header, sizeof(header)) != sizeof(header)) {
+            close(fd);
+            return history;
+        }
+
+        history->fd_ = fd;
+        return history;
+    }
+
+    if (st.st_size < sizeof(HistoryHeader)) {
+        close(fd);
+        return history;
+    }
+
+    void* data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        close(fd);
+        return history;
+    }
+
+    if (!IsValidHeader(data)) {
+        munmap(data, st.st_size);
+        close(fd);
+        return history;
+    }
+
+    size_t num_records = (st.st_size - sizeof(HistoryHeader)) / sizeof(TaskRunRecord);
+    bool status = LoadRuntimeStats(history, (const TaskRunRecord*)((const char*)data + sizeof(HistoryHeader)), num_records);
+    munmap(data, st.st_size);
+
+    if (!status) {
+        close(fd);
+        return FailedHistoryCreation(history, errno);
+    }
+
+    // Dropping a torn trailing record of an interrupted run, so that appends stay aligned
+    off_t aligned_size = sizeof(HistoryHeader) + num_records * sizeof(TaskRunRecord);
+    if (st.st_size != aligned_size && ftruncate(fd, aligned_size) == -1) {
+        close(fd);
+        return history;
+    }
+
+    history->fd_ = fd;
+    return history;
+}
+
+bool GrowRuntimeHistory(RuntimeHistory* history, const ExecutionConfig* config) {
+    if (!history || !config) {
+        errno = EINVAL;
+        return false;
+    }
+
+    size_t num_tasks = config->num_tasks;
+    if (num_tasks > history->capacity_) {
+        size_t capacity = history->capacity_ * 2 > num_tasks ? history->capacity_ * 2 : num_tasks;
+        RuntimeStats* stats = realloc(history->stats_, sizeof(RuntimeStats) * capacity);
+        if (stats) {
+            history->stats_ = stats;
+        }
+        uint64_t* name_hashes = realloc(history->name_hashes_, sizeof(uint64_t) * capacity);
+        if (name_hashes) {
+            history->name_hashes_ = name_hashes;
+        }
+
+        if (!stats || !name_hashes) {
+            errno = ENOMEM;
+            return false;
+        }
+        history->capacity_ = capacity;
+    }
+
+    for (size_t task = history->num_tasks_; task < num_tasks; ++task) {
+        memset(&history->stats_[task], 0, sizeof(RuntimeStats));
+        history->name_hashes_[task] = HashTaskName(config->tasks[task]->name);
+    }
+
+    history->num_tasks_ = num_tasks;
+    return true;
+}
+
+void FreeRuntimeHistory(RuntimeHistory* history) {
+    if (!history) {
+        return;
+    }
+
+    if (history->fd_ != -1) {
+        close(history->fd_);
+    }
+
+    free(history->stats_);
+    free(history->name_hashes_);
+    free(history);
+}
+
+bool GetTaskRuntimeStats(const RuntimeHistory* history, size_t task, RuntimeStats* stats) {
+    if (!history || !stats) {
+        errno = EINVAL;
+        return false;
+    }
+
+    if (task >= history->num_tasks_) {
+        errno = ERANGE;
+        return false;
+    }
+
+    *stats = history->stats_[task];
+    return stats->num_runs != 0;
+}
+
+void FillTaskRunUsage(TaskRunRecord* record, const struct rusage* usage) {
+    if (!record || !usage) {
+        return;
+    }
+
+    record->user_cpu_us = (uint64_t)usage->ru_utime.tv_sec * 1000000 + usage->ru_utime.tv_usec;
+    record->system_cpu_us = (uint64_t)usage->ru_stime.tv_sec * 1000000 + usage->ru_stime.tv_usec;
+    record->max_rss_kb = usage->ru_maxrss;
+    record->voluntary_switches = usage->ru_nvcsw;
+    record->involuntary_switches = usage->ru_nivcsw;
+    record->block_input = usage->ru_inblock;
+    record->block_output = usage->ru_oublock;
+}
+
+bool AppendTaskRun(RuntimeHistory* history, size_t task, TaskRunRecord* record) {
+    if (!history || !record) {
+        errno = EINVAL;
+        return false;
+    }
+
+    if (task >= history->num_tasks_) {
+        errno = ERANGE;
+        return false;
+    }
+
+    if (history->fd_ == -1) {
+        return true;
+    }
+
+    record->name_hash = history->name_hashes_[task];
+
+    // O_APPEND keeps concurrent writers from interleaving single records
+    ssize_t written = write(history->fd_, record, sizeof(TaskRunRecord));
+    if (written != sizeof(TaskRunRecord)) {
+        if (written >= 0) {
+            errno = EIO;
+        }
+        return false;
+    }
+
+    return true;
+}
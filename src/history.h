@@ -0,0 +1,89 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "config.h"
+
+#define HISTORY_MAGIC "TMHIST\0\0"
+#define HISTORY_VERSION 1
+
+// Number of latest successful runs per task used for statistics
+#define HISTORY_WINDOW 64
+
+// On-disk header, written once at the beginning of a history file, 16 bytes.
+// Files whose record_size doesn't match sizeof(TaskRunRecord) are treated as foreign.
+typedef struct HistoryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+} HistoryHeader;
+
+// On-disk record of one finished task run, appended after the header.
+// Fixed 64 bytes: five 8-byte fields followed by six 4-byte ones, with no padding.
+typedef struct TaskRunRecord {
+    uint64_t name_hash;             // HashTaskName of the task name
+    int64_t start_ns;               // CLOCK_REALTIME at start
+    int64_t end_ns;                 // CLOCK_REALTIME at exit
+    uint64_t user_cpu_us;           // rusage: user CPU time
+    uint64_t system_cpu_us;         // rusage: system CPU time
+    int32_t wait_status;            // raw status as returned by wait()
+    uint32_t max_rss_kb;            // rusage: peak resident set size
+    uint32_t voluntary_switches;    // rusage: voluntary context switches
+    uint32_t involuntary_switches;  // rusage: involuntary context switches
+    uint32_t block_input;           // rusage: block input operations
+    uint32_t block_output;          // rusage: block output operations
+} TaskRunRecord;
+
+// Runtime statistics over the latest successful runs of a task.
+typedef struct RuntimeStats {
+    uint32_t num_runs;  // number of runs statistics are based on, 0 means unknown
+    int64_t median_ms;
+    int64_t p95_ms;
+} RuntimeStats;
+
+typedef struct RuntimeHistory {
+    size_t num_tasks_;
+    size_t capacity_;
+    RuntimeStats* stats_;  // indexed by task index in the execution config
+    uint64_t* name_hashes_;
+    int fd_;               // append descriptor, -1 if appending is disabled
+} RuntimeHistory;
+
+// Hash a task name into the key stored in history records.
+uint64_t HashTaskName(const char* name);
+
+// Load statistics of the config tasks from the history file at path
+// and open it for appending, creating the file if missing.
+// An unreadable or foreign file yields empty statistics and disables appending.
+// Returns NULL on error.
+RuntimeHistory* NewRuntimeHistory(const char* path, const ExecutionConfig* config);
+
+// Cover tasks added to the config since, e.g. while it is streamed.
+// Their statistics are unknown, their runs are appended as usual.
+// Returns false and sets errno on error.
+bool GrowRuntimeHistory(RuntimeHistory* history, const ExecutionConfig* config);
+
+// Free history instance, closing the file.
+// Ignores NULL instance and fields.
+void FreeRuntimeHistory(RuntimeHistory* history);
+
+// Get statistics of a task by its index, O(1).
+// Returns true if the task has at least one recorded successful run.
+bool GetTaskRuntimeStats(const RuntimeHistory* history, size_t task, RuntimeStats* stats);
+
+// Fill rusage fields of a record.
+void FillTaskRunUsage(TaskRunRecord* record, const struct rusage* usage);
+
+// Append a finished run of a task to the history file.
+// Returns true on success, otherwise returns false and changes errno.
+bool AppendTaskRun(RuntimeHistory* history, size_t task, TaskRunRecord* record);
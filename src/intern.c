@@ -0,0 +1,162 @@
+#include "intern.h"
+
+// FNV-1a, full hashes are cached so that probing compares bytes only on a hash match
+static uint64_t HashName(StringView name) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < name.len; ++i) {
+        hash ^= (unsigned char)name.data[i];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+static NameTableSlot* NewNameTableSlots(size_t capacity) {
+    NameTableSlot* slots = malloc(sizeof(NameTableSlot) * capacity);
+    if (!slots) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    for (size_t i = 0; i < capacity; ++i) {
+        slots[i].id_ = -1;
+    }
+
+    return slots;
+}
+
+NameTable* NewNameTable(void) {
+    NameTable* table = malloc(sizeof(NameTable));
+    if (!table) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    table->capacity_ = NAME_TABLE_INITIAL_CAPACITY;
+    table->slots_ = NewNameTableSlots(table->capacity_);
+    table->names_capacity_ = NAME_TABLE_INITIAL_CAPACITY / 2;
+    table->names_ = malloc(sizeof(StringView) * table->names_capacity_);
+    table->num_names_ = 0;
+
+    if (!table->slots_ || !table->names_) {
+        FreeNameTable(table);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    return table;
+}
+
+void FreeNameTable(NameTable* table) {
+    if (!table) {
+        return;
+    }
+
+    free(table->slots_);
+    free(table->names_);
+    free(table);
+}
+
+// Find the slot holding the name or the empty slot where it would go
+static NameTableSlot* ProbeNameTable(const NameTable* table, StringView name, uint64_t hash) {
+    size_t mask = table->capacity_ - 1;
+
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        NameTableSlot* slot = &table->slots_[i];
+        if (slot->id_ == -1) {
+            return slot;
+        }
+
+        if (slot->hash_ == hash) {
+            StringView other = table->names_[slot->id_];
+            if (other.len == name.len && memcmp(other.data, name.data, name.len) == 0) {
+                return slot;
+            }
+        }
+    }
+}
+
+// Double the slots, cached hashes make it a plain reinsertion
+static bool GrowNameTable(NameTable* table) {
+    size_t new_capacity = table->capacity_ * 2;
+    NameTableSlot* new_slots = NewNameTableSlots(new_capacity);
+    if (!new_slots) {
+        return false;
+    }
+
+    for (size_t i = 0; i < table->capacity_; ++i) {
+        NameTableSlot* slot = &table->slots_[i];
+        if (slot->id_ == -1) {
+            continue;
+        }
+
+        size_t k = slot->hash_ & (new_capacity - 1);
+        while (new_slots[k].id_ != -1) {
+            k = (k + 1) & (new_capacity - 1);
+        }
+        new_slots[k] = *slot;
+    }
+
+    free(table->slots_);
+    table->slots_ = new_slots;
+    table->capacity_ = new_capacity;
+    return true;
+}
+
+int InternName(NameTable* table, StringView name) {
+    if (!table || !name.data) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    uint64_t hash = HashName(name);
+    NameTableSlot* slot = ProbeNameTable(table, name, hash);
+    if (slot->id_ != -1) {
+        return slot->id_;
+    }
+
+    // Load factor stays at most one half
+    if ((table->num_names_ + 1) * 2 > table->capacity_) {
+        if (!GrowNameTable(table)) {
+            return -1;
+        }
+        slot = ProbeNameTable(table, name, hash);
+    }
+
+    if (table->num_names_ == table->names_capacity_) {
+        StringView* new_names = realloc(table->names_, sizeof(StringView) * table->names_capacity_ * 2);
+        if (!new_names) {
+            errno = ENOMEM;
+            return -1;
+        }
+
+        table->names_ = new_names;
+        table->names_capacity_ *= 2;
+    }
+
+    int id = table->num_names_++;
+    table->names_[id] = name;
+    slot->hash_ = hash;
+    slot->id_ = id;
+    return id;
+}
+
+int FindInternedName(const NameTable* table, StringView name) {
+    if (!table || !name.data) {
+        return -1;
+    }
+
+    return ProbeNameTable(table, name, HashName(name))->id_;
+}
+
+StringView GetInternedName(const NameTable* table, int id) {
+    if (!table || id < 0 || id >= table->num_names_) {
+        return (StringView){NULL, 0};
+    }
+
+    return table->names_[id];
+}
+
+size_t GetInternedNameCount(const NameTable* table) {
+    return table ? table->num_names_ : 0;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "tokenizer.h"
+
+#define NAME_TABLE_INITIAL_CAPACITY 64
+
+// Interned name and its slot in the table.
+typedef struct NameTableSlot {
+    uint64_t hash_;
+    int id_;  // -1 if the slot is empty
+} NameTableSlot;
+
+// Interning table mapping each distinct name to a dense ID, 0, 1, 2, ... in order of first appearance.
+// Names are kept as views, the text they point into has to outlive the table.
+typedef struct NameTable {
+    NameTableSlot* slots_;  // open addressing, linear probing
+    size_t capacity_;       // power of two
+    StringView* names_;     // by ID
+    size_t num_names_;
+    size_t names_capacity_;
+} NameTable;
+
+// Create new empty table.
+// Returns NULL on error.
+NameTable* NewNameTable(void);
+
+// Free table instance, the names' text is not touched.
+// Ignores NULL instance.
+void FreeNameTable(NameTable* table);
+
+// Get ID of the name, adding it if it's new.
+// Returns -1 and sets errno on error.
+int InternName(NameTable* table, StringView name);
+
+// Get ID of the name without adding it.
+// Returns -1 if the name is unknown.
+int FindInternedName(const NameTable* table, StringView name);
+
+// Get the name with the given ID.
+StringView GetInternedName(const NameTable* table, int id);
+
+// Get number of distinct names.
+size_t GetInternedNameCount(const NameTable* table);
@@ -0,0 +1,208 @@
+#include "latency.h"
+
+static const char* const kStageNames[SCHEDULING_STAGE_COUNT] = {
+    "ready",
+    "ready -> enqueued",
+    "enqueued -> dequeued",
+    "dequeued -> spawned",
+    "spawned -> reaped",
+    "reaped -> released",
+};
+
+static size_t GetBucketIndex(uint64_t value) {
+    if (value < LATENCY_SUB_BUCKETS) {
+        return value;
+    }
+
+    int msb = 63 - __builtin_clzll(value);
+    if (msb >= LATENCY_MAX_VALUE_BITS) {
+        return LATENCY_NUM_BUCKETS - 1;
+    }
+
+    // Keep the top LATENCY_SUB_BUCKET_BITS bits, the leading one selects the upper half of sub-buckets
+    int shift = msb - (LATENCY_SUB_BUCKET_BITS - 1);
+    size_t sub_bucket = value >> shift;
+    return LATENCY_SUB_BUCKETS + (shift - 1) * LATENCY_HALF_SUB_BUCKETS + (sub_bucket - LATENCY_HALF_SUB_BUCKETS);
+}
+
+// Largest value counted into the bucket
+static uint64_t GetBucketUpperBound(size_t index) {
+    if (index < LATENCY_SUB_BUCKETS) {
+        return index;
+    }
+
+    size_t offset = index - LATENCY_SUB_BUCKETS;
+    int shift = offset / LATENCY_HALF_SUB_BUCKETS + 1;
+    uint64_t sub_bucket = offset % LATENCY_HALF_SUB_BUCKETS + LATENCY_HALF_SUB_BUCKETS;
+    return ((sub_bucket + 1) << shift) - 1;
+}
+
+void InitLatencyHistogram(LatencyHistogram* histogram) {
+    if (!histogram) {
+        return;
+    }
+
+    memset(histogram, 0, sizeof(LatencyHistogram));
+}
+
+void RecordLatency(LatencyHistogram* histogram, uint64_t value_ns) {
+    if (!histogram) {
+        return;
+    }
+
+    histogram->counts_[GetBucketIndex(value_ns)]++;
+    histogram->total_count_++;
+    if (value_ns > histogram->max_) {
+        histogram->max_ = value_ns;
+    }
+}
+
+uint64_t GetLatencyCount(const LatencyHistogram* histogram) {
+    if (!histogram) {
+        errno = EINVAL;
+        return 0;
+    }
+
+    return histogram->total_count_;
+}
+
+uint64_t GetLatencyPercentile(const LatencyHistogram* histogram, double percentile) {
+    if (!histogram || histogram->total_count_ == 0) {
+        return 0;
+    }
+
+    // Rank of the value, 1-based, so that p100 is the last one and p0 the first
+    uint64_t rank = (uint64_t)(percentile / 100.0 * histogram->total_count_ + 0.999999);
+    if (rank == 0) {
+        rank = 1;
+    }
+    if (rank > histogram->total_count_) {
+        rank = histogram->total_count_;
+    }
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < LATENCY_NUM_BUCKETS; ++i) {
+        seen += histogram->counts_[i];
+        if (seen >= rank) {
+            uint64_t bound = GetBucketUpperBound(i);
+            return bound < histogram->max_ ? bound : histogram->max_;
+        }
+    }
+
+    return histogram->max_;
+}
+
+uint64_t GetLatencyMax(const LatencyHistogram* histogram) {
+    if (!histogram) {
+        errno = EINVAL;
+        return 0;
+    }
+
+    return histogram->max_;
+}
+
+SchedulingStats* NewSchedulingStats(size_t num_tasks) {
+    SchedulingStats* stats = malloc(sizeof(SchedulingStats));
+    if (!stats) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    stats->marks_ = malloc(sizeof(int64_t) * SCHEDULING_STAGE_COUNT * (num_tasks ? num_tasks : 1));
+    if (!stats->marks_) {
+        free(stats);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    for (size_t i = 0; i < SCHEDULING_STAGE_COUNT * num_tasks; ++i) {
+        stats->marks_[i] = -1;
+    }
+    for (int i = 0; i < SCHEDULING_STAGE_COUNT; ++i) {
+        InitLatencyHistogram(&stats->stages_[i]);
+    }
+
+    stats->num_tasks_ = num_tasks;
+    stats->capacity_ = num_tasks ? num_tasks : 1;
+    return stats;
+}
+
+bool GrowSchedulingStats(SchedulingStats* stats, size_t num_tasks) {
+    if (!stats) {
+        errno = EINVAL;
+        return false;
+    }
+
+    if (num_tasks > stats->capacity_) {
+        size_t capacity = stats->capacity_ * 2 > num_tasks ? stats->capacity_ * 2 : num_tasks;
+        int64_t* marks = realloc(stats->marks_, sizeof(int64_t) * SCHEDULING_STAGE_COUNT * capacity);
+        if (!marks) {
+            errno = ENOMEM;
+            return false;
+        }
+
+        stats->marks_ = marks;
+        stats->capacity_ = capacity;
+    }
+
+    for (size_t i = SCHEDULING_STAGE_COUNT * stats->num_tasks_; i < SCHEDULING_STAGE_COUNT * num_tasks; ++i) {
+        stats->marks_[i] = -1;
+    }
+
+    if (num_tasks > stats->num_tasks_) {
+        stats->num_tasks_ = num_tasks;
+    }
+    return true;
+}
+
+void FreeSchedulingStats(SchedulingStats* stats) {
+    if (!stats) {
+        return;
+    }
+
+    free(stats->marks_);
+    free(stats);
+}
+
+void MarkSchedulingStage(SchedulingStats* stats, int task, SchedulingStage stage) {
+    if (!stats || task < 0 || (size_t)task >= stats->num_tasks_) {
+        return;
+    }
+
+    int64_t* marks = &stats->marks_[task * SCHEDULING_STAGE_COUNT];
+    int64_t now_ns = GetTimeNs(CLOCK_MONOTONIC);
+
+    // A task that failed to spawn is never reaped, so its release isn't counted either
+    if (stage != SCHEDULING_STAGE_READY && marks[stage - 1] != -1) {
+        RecordLatency(&stats->stages_[stage], now_ns - marks[stage - 1]);
+    }
+
+    marks[stage] = now_ns;
+}
+
+const LatencyHistogram* GetStageLatencies(const SchedulingStats* stats, SchedulingStage stage) {
+    if (!stats || stage < 0 || stage >= SCHEDULING_STAGE_COUNT) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    return &stats->stages_[stage];
+}
+
+void PrintSchedulingStats(const SchedulingStats* stats, FILE* file) {
+    if (!stats || !file) {
+        return;
+    }
+
+    fprintf(file, "%-24s %8s %12s %12s %12s\n", "Scheduling latency, us", "count", "p50", "p99", "max");
+    for (int i = SCHEDULING_STAGE_ENQUEUED; i < SCHEDULING_STAGE_COUNT; ++i) {
+        const LatencyHistogram* histogram = &stats->stages_[i];
+
+        fprintf(file, "%-24s %8llu %12.1f %12.1f %12.1f\n",
+                kStageNames[i],
+                (unsigned long long)GetLatencyCount(histogram),
+                GetLatencyPercentile(histogram, 50) / 1e3,
+                GetLatencyPercentile(histogram, 99) / 1e3,
+                GetLatencyMax(histogram) / 1e3);
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#include "utils.h"
+
+// HDR-style histogram: values below 2^LATENCY_SUB_BUCKET_BITS are counted exactly,
+// larger ones in log-linear buckets with 2^(LATENCY_SUB_BUCKET_BITS - 1) sub-buckets per power of two,
+// i.e. with under 1% relative error. Values at or above 2^LATENCY_MAX_VALUE_BITS ns (about 4.9 h)
+// share the last bucket, the exact maximum is kept aside.
+#define LATENCY_SUB_BUCKET_BITS 7
+#define LATENCY_MAX_VALUE_BITS 44
+#define LATENCY_SUB_BUCKETS (1 << LATENCY_SUB_BUCKET_BITS)
+#define LATENCY_HALF_SUB_BUCKETS (LATENCY_SUB_BUCKETS / 2)
+#define LATENCY_NUM_BUCKETS \
+    (LATENCY_SUB_BUCKETS + (LATENCY_MAX_VALUE_BITS - LATENCY_SUB_BUCKET_BITS) * LATENCY_HALF_SUB_BUCKETS)
+
+typedef struct LatencyHistogram {
+    uint64_t counts_[LATENCY_NUM_BUCKETS];
+    uint64_t total_count_;
+    uint64_t max_;
+} LatencyHistogram;
+
+// Steps every task goes through, each stage latency is the time since the previous step.
+typedef enum SchedulingStage {
+    SCHEDULING_STAGE_READY,     // last requirement resolved, or the run started for root tasks
+    SCHEDULING_STAGE_ENQUEUED,  // pushed into the ready queue
+    SCHEDULING_STAGE_DEQUEUED,  // left the ready set to be started, including waiting for slots and resources
+    SCHEDULING_STAGE_SPAWNED,   // posix_spawn returned, i.e. exec has started, or sleep timer armed
+    SCHEDULING_STAGE_REAPED,    // exit reaped or sleep timer fired
+    SCHEDULING_STAGE_RELEASED,  // output drained and dependents released
+    SCHEDULING_STAGE_COUNT
+} SchedulingStage;
+
+// Per-stage latency histograms of a run, with fixed memory for the whole run.
+typedef struct SchedulingStats {
+    LatencyHistogram stages_[SCHEDULING_STAGE_COUNT];  // indexed by the stage a latency ends at
+    int64_t* marks_;                                   // CLOCK_MONOTONIC of every step per task, -1 if not reached
+    size_t num_tasks_;
+    size_t capacity_;
+} SchedulingStats;
+
+// Reset histogram to an empty state.
+void InitLatencyHistogram(LatencyHistogram* histogram);
+
+// Count one value, O(1).
+void RecordLatency(LatencyHistogram* histogram, uint64_t value_ns);
+
+// Get number of recorded values.
+uint64_t GetLatencyCount(const LatencyHistogram* histogram);
+
+// Get the value below or at which percentile percents of recorded values are,
+// rounded up to the bucket bound and never above the maximum.
+// Returns 0 for an empty histogram.
+uint64_t GetLatencyPercentile(const LatencyHistogram* histogram, double percentile);
+
+// Get the exact maximum of recorded values.
+uint64_t GetLatencyMax(const LatencyHistogram* histogram);
+
+// Create stats for a run of num_tasks tasks.
+// Returns NULL on error.
+SchedulingStats* NewSchedulingStats(size_t num_tasks);
+
+// Cover num_tasks tasks, for a run whose config is still arriving.
+// Returns false and sets errno on error.
+bool GrowSchedulingStats(SchedulingStats* stats, size_t num_tasks);
+
+// Free stats instance.
+// Ignores NULL instance.
+void FreeSchedulingStats(SchedulingStats* stats);
+
+// Mark that the task reached the stage now and count the latency since its previous step.
+// Ignores NULL stats, so instrumentation can be disabled by passing it.
+void MarkSchedulingStage(SchedulingStats* stats, int task, SchedulingStage stage);
+
+// Get histogram of latencies ending at the stage.
+const LatencyHistogram* GetStageLatencies(const SchedulingStats* stats, SchedulingStage stage);
+
+// Print count, p50, p99 and max of every stage latency.
+void PrintSchedulingStats(const SchedulingStats* stats, FILE* file);
@@ -1,14 +1,30 @@
 #include "map.h"
 
-const unsigned long Hash(const char *str) {
-    unsigned long hash = 5381;
-    int c;
-    while ((c = *str++)) {
-        hash = ((hash << 5) + hash) + c;  
+// FNV-1a folded to 32 bits, both halves mixed so that the low bits used for the home slot stay spread
+static uint32_t HashKey(const char* key) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (; *key; ++key) {
+        hash ^= (unsigned char)*key;
+        hash *= 1099511628211ULL;
     }
-    return hash;
+
+    return (uint32_t)(hash ^ (hash >> 32));
+}
+
+// How far the slot at idx is from the home slot of its key
+static size_t ProbeDistance(const StringMap* map, uint32_t hash, size_t idx) {
+    return (idx - hash) & (map->capacity_ - 1);
 }
 
+// Smallest table which holds num_keys keys without being rehashed
+static size_t MapCapacityFor(size_t num_keys, size_t min_capacity) {
+    size_t capacity = min_capacity;
+    while (capacity * MAP_MAX_LOAD_NUM < num_keys * MAP_MAX_LOAD_DEN) {
+        capacity *= 2;
+    }
+
+    return capacity;
+}
 
 StringMap* NewStringMap(size_t capacity) {
     StringMap* res = malloc(sizeof(StringMap));
@@ -17,28 +33,15 @@ StringMap* NewStringMap(size_t capacity) {
         return NULL;
     }
 
-    res->values_ = NewIntVector(capacity);
-    if (!res->values_) {
-        free(res);
-        return NULL;
-    }
-
-    InitializeIntVector(res->values_, 0);
-
-    res->keys_ = malloc(sizeof(char*) * capacity);
-    if (!res->keys_) {
-        FreeIntVector(res->values_);
+    res->capacity_ = MapCapacityFor(capacity, STRING_MAP_MIN_CAPACITY);
+    res->slots_ = calloc(res->capacity_, sizeof(StringMapSlot));
+    if (!res->slots_) {
         free(res);
+        errno = ENOMEM;
         return NULL;
     }
 
-    for (int i = 0; i < capacity; ++i) {
-        res->keys_[i] = NULL;
-    }
-
     res->len_ = 0;
-    res->capacity_ = capacity;
-      
     return res;
 }
 
@@ -47,41 +50,80 @@ void FreeStringMap(StringMap* map) {
         return;
     }
 
-    for (int i = 0; i < map->capacity_; ++i) {
-        free(map->keys_[i]);
+    if (map->slots_) {
+        for (size_t i = 0; i < map->capacity_; ++i) {
+            free(map->slots_[i].key_);
+        }
     }
 
-    free(map->keys_);
-    FreeIntVector(map->values_);
+    free(map->slots_);
     free(map);
 }
 
-// Linear colision solving
-// Setting idx as found index if resolved, otherwise idx is undefined
-// return values:
-// -1 - error (table is full or etc)
-//  0 - new key
-//  1 - not new key
-static int ActualStringMapIndex(const StringMap* map, const char* key, int* idx) {
-    *idx = Hash(key) % map->capacity_;
-    int count = 0;
+// Probe for the key, stopping at an empty slot or at a key closer to its home than the searched one would be.
+// Returns true and sets idx if the key is present.
+static bool FindStringMapSlot(const StringMap* map, const char* key, uint32_t hash, size_t* idx) {
+    size_t mask = map->capacity_ - 1;
+    size_t i = hash & mask;
 
-    while (true) {
-        if (count == map->capacity_) {
-            return -1;
+    for (size_t distance = 0;; ++distance, i = (i + 1) & mask) {
+        const StringMapSlot* slot = &map->slots_[i];
+        if (!slot->key_ || ProbeDistance(map, slot->hash_, i) < distance) {
+            return false;
         }
 
-        if (map->keys_[*idx] == NULL) {
-            return 0;
+        if (slot->hash_ == hash && strcmp(slot->key_, key) == 0) {
+            *idx = i;
+            return true;
+        }
+    }
+}
+
+// Place a key known to be absent, displacing every key closer to its home than the one being carried.
+static void InsertStringMapSlot(StringMap* map, StringMapSlot carried) {
+    size_t mask = map->capacity_ - 1;
+    size_t i = carried.hash_ & mask;
+    size_t distance = 0;
+
+    for (;; ++distance, i = (i + 1) & mask) {
+        StringMapSlot* slot = &map->slots_[i];
+        if (!slot->key_) {
+            *slot = carried;
+            return;
         }
 
-        if (strcmp(key, map->keys_[*idx]) == 0) {
-            return 1;
+        size_t slot_distance = ProbeDistance(map, slot->hash_, i);
+        if (slot_distance < distance) {
+            StringMapSlot displaced = *slot;
+            *slot = carried;
+            carried = displaced;
+            distance = slot_distance;
         }
+    }
+}
 
-        *idx = (*idx + 1) % map->capacity_;
-        count++;
+// Rehash into a table twice as large, keys are moved without being copied or compared.
+// Returns false on error.
+static bool GrowStringMap(StringMap* map) {
+    StringMapSlot* old_slots = map->slots_;
+    size_t old_capacity = map->capacity_;
+
+    StringMapSlot* slots = calloc(old_capacity * 2, sizeof(StringMapSlot));
+    if (!slots) {
+        errno = ENOMEM;
+        return false;
+    }
+
+    map->slots_ = slots;
+    map->capacity_ = old_capacity * 2;
+    for (size_t i = 0; i < old_capacity; ++i) {
+        if (old_slots[i].key_) {
+            InsertStringMapSlot(map, old_slots[i]);
+        }
     }
+
+    free(old_slots);
+    return true;
 }
 
 // Search for the key and fetch the corresponding value.
@@ -92,16 +134,12 @@ bool GetStringMapValue(const StringMap* map, const char* key, int* value) {
         return false;
     }
 
-    int idx;
-    int status;
-
-    status = ActualStringMapIndex(map, key, &idx);
-    if (status == -1 || status == 0) {
+    size_t idx;
+    if (!FindStringMapSlot(map, key, HashKey(key), &idx)) {
         return false;
-    } 
+    }
 
-    int value_in_table = GetIntVectorElement(map->values_, idx);
-    *value = value_in_table;
+    *value = map->slots_[idx].value_;
     return true;
 }
 
@@ -113,84 +151,305 @@ bool SetStringMapValue(StringMap* map, const char* key, int value, bool do_chang
         return false;
     }
 
-    int idx;
-    int status;
+    uint32_t hash = HashKey(key);
+    size_t idx;
 
-    status = ActualStringMapIndex(map, key, &idx);
-    if (status == -1) {
-        return false;
-    } else if (status == 0) {
-        map->keys_[idx] = strdup(key);
-        if (!map->keys_[idx]) {
-            errno = ENOMEM;
-            return false;
-        }
-
-        SetIntVectorElement(map->values_, idx, value);
-        map->len_++;
-        return true;
-    } else {
+    if (FindStringMapSlot(map, key, hash, &idx)) {
         if (do_change_if_exists) {
-            SetIntVectorElement(map->values_, idx, value);
+            map->slots_[idx].value_ = value;
             return true;
         }
 
         return false;
     }
+
+    if ((map->len_ + 1) * MAP_MAX_LOAD_DEN > map->capacity_ * MAP_MAX_LOAD_NUM &&
+        !GrowStringMap(map))
+    {
+        return false;
+    }
+
+    StringMapSlot slot = {.key_ = strdup(key), .hash_ = hash, .value_ = value};
+    if (!slot.key_) {
+        errno = ENOMEM;
+        return false;
+    }
+
+    InsertStringMapSlot(map, slot);
+    map->len_++;
+    return true;
 }
 
+bool DeleteStringMapValue(StringMap* map, const char* key) {
+    if (map == NULL || key == NULL) {
+        errno = EINVAL;
+        return false;
+    }
+
+    size_t idx;
+    if (!FindStringMapSlot(map, key, HashKey(key), &idx)) {
+        return false;
+    }
+
+    free(map->slots_[idx].key_);
+
+    // Every key of the run after it moves one slot closer to home, until a key already at home or a hole
+    size_t mask = map->capacity_ - 1;
+    size_t next = (idx + 1) & mask;
+    while (map->slots_[next].key_ && ProbeDistance(map, map->slots_[next].hash_, next) != 0) {
+        map->slots_[idx] = map->slots_[next];
+        idx = next;
+        next = (next + 1) & mask;
+    }
+
+    map->slots_[idx].key_ = NULL;
+    map->len_--;
+    return true;
+}
+
+size_t GetStringMapLength(const StringMap* map) {
+    if (map == NULL) {
+        errno = EINVAL;
+        return 0;
+    }
+
+    return map->len_;
+}
+
+
+// Fibonacci hashing, the top bits of the product spread sequential keys such as pids over the table
+static size_t IntMapHome(const IntMap* map, int key) {
+    return ((uint64_t)(uint32_t)key * 11400714819323198485ULL) >> map->shift_;
+}
+
+static bool IsDenseKey(const IntMap* map, int key) {
+    return key >= 0 && (size_t)key < map->dense_limit_;
+}
+
+static IntMap* NewIntMapWithDenseLimit(size_t capacity, size_t dense_limit) {
+    IntMap* res = calloc(1, sizeof(IntMap));
+    if (!res) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    res->capacity_ = MapCapacityFor(capacity, INT_MAP_MIN_CAPACITY);
+    res->shift_ = 64 - __builtin_ctzll(res->capacity_);
+    res->slots_ = calloc(res->capacity_, sizeof(IntMapSlot));
+
+    res->dense_limit_ = dense_limit;
+    if (dense_limit != 0) {
+        res->dense_values_ = malloc(sizeof(int) * dense_limit);
+        res->dense_present_ = calloc((dense_limit + 63) / 64, sizeof(uint64_t));
+    }
+
+    if (!res->slots_ || (dense_limit != 0 && (!res->dense_values_ || !res->dense_present_))) {
+        FreeIntMap(res);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    return res;
+}
 
 // Create new instance of map<int, int>.
 // Returns NULL on error.
 IntMap* NewIntMap(size_t capacity) {
-    IntMap* res = NewStringMap(capacity);
-    return res;
+    return NewIntMapWithDenseLimit(capacity, 0);
+}
+
+IntMap* NewDenseIntMap(size_t dense_limit) {
+    return NewIntMapWithDenseLimit(0, dense_limit);
 }
 
 // Free map<int, int> instance.
 // Ignores NULL instance or fields.
 void FreeIntMap(IntMap* map) {
-    FreeStringMap(map);
+    if (map == NULL) {
+        return;
+    }
+
+    free(map->slots_);
+    free(map->dense_values_);
+    free(map->dense_present_);
+    free(map);
 }
 
+// Empty slots have distance 0, so a single comparison stops the probe at either a hole
+// or a key closer to its home than the searched one would be.
+static bool FindIntMapSlot(const IntMap* map, int key, size_t* idx) {
+    size_t mask = map->capacity_ - 1;
+    size_t i = IntMapHome(map, key);
+
+    for (uint32_t distance = 1;; ++distance, i = (i + 1) & mask) {
+        const IntMapSlot* slot = &map->slots_[i];
+        if (slot->distance_ < distance) {
+            return false;
+        }
+
+        if (slot->key_ == key) {
+            *idx = i;
+            return true;
+        }
+    }
+}
+
+static void InsertIntMapSlot(IntMap* map, IntMapSlot carried) {
+    size_t mask = map->capacity_ - 1;
+    size_t i = IntMapHome(map, carried.key_);
+
+    for (carried.distance_ = 1;; ++carried.distance_, i = (i + 1) & mask) {
+        IntMapSlot* slot = &map->slots_[i];
+        if (slot->distance_ < carried.distance_) {
+            IntMapSlot displaced = *slot;
+            *slot = carried;
+            if (displaced.distance_ == 0) {
+                return;
+            }
+            carried = displaced;
+        }
+    }
+}
+
+// Returns false on error.
+static bool GrowIntMap(IntMap* map) {
+    IntMapSlot* old_slots = map->slots_;
+    size_t old_capacity = map->capacity_;
+
+    IntMapSlot* slots = calloc(old_capacity * 2, sizeof(IntMapSlot));
+    if (!slots) {
+        errno = ENOMEM;
+        return false;
+    }
+
+    map->slots_ = slots;
+    map->capacity_ = old_capacity * 2;
+    map->shift_--;
+    for (size_t i = 0; i < old_capacity; ++i) {
+        if (old_slots[i].distance_ != 0) {
+            InsertIntMapSlot(map, old_slots[i]);
+        }
+    }
+
+    free(old_slots);
+    return true;
+}
 
 // Search for the key and fetch the corresponding value.
 // Returns true (and sets the value) if the key is present, otherwise returns false.
 bool GetIntMapValue(const IntMap* map, int key, int* value) {
-    char string_key[12];
-    snprintf(string_key, 12, "%d", key);
-    return GetStringMapValue(map, string_key, value);
+    if (map == NULL || value == NULL) {
+        errno = EINVAL;
+        return false;
+    }
+
+    if (IsDenseKey(map, key)) {
+        if (!(map->dense_present_[key / 64] & (1ULL << (key % 64)))) {
+            return false;
+        }
+
+        *value = map->dense_values_[key];
+        return true;
+    }
+
+    size_t idx;
+    if (!FindIntMapSlot(map, key, &idx)) {
+        return false;
+    }
+
+    *value = map->slots_[idx].value_;
+    return true;
 }
 
 // Set the value for the key.
 // Returns true if the key wasn't present, otherwise returns false.
 bool SetIntMapValue(IntMap* map, int key, int value, bool do_change_if_exists) {
-    char string_key[12];
-    snprintf(string_key, 12, "%d", key);
-    return SetStringMapValue(map, string_key, value, do_change_if_exists);
-}
-
-// Copy int map
-// IntMap* CopyIntMap(const IntMap* map) {
-//     IntMap* res = NewStringMap(map->capacity_);
-//     if (!res) {
-//         return NULL;
-//     }
-
-//     for (int i = 0; i < map->capacity_; ++i) {
-//         if (map->keys_[i]) {
-//             res->keys_[i] = strdup(map->keys_[i]);
-
-//             if (!res->keys_[i]) {
-//                 errno = ENOMEM;
-//                 FreeIntMap(res);
-//                 return NULL;
-//             }
-//         }
-
-//         SetIntVectorElement(res->values_, i, GetIntVectorElement(map->values_, i));
-//     }
-    
-//     return res;
-// }
+    if (map == NULL) {
+        errno = EINVAL;
+        return false;
+    }
 
+    if (IsDenseKey(map, key)) {
+        uint64_t* word = &map->dense_present_[key / 64];
+        uint64_t bit = 1ULL << (key % 64);
+        if (*word & bit) {
+            if (do_change_if_exists) {
+                map->dense_values_[key] = value;
+                return true;
+            }
+
+            return false;
+        }
+
+        *word |= bit;
+        map->dense_values_[key] = value;
+        map->len_++;
+        return true;
+    }
+
+    size_t idx;
+    if (FindIntMapSlot(map, key, &idx)) {
+        if (do_change_if_exists) {
+            map->slots_[idx].value_ = value;
+            return true;
+        }
+
+        return false;
+    }
+
+    if ((map->num_hashed_ + 1) * MAP_MAX_LOAD_DEN > map->capacity_ * MAP_MAX_LOAD_NUM && !GrowIntMap(map)) {
+        return false;
+    }
+
+    InsertIntMapSlot(map, (IntMapSlot){.key_ = key, .value_ = value});
+    map->num_hashed_++;
+    map->len_++;
+    return true;
+}
+
+bool DeleteIntMapValue(IntMap* map, int key) {
+    if (map == NULL) {
+        errno = EINVAL;
+        return false;
+    }
+
+    if (IsDenseKey(map, key)) {
+        uint64_t* word = &map->dense_present_[key / 64];
+        uint64_t bit = 1ULL << (key % 64);
+        if (!(*word & bit)) {
+            return false;
+        }
+
+        *word &= ~bit;
+        map->len_--;
+        return true;
+    }
+
+    size_t idx;
+    if (!FindIntMapSlot(map, key, &idx)) {
+        return false;
+    }
+
+    size_t mask = map->capacity_ - 1;
+    size_t next = (idx + 1) & mask;
+    while (map->slots_[next].distance_ > 1) {
+        map->slots_[idx] = map->slots_[next];
+        map->slots_[idx].distance_--;
+        idx = next;
+        next = (next + 1) & mask;
+    }
+
+    map->slots_[idx].distance_ = 0;
+    map->num_hashed_--;
+    map->len_--;
+    return true;
+}
+
+size_t GetIntMapLength(const IntMap* map) {
+    if (map == NULL) {
+        errno = EINVAL;
+        return 0;
+    }
+
+    return map->len_;
+}
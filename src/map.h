@@ -1,15 +1,34 @@
 #pragma once
 
+#include <stdint.h>
+
 #include "vector.h"
 
+#define STRING_MAP_MIN_CAPACITY 8
+#define INT_MAP_MIN_CAPACITY 8
+
+// Tables are rehashed twice as large before they get fuller than 7/8
+#define MAP_MAX_LOAD_NUM 7
+#define MAP_MAX_LOAD_DEN 8
+
+// Slot of the open-addressing table, empty if key_ is NULL.
+// The cached hash gives the probe distance and filters out most key comparisons.
+typedef struct StringMapSlot {
+    char* key_;
+    uint32_t hash_;
+    int value_;
+} StringMapSlot;
+
+// Robin Hood hashing: a key being inserted takes the slot of any key closer to its home,
+// so probe lengths stay short and even, and a lookup stops as soon as it passes where the key would be.
 typedef struct StringMap {
-    size_t capacity_;
+    size_t capacity_;  // power of two
     size_t len_;
-    IntVector* values_;
-    char** keys_;
-} StringMap, IntMap;
+    StringMapSlot* slots_;
+} StringMap;
 
-// Create new instance of map<string, int>.
+// Create new instance of map<string, int>, capacity is the number of keys expected,
+// the map grows past it on its own.
 // Returns NULL on error.
 StringMap* NewStringMap(size_t capacity);
 
@@ -25,11 +44,44 @@ bool GetStringMapValue(const StringMap* map, const char* key, int* value);
 // Returns true if the key wasn't present, otherwise returns false.
 bool SetStringMapValue(StringMap* map, const char* key, int value, bool do_change_if_exists);
 
+// Remove the key, the keys after it are shifted back so no tombstones are left.
+// Returns true if the key was present, otherwise returns false.
+bool DeleteStringMapValue(StringMap* map, const char* key);
+
+// Get number of keys in the map.
+size_t GetStringMapLength(const StringMap* map);
+
 
-// Create new instance of map<int, int>.
+// Same Robin Hood table with keys inline: the hash is recomputed from the key instead of cached,
+// the slot stores its probe distance instead, offset by one so that 0 marks an empty slot.
+typedef struct IntMapSlot {
+    int key_;
+    int value_;
+    uint32_t distance_;
+} IntMapSlot;
+
+// Keys in [0, dense_limit_) live in a plain array indexed by the key, every other key is hashed.
+typedef struct IntMap {
+    size_t capacity_;  // power of two
+    int shift_;        // 64 - log2(capacity_), multiplicative hashing keeps the top bits
+    size_t len_;       // keys in both parts
+    size_t num_hashed_;
+    IntMapSlot* slots_;
+    size_t dense_limit_;
+    int* dense_values_;
+    uint64_t* dense_present_;  // bitmap of the dense keys set
+} IntMap;
+
+// Create new instance of map<int, int>, capacity is the number of keys expected,
+// the map grows past it on its own.
 // Returns NULL on error.
 IntMap* NewIntMap(size_t capacity);
 
+// Create new instance of map<int, int> for keys mostly in [0, dense_limit), e.g. vertex ids.
+// Those are kept in a plain array, others still go to the hash table.
+// Returns NULL on error.
+IntMap* NewDenseIntMap(size_t dense_limit);
+
 // Free map<int, int> instance.
 // Ignores NULL instance or fields.
 void FreeIntMap(IntMap* map);
@@ -42,3 +94,9 @@ bool GetIntMapValue(const IntMap* map, int key, int* value);
 // Returns true if the key wasn't present, otherwise returns false.
 bool SetIntMapValue(IntMap* map, int key, int value, bool do_change_if_exists);
 
+// Remove the key.
+// Returns true if the key was present, otherwise returns false.
+bool DeleteIntMapValue(IntMap* map, int key);
+
+// Get number of keys in the map.
+size_t GetIntMapLength(const IntMap* map);
@@ -1,33 +1,100 @@
 #include "master.h"
 #include "context.h"
 
+#define TASK_SLOT_CHUNK_BITS 10
+#define TASK_SLOT_CHUNK_SIZE (1 << TASK_SLOT_CHUNK_BITS)
+
+// Run state of a task. Output sources and timers are watched by address,
+// so slots are allocated in chunks that never move while a streamed config adds tasks.
+typedef struct TaskSlot {
+    TaskProcess process;  // spawned EXEC task, or the log of a SLEEP one
+    WheelTimer timer;     // EXEC timeout or SLEEP wake-up, its data points back to the slot
+    int task;
+} TaskSlot;
+
 typedef struct ResourceManager {
     FILE* input_file;
+    char* cache_path;  // compiled config beside the input file
+    int config_fd;          // streamed config input, -1 unless the config comes from stdin
+    ConfigStream* stream;   // NULL unless the config is streamed
     ExecutionConfig* config;
-    StringMap* string_map;
     Graph* graph;
-    IntMap* pid_to_idx;
+    DependencyTracker* tracker;
+    IntMap* pid_to_idx;  // running tasks only, entries are dropped once reaped
     Queue* queue;
+    Heap* heap;
+    long long* priorities;
+    IntVector* blocked;  // ready tasks waiting for resources, in arrival order
+    IntVector* skipped;  // scratch list of tasks skipped by the last failure
+    TaskSlot** slot_chunks;   // task i lives in chunk i >> TASK_SLOT_CHUNK_BITS
+    size_t num_slots;
+    TimerWheel* timer_wheel;  // every task deadline: EXEC timeouts, SLEEP wake-ups
+    int wheel_timer_fd;       // fires at the next deadline of the wheel
+    bool wheel_timer_armed;
+    uint64_t wheel_timer_deadline_ms;
+    RuntimeHistory* history;
+    TraceRecorder* trace;  // NULL unless the run is traced
+    SchedulingStats* stats;  // NULL unless scheduling latencies are collected
     Context* context;
+    EventLoop* event_loop;
+    int child_signal_fd;
+    int render_timer_fd;
+    int pressure_timer_fd;
+    bool signal_mask_changed;
+    sigset_t old_signal_mask;
 } ResourceManager;
 
-typedef struct RenderStruct {
-    const Context* context;
-    VerbosityType verbosity_type;
-    bool redraw;
-    unsigned int drawer_sleep_duration;
-    bool* do_render;
-} RenderStruct;
+// State shared by the master event loop handlers
+typedef struct Dispatcher {
+    ResourceManager* rm;
+    const MasterArgs* args;
+    int currently_working;
+    unsigned int cpus_in_use;       // declared CPUs of running tasks
+    unsigned int memory_in_use_mb;  // declared memory of running tasks
+    ConcurrencyController concurrency;  // used with adaptive concurrency only
+    bool window_saturated;  // window limited dispatch since the last pressure sample
+    bool config_open;               // streamed config hasn't reached its end yet
+    EventSource* config_source;     // watches the streamed config, NULL if it is pumped between polls
+    int64_t config_done_ns;         // CLOCK_MONOTONIC at the end of the streamed config
+    const char* error;  // set by a handler before it reports failure
+} Dispatcher;
+
+static bool CompleteTask(Dispatcher* dispatcher, int task, int wait_status, const struct rusage* usage);
+static bool FinishSleepTask(Dispatcher* dispatcher, int task);
+static bool OnTaskOutput(EventSource* source, uint32_t events);
+
+static TaskSlot* GetTaskSlot(const ResourceManager* rm, int task) {
+    return &rm->slot_chunks[task >> TASK_SLOT_CHUNK_BITS][task & (TASK_SLOT_CHUNK_SIZE - 1)];
+}
+
+// Give every task below num_tasks a slot, the slots given before stay where they are.
+// Returns false on error.
+static bool EnsureTaskSlots(ResourceManager* rm, size_t num_tasks) {
+    while (rm->num_slots < num_tasks) {
+        if (rm->num_slots % TASK_SLOT_CHUNK_SIZE == 0) {
+            size_t num_chunks = rm->num_slots / TASK_SLOT_CHUNK_SIZE;
+            TaskSlot** chunks = realloc(rm->slot_chunks, sizeof(TaskSlot*) * (num_chunks + 1));
+            if (!chunks) {
+                errno = ENOMEM;
+                return false;
+            }
+            rm->slot_chunks = chunks;
 
-static void* RenderFunc(void* arg) {
-    RenderStruct* args = (RenderStruct*)arg;
+            chunks[num_chunks] = malloc(sizeof(TaskSlot) * TASK_SLOT_CHUNK_SIZE);
+            if (!chunks[num_chunks]) {
+                errno = ENOMEM;
+                return false;
+            }
+        }
 
-    while (*args->do_render) {
-        DrawContext(args->context, args->verbosity_type, args->redraw);
-        sleep(args->drawer_sleep_duration);
+        TaskSlot* slot = GetTaskSlot(rm, rm->num_slots);
+        slot->task = rm->num_slots++;
+        slot->process.pid = -1;
+        slot->process.exited = false;
+        InitWheelTimer(&slot->timer, slot);
     }
 
-    return NULL;
+    return true;
 }
 
 static void CleanupResources(ResourceManager* manager) {
@@ -35,38 +102,624 @@ static void CleanupResources(ResourceManager* manager) {
         return;
     }
 
+    // Tasks still running when the master gives up are killed along with their process groups
+    for (size_t i = 0; i < manager->num_slots; ++i) {
+        TaskProcess* process = &GetTaskSlot(manager, i)->process;
+        if (process->pid != -1 && !process->exited) {
+            kill(-process->pid, SIGKILL);
+        }
+    }
+
+    for (size_t i = 0; i < manager->num_slots; i += TASK_SLOT_CHUNK_SIZE) {
+        free(manager->slot_chunks[i >> TASK_SLOT_CHUNK_BITS]);
+    }
+    free(manager->slot_chunks);
+
     if (manager->input_file) {
         fclose(manager->input_file);
     }
+    if (manager->config_fd != -1) {
+        close(manager->config_fd);
+    }
+    free(manager->cache_path);
+    FreeConfigStream(manager->stream);
     FreeExecutionConfig(manager->config);
-    FreeStringMap(manager->string_map);
     FreeGraph(manager->graph);
+    FreeDependencyTracker(manager->tracker);
     FreeQueue(manager->queue);
+    FreeHeap(manager->heap);
+    FreeIntVector(manager->blocked);
+    FreeIntVector(manager->skipped);
+    FreeTimerWheel(manager->timer_wheel);
+    free(manager->priorities);
+    FreeRuntimeHistory(manager->history);
+    FreeTraceRecorder(manager->trace);
+    FreeSchedulingStats(manager->stats);
     FreeIntMap(manager->pid_to_idx);
     FreeContext(manager->context);
+    FreeEventLoop(manager->event_loop);
+
+    if (manager->wheel_timer_fd != -1) {
+        close(manager->wheel_timer_fd);
+    }
+    if (manager->pressure_timer_fd != -1) {
+        close(manager->pressure_timer_fd);
+    }
+    if (manager->render_timer_fd != -1) {
+        close(manager->render_timer_fd);
+    }
+    if (manager->child_signal_fd != -1) {
+        close(manager->child_signal_fd);
+    }
+    if (manager->signal_mask_changed) {
+        sigprocmask(SIG_SETMASK, &manager->old_signal_mask, NULL);
+    }
+}
+
+// Skip every task that transitively requires the failed one, O(V + E) over the whole run.
+static bool SkipFailedTaskDependents(ResourceManager* rm, int failed_task) {
+    IntVector* skipped = rm->skipped;
+
+    rm->context->tasks[failed_task].task_status = TASK_STATUS_FAILED;
+
+    TruncateIntVector(skipped, 0);
+    if (SkipDependents(rm->tracker, failed_task, skipped) == -1) {
+        return false;
+    }
+
+    for (size_t i = 0; i < GetIntVectorLength(skipped); ++i) {
+        rm->context->tasks[GetIntVectorElement(skipped, i)].task_status = TASK_STATUS_SKIPPED;
+    }
+
+    return true;
+}
+
+// Ready tasks wait either in the FIFO queue or, when scheduling
+// by critical path, in the heap keyed by longest downstream path.
+static bool PushReadyTask(ResourceManager* rm, int task) {
+    RecordTraceEvent(rm->trace, TRACE_EVENT_QUEUED, task, -1);
+    MarkSchedulingStage(rm->stats, task, SCHEDULING_STAGE_ENQUEUED);
+
+    if (rm->heap) {
+        return PushHeap(rm->heap, task, rm->priorities[task]);
+    }
+
+    return Push(rm->queue, task);
+}
+
+static bool PopReadyTask(ResourceManager* rm, int* task) {
+    if (rm->heap) {
+        return TopHeap(rm->heap, task) && PopHeap(rm->heap);
+    }
+
+    return Front(rm->queue, task) && Pop(rm->queue);
+}
+
+static bool HasReadyTasks(const ResourceManager* rm) {
+    return !IsEmpty(rm->queue) || !IsHeapEmpty(rm->heap);
+}
+
+// Demands above the whole budget are clamped, so such a task still runs, alone.
+static unsigned int TaskCpuDemand(const ExecutionConfig* config, int task) {
+    unsigned int cpus = config->tasks[task]->cpus;
+    return cpus < config->cpu_budget ? cpus : config->cpu_budget;
+}
+
+static unsigned int TaskMemoryDemand(const ExecutionConfig* config, int task) {
+    unsigned int memory_mb = config->tasks[task]->memory_mb;
+    return memory_mb < config->memory_budget_mb ? memory_mb : config->memory_budget_mb;
+}
+
+static bool HasFreeSlot(Dispatcher* dispatcher) {
+    const ExecutionConfig* config = dispatcher->rm->config;
+
+    if (!config->adaptive_concurrency) {
+        return dispatcher->currently_working != config->max_concurrent_tasks;
+    }
+
+    if (dispatcher->currently_working < dispatcher->concurrency.window) {
+        return true;
+    }
+
+    dispatcher->window_saturated = true;
+    return false;
+}
+
+// Start a dispatch pass with the resources that running tasks leave free.
+static void InitDispatchWindow(const Dispatcher* dispatcher, BackfillWindow* window) {
+    const ExecutionConfig* config = dispatcher->rm->config;
+
+    InitBackfillWindow(window, config->cpu_budget - dispatcher->cpus_in_use,
+                       config->memory_budget_mb - dispatcher->memory_in_use_mb);
+}
+
+static bool ResourcesFit(const Dispatcher* dispatcher, BackfillWindow* window, int task) {
+    const ExecutionConfig* config = dispatcher->rm->config;
+
+    return AdmitBackfillTask(window, TaskCpuDemand(config, task), TaskMemoryDemand(config, task));
+}
+
+static uint64_t GetMonotonicMs(void) {
+    return GetTimeNs(CLOCK_MONOTONIC) / 1000000;
+}
+
+// Arm the task deadline delay_ms milliseconds from now.
+static bool ArmTaskTimer(Dispatcher* dispatcher, int task, unsigned int delay_ms) {
+    ResourceManager* rm = dispatcher->rm;
+
+    if (!ArmWheelTimer(rm->timer_wheel, &GetTaskSlot(rm, task)->timer, GetMonotonicMs() + delay_ms)) {
+        dispatcher->error = "timer arming error";
+        return false;
+    }
+
+    return true;
+}
+
+static void DisarmTaskTimer(ResourceManager* rm, int task) {
+    CancelWheelTimer(rm->timer_wheel, &GetTaskSlot(rm, task)->timer);
+}
+
+// Point the timerfd at the next deadline of the wheel, skipping the syscall if it hasn't moved.
+static bool RearmWheelTimerFd(ResourceManager* rm) {
+    uint64_t deadline_ms;
+    bool has_deadline = GetNextWheelDeadline(rm->timer_wheel, &deadline_ms);
+
+    if (has_deadline == rm->wheel_timer_armed && (!has_deadline || deadline_ms == rm->wheel_timer_deadline_ms)) {
+        return true;
+    }
+
+    // Zero it_value disarms, so deadlines are shifted by one nanosecond
+    struct itimerspec spec = {0};
+    if (has_deadline) {
+        spec.it_value.tv_sec = deadline_ms / 1000;
+        spec.it_value.tv_nsec = (deadline_ms % 1000) * 1000000 + 1;
+    }
+
+    if (timerfd_settime(rm->wheel_timer_fd, TFD_TIMER_ABSTIME, &spec, NULL) == -1) {
+        return false;
+    }
+
+    rm->wheel_timer_armed = has_deadline;
+    rm->wheel_timer_deadline_ms = deadline_ms;
+    return true;
+}
+
+// Start the task and account its slot and resources.
+// EXEC tasks are spawned directly by the master, SLEEP tasks are timers of the master and need no process.
+static bool StartTask(Dispatcher* dispatcher, int task) {
+    ResourceManager* rm = dispatcher->rm;
+    const TaskConfig* task_config = rm->config->tasks[task];
+    TaskProcess* process = &GetTaskSlot(rm, task)->process;
+    bool status;
+
+    RecordTraceEvent(rm->trace, TRACE_EVENT_SPAWN, task, -1);
+    MarkSchedulingStage(rm->stats, task, SCHEDULING_STAGE_DEQUEUED);
+    rm->context->tasks[task].task_status = TASK_STATUS_RUNNING;
+    rm->context->tasks[task].start_ns = GetTimeNs(CLOCK_REALTIME);
+    dispatcher->currently_working++;
+    dispatcher->cpus_in_use += TaskCpuDemand(rm->config, task);
+    dispatcher->memory_in_use_mb += TaskMemoryDemand(rm->config, task);
+
+    if (task_config->type == TASK_TYPE_SLEEP) {
+        if (!StartSleepTask(process, task_config, dispatcher)) {
+            FinishTaskProcess(process, rm->event_loop);
+            return CompleteTask(dispatcher, task, process->wait_status, &process->usage);
+        }
+
+        RecordTraceEvent(rm->trace, TRACE_EVENT_RUNNING, task, -1);
+        MarkSchedulingStage(rm->stats, task, SCHEDULING_STAGE_SPAWNED);
+
+        // Wakes up at the timeout if it comes first
+        unsigned int duration_ms = task_config->sleep_args->duration * 1000;
+        if (task_config->timeout_ms != 0 && task_config->timeout_ms < duration_ms) {
+            duration_ms = task_config->timeout_ms;
+        }
+
+        // Nothing to wait for, a timer would only delay it to the next tick
+        if (duration_ms == 0) {
+            return FinishSleepTask(dispatcher, task);
+        }
+
+        return ArmTaskTimer(dispatcher, task, duration_ms);
+    }
+
+    // A task that couldn't be spawned finishes right away with the status set by the spawner
+    if (!SpawnTaskProcess(process, task_config, &rm->old_signal_mask, rm->event_loop, OnTaskOutput, dispatcher)) {
+        FinishTaskProcess(process, rm->event_loop);
+        return CompleteTask(dispatcher, task, process->wait_status, &process->usage);
+    }
+    RecordTraceEvent(rm->trace, TRACE_EVENT_RUNNING, task, -1);
+    MarkSchedulingStage(rm->stats, task, SCHEDULING_STAGE_SPAWNED);
+
+    if (task_config->timeout_ms != 0 && !ArmTaskTimer(dispatcher, task, task_config->timeout_ms)) {
+        return false;
+    }
+
+    // Pids of reaped tasks may be reused by the kernel
+    status = SetIntMapValue(rm->pid_to_idx, process->pid, task, true);
+    if (!status) {
+        dispatcher->error = "int map setting value error";
+        return false;
+    }
+
+    return true;
+}
+
+// Start queued tasks while there are free slots and resources.
+// Tasks that don't fit wait in the blocked list while smaller ones are backfilled around them,
+// but only into resources not reserved for the oldest blocked task.
+static bool DispatchReadyTasks(Dispatcher* dispatcher) {
+    ResourceManager* rm = dispatcher->rm;
+    IntVector* blocked = rm->blocked;
+    BackfillWindow window;
+    int front_value;
+    bool status;
+
+    InitDispatchWindow(dispatcher, &window);
+
+    // Blocked tasks get the first claim on freed resources
+    size_t num_kept = 0;
+    for (size_t i = 0; i < GetIntVectorLength(blocked); ++i) {
+        int task = GetIntVectorElement(blocked, i);
+
+        if (HasFreeSlot(dispatcher) && ResourcesFit(dispatcher, &window, task)) {
+            if (!StartTask(dispatcher, task)) {
+                return false;
+            }
+        } else {
+            SetIntVectorElement(blocked, num_kept++, task);
+        }
+    }
+    TruncateIntVector(blocked, num_kept);
+
+    while (HasReadyTasks(rm) && HasFreeSlot(dispatcher)) {
+        status = PopReadyTask(rm, &front_value);
+        if (!status) {
+            dispatcher->error = "ready task popping error";
+            return false;
+        }
+
+        if (!ResourcesFit(dispatcher, &window, front_value)) {
+            status = AppendToIntVector(blocked, front_value);
+            if (!status) {
+                dispatcher->error = "blocked task appending error";
+                return false;
+            }
+
+            continue;
+        }
+
+        if (!StartTask(dispatcher, front_value)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Record task exit and queue dependents that became ready.
+static bool CompleteTask(Dispatcher* dispatcher, int completed_process_idx, int wait_status, const struct rusage* usage) {
+    ResourceManager* rm = dispatcher->rm;
+    DependencyTracker* tracker = rm->tracker;
+    Context* context = rm->context;
+    bool status;
+
+    RecordTraceEvent(rm->trace, TRACE_EVENT_DONE, completed_process_idx, -1);
+    context->tasks[completed_process_idx].worker_status = wait_status;
+    dispatcher->currently_working--;
+    dispatcher->cpus_in_use -= TaskCpuDemand(rm->config, completed_process_idx);
+    dispatcher->memory_in_use_mb -= TaskMemoryDemand(rm->config, completed_process_idx);
+
+    // History is advisory, a failed append must not stop the run
+    TaskRunRecord record = {
+        .start_ns = context->tasks[completed_process_idx].start_ns,
+        .end_ns = GetTimeNs(CLOCK_REALTIME),
+        .wait_status = wait_status
+    };
+    FillTaskRunUsage(&record, usage);
+    AppendTaskRun(rm->history, completed_process_idx, &record);
+    context->tasks[completed_process_idx].run = record;
+
+    // Tasks of a streamed config admitted later are resolved against the outcome
+    FinishTrackedTask(tracker, completed_process_idx, WIFEXITED(wait_status));
+
+    // Dependency resolution, O(out-degree) per completion
+    if (WIFEXITED(wait_status)) {
+        size_t num_dependents;
+        const int* dependents = GetDependents(tracker, completed_process_idx, &num_dependents);
+
+        for (size_t i = 0; i < num_dependents; ++i) {
+            int dependent = dependents[i];
+
+            if (ResolveRequirement(tracker, dependent) == 0 &&
+                !IsTaskSkipped(tracker, dependent))
+            {
+                MarkSchedulingStage(rm->stats, dependent, SCHEDULING_STAGE_READY);
+                RecordTraceEvent(rm->trace, TRACE_EVENT_RELEASE, dependent, completed_process_idx);
+                status = PushReadyTask(rm, dependent);
+                if (!status) {
+                    dispatcher->error = "ready task pushing error";
+                    return false;
+                }
+
+                context->tasks[dependent].task_status = TASK_STATUS_QUEUED;
+            }
+        }
+
+        context->tasks[completed_process_idx].task_status = TASK_STATUS_SUCCESS;
+    } else {
+        status = SkipFailedTaskDependents(rm, completed_process_idx);
+        if (!status) {
+            dispatcher->error = "failure propagation error";
+            return false;
+        }
+    }
+
+    MarkSchedulingStage(rm->stats, completed_process_idx, SCHEDULING_STAGE_RELEASED);
+    return true;
+}
+
+// Spawned task completes once it is reaped and its output is drained, whichever comes last.
+static bool CompleteTaskProcessIfDone(Dispatcher* dispatcher, TaskProcess* process) {
+    ResourceManager* rm = dispatcher->rm;
+    int task = ((TaskSlot*)((char*)process - offsetof(TaskSlot, process)))->task;
+
+    if (!IsTaskProcessDone(process)) {
+        return true;
+    }
+
+    DisarmTaskTimer(rm, task);
+    FinishTaskProcess(process, rm->event_loop);
+    return CompleteTask(dispatcher, task, process->wait_status, &process->usage);
+}
+
+static bool OnTaskOutput(EventSource* source, uint32_t events) {
+    TaskProcess* process = source->data;
+    Dispatcher* dispatcher = process->owner;
+
+    // Stale event of a pipe closed earlier in the same poll
+    if (source->fd == -1) {
+        return true;
+    }
+
+    if (!PumpTaskOutput(process, source, dispatcher->rm->event_loop)) {
+        dispatcher->error = "task output reading error";
+        return false;
+    }
+
+    if (!CompleteTaskProcessIfDone(dispatcher, process)) {
+        return false;
+    }
+
+    return DispatchReadyTasks(dispatcher);
+}
+
+// Kill the whole process group, so that background children don't keep the output pipes open.
+// The exit is picked up through SIGCHLD as usual, the leader may have exited already.
+static void TimeoutTaskProcess(TaskProcess* process) {
+    WriteTaskLog(process, "Process killed due to timeout\n");
+    process->timed_out = true;
+    kill(-process->pid, SIGKILL);
+}
+
+// SLEEP task is over, either slept its duration or reached its timeout.
+static bool FinishSleepTask(Dispatcher* dispatcher, int task) {
+    ResourceManager* rm = dispatcher->rm;
+    TaskProcess* process = &GetTaskSlot(rm, task)->process;
+    const TaskConfig* task_config = process->config;
+
+    RecordTraceEvent(rm->trace, TRACE_EVENT_EXITED, task, -1);
+    MarkSchedulingStage(rm->stats, task, SCHEDULING_STAGE_REAPED);
+
+    // Same statuses a forked sleeper would have been reaped with
+    if (task_config->timeout_ms != 0 && task_config->timeout_ms < task_config->sleep_args->duration * 1000) {
+        WriteTaskLog(process, "Process killed due to timeout\n");
+        SetTaskProcessExited(process, SIGKILL, NULL);
+    } else {
+        WriteTaskLog(process, "Slept well\n");
+        SetTaskProcessExited(process, W_EXITCODE(0, 0), NULL);
+    }
+
+    FinishTaskProcess(process, rm->event_loop);
+    return CompleteTask(dispatcher, task, process->wait_status, &process->usage);
+}
+
+static bool OnWheelTimer(EventSource* source, uint32_t events) {
+    Dispatcher* dispatcher = source->data;
+    ResourceManager* rm = dispatcher->rm;
+    WheelTimer* timer;
+
+    if (!DrainEventFd(source->fd)) {
+        dispatcher->error = "timerfd reading error";
+        return false;
+    }
+
+    // The fd has fired, a deadline has to be set again even if it's the same
+    rm->wheel_timer_armed = false;
+    AdvanceTimerWheel(rm->timer_wheel, GetMonotonicMs());
+
+    while ((timer = PopExpiredWheelTimer(rm->timer_wheel))) {
+        TaskSlot* slot = timer->data;
+
+        if (rm->config->tasks[slot->task]->type == TASK_TYPE_SLEEP) {
+            if (!FinishSleepTask(dispatcher, slot->task)) {
+                return false;
+            }
+        } else {
+            TimeoutTaskProcess(&slot->process);
+        }
+    }
+
+    return DispatchReadyTasks(dispatcher);
 }
 
-static bool FailingTaskUpperNeighbors(
-    const Graph* graph, 
-    int completed_task_idx,
-    Context* context) 
-{
-    if (!graph || !context) {
+// SIGCHLD notifications may coalesce, so reap every exited task process.
+static bool OnChildSignal(EventSource* source, uint32_t events) {
+    Dispatcher* dispatcher = source->data;
+    ResourceManager* rm = dispatcher->rm;
+    struct rusage usage;
+    int wait_status;
+    int task;
+    pid_t pid;
+
+    if (!DrainEventFd(source->fd)) {
+        dispatcher->error = "signalfd reading error";
         return false;
     }
 
-    context->tasks[completed_task_idx].task_status = TASK_STATUS_FAILED;
-    int graph_size = GetGraphSize(graph);
+    while ((pid = wait4(-1, &wait_status, WNOHANG, &usage)) > 0) {
+        if (!GetIntMapValue(rm->pid_to_idx, pid, &task)) {
+            dispatcher->error = "int map getting value error";
+            return false;
+        }
+        DeleteIntMapValue(rm->pid_to_idx, pid);
 
-    for (int i = 0; i < graph_size; ++i) {
-        if (graph->matrix_[ completed_task_idx * graph_size + i ] == 1) {
-            FailingTaskUpperNeighbors(graph, i, context);
+        RecordTraceEvent(rm->trace, TRACE_EVENT_EXITED, task, -1);
+        MarkSchedulingStage(rm->stats, task, SCHEDULING_STAGE_REAPED);
+        TaskProcess* process = &GetTaskSlot(rm, task)->process;
+        SetTaskProcessExited(process, wait_status, &usage);
+        if (!CompleteTaskProcessIfDone(dispatcher, process)) {
+            return false;
         }
     }
 
+    if (pid == -1 && errno != ECHILD) {
+        dispatcher->error = "wait error";
+        return false;
+    }
+
+    return DispatchReadyTasks(dispatcher);
+}
+
+static bool OnRenderTimer(EventSource* source, uint32_t events) {
+    Dispatcher* dispatcher = source->data;
+
+    if (!DrainEventFd(source->fd)) {
+        dispatcher->error = "timerfd reading error";
+        return false;
+    }
+
+    DrawContext(dispatcher->rm->context, dispatcher->args->verbosity_type, true);
     return true;
 }
 
+// Retune adaptive window by the pressure of the last interval and use the new slots right away.
+static bool OnPressureTimer(EventSource* source, uint32_t events) {
+    Dispatcher* dispatcher = source->data;
+    PressureSample sample;
+
+    if (!DrainEventFd(source->fd)) {
+        dispatcher->error = "timerfd reading error";
+        return false;
+    }
+
+    // Unreadable /proc leaves the window as it is
+    if (ReadPressureSample(&sample)) {
+        dispatcher->rm->context->concurrency_window =
+            UpdateConcurrencyWindow(&dispatcher->concurrency, &sample, dispatcher->window_saturated);
+        dispatcher->window_saturated = false;
+    }
+
+    return DispatchReadyTasks(dispatcher);
+}
+
+// Take the tasks admitted by the config stream: the run state grows to cover them,
+// those whose requirements have all succeeded are queued right away.
+static bool ReceiveStreamedTasks(Dispatcher* dispatcher) {
+    ResourceManager* rm = dispatcher->rm;
+    size_t num_tasks = rm->config->num_tasks;
+    int task;
+
+    if (!EnsureTaskSlots(rm, num_tasks) ||
+        !GrowContext(rm->context) ||
+        !GrowRuntimeHistory(rm->history, rm->config) ||
+        (rm->trace && !GrowTraceRecorder(rm->trace, num_tasks)) ||
+        (rm->stats && !GrowSchedulingStats(rm->stats, num_tasks)))
+    {
+        dispatcher->error = "task state growing error";
+        return false;
+    }
+
+    while (NextAdmittedTask(rm->stream, &task)) {
+        const TaskConfig* task_config = rm->config->tasks[task];
+
+        if (!AddTrackedTask(rm->tracker, task, task_config->dependencies, task_config->num_dependencies)) {
+            dispatcher->error = "dependency tracking error";
+            return false;
+        }
+
+        if (IsTaskSkipped(rm->tracker, task)) {
+            rm->context->tasks[task].task_status = TASK_STATUS_SKIPPED;
+        } else if (IsTaskReady(rm->tracker, task)) {
+            MarkSchedulingStage(rm->stats, task, SCHEDULING_STAGE_READY);
+            if (!PushReadyTask(rm, task)) {
+                dispatcher->error = "ready task pushing error";
+                return false;
+            }
+
+            rm->context->tasks[task].task_status = TASK_STATUS_QUEUED;
+        }
+    }
+
+    return true;
+}
+
+// Parse the next chunk of the streamed config and take the tasks it admits.
+static bool PumpConfigInput(Dispatcher* dispatcher) {
+    ResourceManager* rm = dispatcher->rm;
+
+    int status = PumpConfigStream(rm->stream);
+    if (status == -1) {
+        dispatcher->error = rm->stream->error ? rm->stream->error : "config reading error";
+        return false;
+    }
+
+    if (status == 0) {
+        if (dispatcher->config_source) {
+            UnwatchEventSource(rm->event_loop, dispatcher->config_source);
+            dispatcher->config_source = NULL;
+        }
+        dispatcher->config_open = false;
+        dispatcher->config_done_ns = GetTimeNs(CLOCK_MONOTONIC);
+    }
+
+    return ReceiveStreamedTasks(dispatcher);
+}
+
+static bool OnConfigInput(EventSource* source, uint32_t events) {
+    Dispatcher* dispatcher = source->data;
+
+    return PumpConfigInput(dispatcher) && DispatchReadyTasks(dispatcher);
+}
+
+// Errors of the streamed config are config errors, whichever handler ran into them.
+static MasterStatus GetFailureStatus(const ResourceManager* rm) {
+    return rm->stream && rm->stream->error ? MASTER_STATUS_CONFIG_ERROR : MASTER_STATUS_INTERNAL_ERROR;
+}
+
+// Move stdin to a close-on-exec descriptor and give tasks /dev/null instead, so they can't read the config.
+// Returns -1 on error.
+static int TakeConfigInput(void) {
+    int fd = fcntl(STDIN_FILENO, F_DUPFD_CLOEXEC, 0);
+    if (fd == -1) {
+        return -1;
+    }
+
+    int null_fd = open("/dev/null", O_RDONLY);
+    if (null_fd == -1 || dup2(null_fd, STDIN_FILENO) == -1) {
+        int saved_errno = errno;
+        if (null_fd != -1) {
+            close(null_fd);
+        }
+        close(fd);
+        errno = saved_errno;
+        return -1;
+    }
+
+    close(null_fd);
+    return fd;
+}
+
 static MasterResult AbortMaster(const char* message, int error_code, ResourceManager* rm) {
     MasterResult res = {
         .status = error_code,
@@ -80,12 +733,32 @@ static MasterResult AbortMaster(const char* message, int error_code, ResourceMan
 MasterResult RunMaster(const MasterArgs* args) {
     ResourceManager rm = {
         .input_file = NULL,
+        .cache_path = NULL,
+        .config_fd = -1,
+        .stream = NULL,
         .config = NULL,
         .graph = NULL,
-        .string_map = NULL,
+        .tracker = NULL,
         .pid_to_idx = NULL,
         .queue = NULL,
-        .context = NULL
+        .heap = NULL,
+        .priorities = NULL,
+        .blocked = NULL,
+        .skipped = NULL,
+        .slot_chunks = NULL,
+        .num_slots = 0,
+        .timer_wheel = NULL,
+        .wheel_timer_fd = -1,
+        .wheel_timer_armed = false,
+        .history = NULL,
+        .trace = NULL,
+        .stats = NULL,
+        .context = NULL,
+        .event_loop = NULL,
+        .child_signal_fd = -1,
+        .render_timer_fd = -1,
+        .pressure_timer_fd = -1,
+        .signal_mask_changed = false
     };
 
     // TODO:
@@ -95,229 +768,406 @@ MasterResult RunMaster(const MasterArgs* args) {
     // * initialize task queue
     // * process tasks
 
-    // Parsing config
-    FILE* config_file = fopen(args->config_path, "r");
-    if (!config_file) {
-        return AbortMaster("reading file error", MASTER_STATUS_BAD_FILE, &rm);
-    }
-    rm.input_file = config_file;
+    // Startup phases are timed for --stats
+    int64_t startup_ns = GetTimeNs(CLOCK_MONOTONIC);
+    int64_t parse_ns = 0, graph_build_ns = 0, cycle_check_ns = 0;
 
-    ExecutionConfig* config = ReadExecutionConfig(config_file, args->log_path);
-    if (!config) {
-        return AbortMaster("config construction error", MASTER_STATUS_CONFIG_ERROR, &rm);
-    }
-    rm.config = config;
+    bool streamed = strcmp(args->config_path, STDIN_CONFIG_PATH) == 0;
+    bool from_cache = false;
+    Graph* graph = NULL;
+    ExecutionConfig* config;
+    int status = 1;
 
-    if (config->num_tasks == 0) {
-        fprintf(stderr, "No tasks to be executed\n");
-        return AbortMaster("Success", MASTER_STATUS_SUCCESS, &rm);
-    }
+    if (streamed) {
+        // Tasks start while the rest of the config is still arriving, so there is nothing to cache
+        rm.config_fd = TakeConfigInput();
+        if (rm.config_fd == -1) {
+            return AbortMaster("reading file error", MASTER_STATUS_BAD_FILE, &rm);
+        }
 
-    // Mapping task names to indices
-    StringMap* string_map = NewStringMap(config->num_tasks * 2); // Multiplication by two for the purpose of incomplete filling of the map
-    if (!string_map) {
-        return AbortMaster("string map construction error", MASTER_STATUS_INTERNAL_ERROR, &rm);
-    }
-    rm.string_map = string_map;
+        rm.stream = NewConfigStream(rm.config_fd, args->log_path);
+        if (!rm.stream) {
+            return AbortMaster("config stream creation error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+        }
+        config = rm.stream->config;
+        rm.config = config;
 
-    int status;
+        // Concurrency and budgets have to be final before the first task starts
+        while (!IsConfigStreamSettled(rm.stream)) {
+            status = PumpConfigStream(rm.stream);
+            if (status == -1) {
+                return AbortMaster("config construction error", MASTER_STATUS_CONFIG_ERROR, &rm);
+            }
+        }
+        parse_ns = GetTimeNs(CLOCK_MONOTONIC);
 
-    int value;
-    for (int i = 0; i < config->num_tasks; ++i) {
-        status = SetStringMapValue(string_map, config->tasks[i]->name, i, false);
-        if (!status) {
-            return AbortMaster("tasks with the same name occured", MASTER_STATUS_CONFIG_ERROR, &rm);
+        if (status == 0 && config->num_tasks == 0) {
+            fprintf(stderr, "No tasks to be executed\n");
+            return AbortMaster("Success", MASTER_STATUS_SUCCESS, &rm);
         }
-    }
+    } else {
+        // Parsing config
+        FILE* config_file = fopen(args->config_path, "r");
+        if (!config_file) {
+            return AbortMaster("reading file error", MASTER_STATUS_BAD_FILE, &rm);
+        }
+        rm.input_file = config_file;
 
-    // Clarifying, that all reqirements exists
-    size_t req_len;
-    for (int i = 0; i < config->num_tasks; ++i) {
-        req_len = GetStringVectorLength(config->tasks[i]->requirements); 
+        ConfigBuffer config_text;
+        if (!LoadConfigBuffer(config_file, &config_text)) {
+            return AbortMaster("reading file error", MASTER_STATUS_BAD_FILE, &rm);
+        }
 
-        for (int k = 0; k < req_len; ++k) {
-            const char* required = GetStringVectorElement(config->tasks[i]->requirements, k);
+        // Unchanged configs come precompiled from the cache beside them, validated and with the graph built
+        uint64_t cache_key = HashDagCacheKey(&config_text, args->log_path);
+        char* cache_path = GetDagCachePath(args->config_path);
+        if (!cache_path) {
+            ReleaseConfigBuffer(&config_text);
+            return AbortMaster("cache path construction error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+        }
+        rm.cache_path = cache_path;
 
-            if (strcmp(required, "none") == 0) {
-                if (req_len == 1) {
-                    break;
-                } else {
-                    return AbortMaster("none occured in task requirements", MASTER_STATUS_CONFIG_ERROR, &rm);
-                }
-            } 
+        config = LoadDagCache(cache_path, cache_key, &graph);
+        from_cache = config != NULL;
 
-            status = GetStringMapValue(
-                string_map,
-                required,
-                &value
-            );
+        if (from_cache) {
+            ReleaseConfigBuffer(&config_text);
+            rm.config = config;
+            rm.graph = graph;
+            parse_ns = GetTimeNs(CLOCK_MONOTONIC);
+        } else {
+            config = ParseExecutionConfig(&config_text, args->log_path);
+            if (!config) {
+                return AbortMaster("config construction error", MASTER_STATUS_CONFIG_ERROR, &rm);
+            }
+            rm.config = config;
+            parse_ns = GetTimeNs(CLOCK_MONOTONIC);
 
-            if (!status) {
-                return AbortMaster("invalid task requirements", MASTER_STATUS_CONFIG_ERROR, &rm);
+            if (config->num_tasks == 0) {
+                fprintf(stderr, "No tasks to be executed\n");
+                return AbortMaster("Success", MASTER_STATUS_SUCCESS, &rm);
             }
-        }
-    }
 
-    // Building dependency graph
-    Graph* graph = NewGraph(config->num_tasks);
-    if (!graph) {
-        return AbortMaster("graph construction error", MASTER_STATUS_INTERNAL_ERROR, &rm);
-    }
-    rm.graph = graph;
+            // Building dependency graph, requirements were resolved to task indices while parsing
+            graph = NewGraph(config->num_tasks);
+            if (!graph) {
+                return AbortMaster("graph construction error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+            }
+            rm.graph = graph;
 
-    int graph_size = GetGraphSize(graph);
+            for (int i = 0; i < config->num_tasks; i++) {
+                const TaskConfig* task_config = config->tasks[i];
 
-    for (int i = 0; i < config->num_tasks; i++) {
-        req_len = GetStringVectorLength(config->tasks[i]->requirements); 
-    
-        for (int k = 0; k < req_len; ++k) {
-            const char* required = GetStringVectorElement(config->tasks[i]->requirements, k);
+                for (size_t k = 0; k < task_config->num_dependencies; ++k) {
+                    status = AddDirectedEdge(graph, i, task_config->dependencies[k]);
+                    if (!status) {
+                        return AbortMaster("graph construction error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+                    }
+                }
+            }
 
-            if (strcmp(required, "none") == 0) {
-                break;
+            if (!CompileGraph(graph)) {
+                return AbortMaster("graph construction error", MASTER_STATUS_INTERNAL_ERROR, &rm);
             }
 
-            GetStringMapValue(
-                string_map,
-                required,
-                &value
-            );
+            graph_build_ns = GetTimeNs(CLOCK_MONOTONIC);
 
-            status = AddDirectedEdge(graph, i, value);
-            if (!status) {
-                return AbortMaster("graph construction error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+            // Clarifying, that there are no cycles
+            if (!IsAcyclic(graph)) {
+                return AbortMaster("cycle in requirements exists", MASTER_STATUS_CONFIG_ERROR, &rm);
             }
+            cycle_check_ns = GetTimeNs(CLOCK_MONOTONIC);
+
+            // The cache only saves time, e.g. a read-only config directory just leaves it out
+            WriteDagCache(cache_path, cache_key, config, graph);
         }
+
     }
 
-    // Clarifying, that there are no cycles
-    if (!IsAcyclic(graph)) {
-        return AbortMaster("cycle in requirements exists", MASTER_STATUS_CONFIG_ERROR, &rm);
+    DependencyTracker* tracker = streamed ? NewGrowingDependencyTracker() : NewDependencyTracker(graph);
+    if (!tracker) {
+        return AbortMaster("dependency tracker construction error", MASTER_STATUS_INTERNAL_ERROR, &rm);
     }
+    rm.tracker = tracker;
 
-    // Creating context and thread for table rendering
+    // Creating context for table rendering
     Context* context = NewContext(graph, config);
     if (!context) {
         return AbortMaster("context creation error", MASTER_STATUS_INTERNAL_ERROR, &rm);    
     }
     rm.context = context;
 
-    bool do_render = true;
-    RenderStruct render_struct = {
-        .context = context,
-        .drawer_sleep_duration = args->drawer_sleep_duration,
-        .redraw = true,
-        .verbosity_type = args->verbosity_type,
-        .do_render = &do_render
-    };
+    // Loading runtime history of previous runs
+    char* history_path = JoinPath(args->log_path, HISTORY_FILE_NAME);
+    if (!history_path) {
+        return AbortMaster("history path construction error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+    }
 
-    DrawContext(context, args->verbosity_type, false);
+    rm.history = NewRuntimeHistory(history_path, config);
+    free(history_path);
+    if (!rm.history) {
+        return AbortMaster("history loading error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+    }
+    context->history = rm.history;
+    context->show_usage = args->show_usage;
+
+    // Recording the run timeline, the buffer covers every event of the run
+    if (args->trace_path) {
+        rm.trace = NewTraceRecorder(config->num_tasks);
+        if (!rm.trace) {
+            return AbortMaster("trace recorder construction error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+        }
+    }
+
+    if (args->show_stats) {
+        rm.stats = NewSchedulingStats(config->num_tasks);
+        if (!rm.stats) {
+            return AbortMaster("scheduling stats construction error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+        }
+    }
+
+    // Initialiaing ready set
+    if (args->schedule_type == SCHEDULE_TYPE_CRITICAL_PATH && streamed) {
+        fprintf(stderr, "Critical paths need the whole config, streamed tasks are started in FIFO order\n");
+    }
+
+    if (args->schedule_type == SCHEDULE_TYPE_CRITICAL_PATH && !streamed) {
+        long long* weights = malloc(sizeof(long long) * config->num_tasks);
+        rm.priorities = malloc(sizeof(long long) * config->num_tasks);
+        if (!weights || !rm.priorities) {
+            free(weights);
+            return AbortMaster("priorities allocation error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+        }
+
+        RuntimeStats stats;
+        for (int i = 0; i < config->num_tasks; ++i) {
+            bool known = GetTaskRuntimeStats(rm.history, i, &stats);
+            weights[i] = EstimateTaskDurationMs(config->tasks[i], known ? &stats : NULL);
+        }
+
+        status = ComputeCriticalPaths(graph, weights, rm.priorities);
+        free(weights);
+        if (!status) {
+            return AbortMaster("critical path computation error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+        }
 
-    pthread_t thread;
-    pthread_create(&thread, NULL, RenderFunc, &render_struct);
+        rm.heap = NewHeap(config->num_tasks);
+        if (!rm.heap) {
+            return AbortMaster("heap construction error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+        }
+    } else {
+        rm.queue = NewQueue();
+        if (!rm.queue) {
+            return AbortMaster("queue construction error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+        }
+    }
 
-    // Initialiaing queue
-    Queue* queue = NewQueue();
-    if (!queue) {
-        return AbortMaster("queue construction error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+    rm.blocked = NewIntVector(1);
+    rm.skipped = NewIntVector(1);
+    if (!rm.blocked || !rm.skipped) {
+        return AbortMaster("vector construction error", MASTER_STATUS_INTERNAL_ERROR, &rm);
     }
-    rm.queue = queue;
 
-    for (int i = 0; i < graph_size; ++i) {
-        if (!VertexHasSuccessors(graph, i)) {
-            status = Push(queue, i);
+    // Tasks of a streamed config are queued as they are admitted
+    for (int i = 0; i < GetGraphSize(graph); ++i) {
+        if (IsTaskReady(tracker, i)) {
+            MarkSchedulingStage(rm.stats, i, SCHEDULING_STAGE_READY);
+            status = PushReadyTask(&rm, i);
             if (!status) {
-                return AbortMaster("queue pushing error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+                return AbortMaster("ready task pushing error", MASTER_STATUS_INTERNAL_ERROR, &rm);
             }
 
             context->tasks[i].task_status = TASK_STATUS_QUEUED;
         }
     }
 
-    // Processing tasks
-    IntMap* pid_to_idx = NewIntMap(config->num_tasks * 2);
+    rm.timer_wheel = NewTimerWheel(GetMonotonicMs());
+    if (!EnsureTaskSlots(&rm, config->num_tasks) || !rm.timer_wheel) {
+        return AbortMaster("task processes allocation error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+    }
+
+    // The map grows with the number of tasks running at once
+    IntMap* pid_to_idx = NewIntMap(0);
     if (!pid_to_idx) {
         return AbortMaster("map creation error", MASTER_STATUS_INTERNAL_ERROR, &rm);    
     }
     rm.pid_to_idx = pid_to_idx;
 
-    int currently_working = 0, wait_status, front_value, completed_process_idx;
-    pid_t pid;
+    // Setting up event loop: process exits come through signalfd, renderings through timerfd
+    Dispatcher dispatcher = {
+        .rm = &rm,
+        .args = args,
+        .currently_working = 0,
+        .cpus_in_use = 0,
+        .memory_in_use_mb = 0,
+        .window_saturated = false,
+        .config_open = streamed && status != 0,
+        .config_source = NULL,
+        .config_done_ns = parse_ns,
+        .error = NULL
+    };
 
-    while (true) {
-        
-        // Forking all processes that are ready to work
-        while ( (currently_working != config->max_concurrent_tasks) && (!IsEmpty(queue)) ) {
-            status = Front(queue, &front_value);
-            if (!status) {
-                return AbortMaster("queue getting front elem error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+    EventLoop* event_loop = NewEventLoop();
+    if (!event_loop) {
+        return AbortMaster("event loop creation error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+    }
+    rm.event_loop = event_loop;
+
+    rm.child_signal_fd = OpenChildSignalFd(&rm.old_signal_mask);
+    if (rm.child_signal_fd == -1) {
+        return AbortMaster("signalfd creation error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+    }
+    rm.signal_mask_changed = true;
+
+    EventSource child_source = {
+        .fd = rm.child_signal_fd,
+        .handler = OnChildSignal,
+        .data = &dispatcher
+    };
+    if (!WatchEventSource(event_loop, &child_source, EPOLLIN)) {
+        return AbortMaster("event loop watching error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+    }
+
+    EventSource pressure_source = {
+        .fd = -1,
+        .handler = OnPressureTimer,
+        .data = &dispatcher
+    };
+
+    if (config->adaptive_concurrency) {
+        InitConcurrencyController(&dispatcher.concurrency, config->cpu_budget, config->max_concurrent_tasks);
+        context->concurrency_window = dispatcher.concurrency.window;
+
+        rm.pressure_timer_fd = OpenIntervalTimerFd(PRESSURE_SAMPLE_INTERVAL_MS);
+        if (rm.pressure_timer_fd == -1) {
+            return AbortMaster("timerfd creation error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+        }
+
+        pressure_source.fd = rm.pressure_timer_fd;
+        if (!WatchEventSource(event_loop, &pressure_source, EPOLLIN)) {
+            return AbortMaster("event loop watching error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+        }
+    }
+
+    // Every task deadline lives in the timer wheel driven by a single timerfd
+    rm.wheel_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (rm.wheel_timer_fd == -1) {
+        return AbortMaster("timerfd creation error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+    }
+
+    EventSource wheel_source = {
+        .fd = rm.wheel_timer_fd,
+        .handler = OnWheelTimer,
+        .data = &dispatcher
+    };
+    if (!WatchEventSource(event_loop, &wheel_source, EPOLLIN)) {
+        return AbortMaster("event loop watching error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+    }
+
+    // A config in a regular file can't be watched, it is parsed between polls instead
+    EventSource config_source = {
+        .fd = rm.config_fd,
+        .handler = OnConfigInput,
+        .data = &dispatcher
+    };
+
+    if (dispatcher.config_open) {
+        if (WatchEventSource(event_loop, &config_source, EPOLLIN)) {
+            dispatcher.config_source = &config_source;
+        } else if (errno != EPERM) {
+            return AbortMaster("event loop watching error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+        }
+    }
+
+    if (streamed && !ReceiveStreamedTasks(&dispatcher)) {
+        return AbortMaster(dispatcher.error, MASTER_STATUS_INTERNAL_ERROR, &rm);
+    }
+
+    bool redraw_on_events = false;
+    EventSource render_source = {
+        .fd = -1,
+        .handler = OnRenderTimer,
+        .data = &dispatcher
+    };
+
+    if (args->verbosity_type != VERBOSITY_TYPE_NONE) {
+        if (args->drawer_sleep_duration == 0) {
+            redraw_on_events = true;
+        } else {
+            rm.render_timer_fd = OpenIntervalTimerFd(args->drawer_sleep_duration * 1000);
+            if (rm.render_timer_fd == -1) {
+                return AbortMaster("timerfd creation error", MASTER_STATUS_INTERNAL_ERROR, &rm);
             }
 
-            status = Pop(queue);
-            if (!status) {
-                return AbortMaster("queue popping error", MASTER_STATUS_INTERNAL_ERROR, &rm);
-            }  
-            
-            pid = fork();
-            if (pid == -1) {
-                return AbortMaster("fork error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+            render_source.fd = rm.render_timer_fd;
+            if (!WatchEventSource(event_loop, &render_source, EPOLLIN)) {
+                return AbortMaster("event loop watching error", MASTER_STATUS_INTERNAL_ERROR, &rm);
             }
+        }
+    }
 
-            if (pid == 0) {
-                HandleTask(config->tasks[front_value]);
-            } else {
-                status = SetIntMapValue(pid_to_idx, pid, front_value, false);
-                if (!status) {
-                    return AbortMaster("int map setting value error", MASTER_STATUS_INTERNAL_ERROR, &rm);
-                }
+    DrawContext(context, args->verbosity_type, false);
 
-                context->tasks[front_value].task_status = TASK_STATUS_RUNNING;
-            }
+    // Processing tasks
+    struct timespec run_start, run_end;
+    clock_gettime(CLOCK_MONOTONIC, &run_start);
+
+    if (!DispatchReadyTasks(&dispatcher)) {
+        return AbortMaster(dispatcher.error, MASTER_STATUS_INTERNAL_ERROR, &rm);
+    }
 
-            currently_working++;
+    while (dispatcher.currently_working != 0 || HasReadyTasks(&rm) || GetIntVectorLength(rm.blocked) != 0 ||
+           dispatcher.config_open)
+    {
+        bool pump_inline = dispatcher.config_open && !dispatcher.config_source;
+        if (pump_inline && (!PumpConfigInput(&dispatcher) || !DispatchReadyTasks(&dispatcher))) {
+            return AbortMaster(dispatcher.error, GetFailureStatus(&rm), &rm);
+        } else if (pump_inline && !dispatcher.config_open) {
+            continue;
         }
 
-        // Waiting for one process to stop working and processing it
-        pid = wait(&wait_status);
-        status = GetIntMapValue(pid_to_idx, pid, &completed_process_idx);
-        if (!status) {
-            return AbortMaster("int map getting value error", MASTER_STATUS_INTERNAL_ERROR, &rm);
-        }
-
-        context->tasks[completed_process_idx].worker_status = wait_status;
-        currently_working--;
-
-        // Dependency resolution
-        if (WIFEXITED(wait_status)) {
-            for (int i = 0; i < graph_size; ++i) {
-                if (graph->matrix_[ completed_process_idx * graph_size + i ] == 1) {
-                    graph->matrix_[ completed_process_idx * graph_size + i ] = 0;
-
-                    if ((context->tasks[i].task_status != TASK_STATUS_FAILED) && 
-                        !VertexHasSuccessors(graph, i))
-                    {
-                        status = Push(queue, i);
-                        if (!status) {
-                            return AbortMaster("queue pushing error", MASTER_STATUS_INTERNAL_ERROR, &rm);
-                        }
-                        
-                        context->tasks[i].task_status = TASK_STATUS_QUEUED;
-                    }
-                }
-            }
+        if (!RearmWheelTimerFd(&rm)) {
+            return AbortMaster("timerfd arming error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+        }
 
-            context->tasks[completed_process_idx].task_status = TASK_STATUS_SUCCESS;
-        } else {
-            FailingTaskUpperNeighbors(graph, completed_process_idx, context);
+        if (PollEventLoop(event_loop, pump_inline ? 0 : -1) == -1) {
+            if (!dispatcher.error) {
+                dispatcher.error = "event loop polling error";
+            }
+            return AbortMaster(dispatcher.error, GetFailureStatus(&rm), &rm);
         }
 
-        if (currently_working == 0 && IsEmpty(queue)) {
-            do_render = false;
-            pthread_join(thread, NULL);
+        if (redraw_on_events) {
             DrawContext(context, args->verbosity_type, true);
-            break;
         }
-    };
+    }
+
+    DrawContext(context, args->verbosity_type, true);
+
+    clock_gettime(CLOCK_MONOTONIC, &run_end);
+    double makespan = (run_end.tv_sec - run_start.tv_sec) + (run_end.tv_nsec - run_start.tv_nsec) / 1e9;
+    fprintf(stderr, "Makespan: %.6f s\n", makespan);
+    if (args->show_stats && streamed) {
+        fprintf(stderr, "Startup, ms: settled %.3f, config streamed %.3f\n",
+                (parse_ns - startup_ns) / 1e6,
+                (dispatcher.config_done_ns - startup_ns) / 1e6);
+    } else if (args->show_stats && from_cache) {
+        fprintf(stderr, "Startup, ms: cache load %.3f\n", (parse_ns - startup_ns) / 1e6);
+    } else if (args->show_stats) {
+        fprintf(stderr, "Startup, ms: parse %.3f, graph build %.3f, cycle check %.3f\n",
+                (parse_ns - startup_ns) / 1e6,
+                (graph_build_ns - parse_ns) / 1e6,
+                (cycle_check_ns - graph_build_ns) / 1e6);
+    }
+    PrintSchedulingStats(rm.stats, stderr);
+
+    if (args->report_path && !WriteRunReport(args->report_path, context, makespan)) {
+        return AbortMaster("run report writing error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+    }
+
+    if (args->trace_path && !WriteTrace(rm.trace, config, args->trace_path)) {
+        return AbortMaster("trace writing error", MASTER_STATUS_INTERNAL_ERROR, &rm);
+    }
 
     return AbortMaster("Success", MASTER_STATUS_SUCCESS, &rm);
 }
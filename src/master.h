@@ -1,14 +1,33 @@
 #pragma once
 
-#include <pthread.h>
+#include <time.h>
 
 #include "context.h"
 #include "config.h"
-#include "handler.h"
+#include "scheduler.h"
+#include "heap.h"
+#include "event_loop.h"
+#include "pressure.h"
+#include "task_process.h"
+#include "timer_wheel.h"
+#include "report.h"
+#include "trace.h"
+#include "latency.h"
+#include "dag_cache.h"
+
+typedef enum ScheduleType {
+    SCHEDULE_TYPE_FIFO,           // start ready tasks in the order they became ready
+    SCHEDULE_TYPE_CRITICAL_PATH,  // start the ready task with the longest remaining downstream path first
+} ScheduleType;
 
 typedef struct MasterArgs {
     char* config_path;  // path to execution config
     char* log_path;     // path to log directory
+    ScheduleType schedule_type;  // order in which ready tasks are started
+    char* report_path;  // path to JSON run report, or NULL
+    bool show_usage;    // render resource usage columns of finished tasks
+    char* trace_path;   // path to Chrome trace-event JSON of the run, or NULL
+    bool show_stats;    // print scheduling latency percentiles at the end of the run
 
     // use the following fields only in case you want to implement verbose task status rendering
     VerbosityType verbosity_type;        // task status rendering mode
@@ -0,0 +1,110 @@
+#include "mpmc_queue.h"
+
+MpmcQueue* NewMpmcQueue(size_t capacity) {
+    size_t rounded = 2;
+    while (rounded < capacity) {
+        rounded *= 2;
+    }
+
+    // The position counters are aligned to cache lines, so is the queue itself
+    MpmcQueue* res = aligned_alloc(_Alignof(MpmcQueue), sizeof(MpmcQueue));
+    if (!res) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    res->cells_ = malloc(sizeof(MpmcQueueCell) * rounded);
+    if (!res->cells_) {
+        free(res);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    for (size_t i = 0; i < rounded; ++i) {
+        atomic_init(&res->cells_[i].sequence_, i);
+    }
+    res->mask_ = rounded - 1;
+    atomic_init(&res->push_pos_, 0);
+    atomic_init(&res->pop_pos_, 0);
+
+    return res;
+}
+
+void FreeMpmcQueue(MpmcQueue* queue) {
+    if (queue == NULL) {
+        return;
+    }
+
+    free(queue->cells_);
+    free(queue);
+}
+
+bool PushMpmcQueue(MpmcQueue* queue, int elem) {
+    if (queue == NULL) {
+        errno = EINVAL;
+        return false;
+    }
+
+    size_t pos = atomic_load_explicit(&queue->push_pos_, memory_order_relaxed);
+    MpmcQueueCell* cell;
+
+    while (true) {
+        cell = &queue->cells_[pos & queue->mask_];
+        size_t sequence = atomic_load_explicit(&cell->sequence_, memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+
+        if (diff == 0) {
+            // The cell is free for this position, claim it; a failed exchange reloads pos
+            if (atomic_compare_exchange_weak_explicit(
+                    &queue->push_pos_, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+        } else if (diff < 0) {
+            // Still holding the element pushed one lap ago
+            errno = EAGAIN;
+            return false;
+        } else {
+            pos = atomic_load_explicit(&queue->push_pos_, memory_order_relaxed);
+        }
+    }
+
+    cell->value_ = elem;
+    atomic_store_explicit(&cell->sequence_, pos + 1, memory_order_release);
+    return true;
+}
+
+bool PopMpmcQueue(MpmcQueue* queue, int* elem) {
+    if (queue == NULL || elem == NULL) {
+        errno = EINVAL;
+        return false;
+    }
+
+    size_t pos = atomic_load_explicit(&queue->pop_pos_, memory_order_relaxed);
+    MpmcQueueCell* cell;
+
+    while (true) {
+        cell = &queue->cells_[pos & queue->mask_];
+        size_t sequence = atomic_load_explicit(&cell->sequence_, memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(
+                    &queue->pop_pos_, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+        } else if (diff < 0) {
+            // Nothing published at this position yet
+            errno = EAGAIN;
+            return false;
+        } else {
+            pos = atomic_load_explicit(&queue->pop_pos_, memory_order_relaxed);
+        }
+    }
+
+    *elem = cell->value_;
+    // Free the cell for the push one lap ahead
+    atomic_store_explicit(&cell->sequence_, pos + queue->mask_ + 1, memory_order_release);
+    return true;
+}
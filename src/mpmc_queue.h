@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#define MPMC_QUEUE_CACHE_LINE 64
+
+// Every cell carries a sequence number telling whose turn it is: pos when it's free for the push at pos,
+// pos + 1 once that push has published its value for the pop at pos.
+typedef struct MpmcQueueCell {
+    atomic_size_t sequence_;
+    int value_;
+} MpmcQueueCell;
+
+// Bounded lock-free queue of ints for any number of producer and consumer threads (Vyukov's design).
+// Producers and consumers only contend on their own position counter, each on its own cache line,
+// and hand elements over through the cells without locks.
+typedef struct MpmcQueue {
+    MpmcQueueCell* cells_;
+    size_t mask_;  // capacity - 1, capacity is a power of two
+    _Alignas(MPMC_QUEUE_CACHE_LINE) atomic_size_t push_pos_;
+    _Alignas(MPMC_QUEUE_CACHE_LINE) atomic_size_t pop_pos_;
+} MpmcQueue;
+
+// Create new queue holding at least capacity elements, rounded up to a power of two.
+// Returns NULL on error.
+MpmcQueue* NewMpmcQueue(size_t capacity);
+
+// Free queue instance, no thread may be using it anymore.
+// Ignores NULL instance.
+void FreeMpmcQueue(MpmcQueue* queue);
+
+// Push element to the queue, safe to call from any thread.
+// Returns false and sets errno to EAGAIN if the queue is full.
+bool PushMpmcQueue(MpmcQueue* queue, int elem);
+
+// Pop the front element into elem, safe to call from any thread.
+// Returns false and sets errno to EAGAIN if the queue is empty.
+bool PopMpmcQueue(MpmcQueue* queue, int* elem);
@@ -0,0 +1,107 @@
+#include "pressure.h"
+
+// Parse `<kind> avg10=.. avg60=.. avg300=.. total=<us>` line of a PSI file.
+static bool ReadPsiTotal(const char* path, const char* kind, uint64_t* total_us) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+
+    char line_kind[8];
+    double avg10, avg60, avg300;
+    unsigned long long total;
+    bool found = false;
+
+    while (fscanf(file, "%7s avg10=%lf avg60=%lf avg300=%lf total=%llu",
+                  line_kind, &avg10, &avg60, &avg300, &total) == 5) {
+        if (strcmp(line_kind, kind) == 0) {
+            *total_us = total;
+            found = true;
+            break;
+        }
+    }
+
+    fclose(file);
+    return found;
+}
+
+bool ReadPressureSample(PressureSample* sample) {
+    if (!sample) {
+        errno = EINVAL;
+        return false;
+    }
+
+    sample->taken_ns = GetTimeNs(CLOCK_MONOTONIC);
+    sample->has_psi = ReadPsiTotal("/proc/pressure/cpu", "some", &sample->cpu_some_us) &&
+                      ReadPsiTotal("/proc/pressure/io", "full", &sample->io_full_us);
+
+    bool has_load = false;
+    FILE* file = fopen("/proc/loadavg", "r");
+    if (file) {
+        has_load = fscanf(file, "%lf", &sample->load1) == 1;
+        fclose(file);
+    }
+
+    if (!has_load) {
+        sample->load1 = 0;
+    }
+
+    return sample->has_psi || has_load;
+}
+
+void InitConcurrencyController(ConcurrencyController* controller, int num_cpus, int max_window) {
+    if (!controller) {
+        return;
+    }
+
+    controller->num_cpus = num_cpus > 0 ? num_cpus : 1;
+    controller->slow_start = true;
+    controller->max_window = max_window > 0 ? max_window : 1;
+    // As many tasks as CPUs can't stall each other on CPU, so don't shrink below that
+    controller->min_window = controller->num_cpus < controller->max_window ? controller->num_cpus : controller->max_window;
+    controller->window = controller->min_window;
+
+    if (!ReadPressureSample(&controller->last_sample)) {
+        memset(&controller->last_sample, 0, sizeof(controller->last_sample));
+    }
+}
+
+static bool IsCongested(const ConcurrencyController* controller, const PressureSample* sample) {
+    const PressureSample* last = &controller->last_sample;
+
+    if (sample->has_psi && last->has_psi && sample->taken_ns > last->taken_ns) {
+        double interval_us = (sample->taken_ns - last->taken_ns) / 1000.0;
+        double cpu_stall = (sample->cpu_some_us - last->cpu_some_us) / interval_us;
+        double io_stall = (sample->io_full_us - last->io_full_us) / interval_us;
+
+        if (cpu_stall > CPU_PRESSURE_THRESHOLD || io_stall > IO_PRESSURE_THRESHOLD) {
+            return true;
+        }
+    }
+
+    return sample->load1 > LOAD_PER_CPU_THRESHOLD * controller->num_cpus;
+}
+
+int UpdateConcurrencyWindow(ConcurrencyController* controller, const PressureSample* sample, bool saturated) {
+    if (!controller || !sample) {
+        errno = EINVAL;
+        return 0;
+    }
+
+    if (IsCongested(controller, sample)) {
+        controller->window /= 2;
+        controller->slow_start = false;
+    } else if (saturated) {
+        controller->window = controller->slow_start ? controller->window * 2 : controller->window + 1;
+    }
+
+    if (controller->window < controller->min_window) {
+        controller->window = controller->min_window;
+    }
+    if (controller->window > controller->max_window) {
+        controller->window = controller->max_window;
+    }
+
+    controller->last_sample = *sample;
+    return controller->window;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include "utils.h"
+
+// Stall fraction of the last sampling interval above which the system counts as congested
+#define CPU_PRESSURE_THRESHOLD 0.25
+#define IO_PRESSURE_THRESHOLD 0.10
+// 1-minute load average per CPU above which the system counts as congested
+#define LOAD_PER_CPU_THRESHOLD 1.5
+
+// Snapshot of Linux PSI counters and load average.
+typedef struct PressureSample {
+    int64_t taken_ns;         // CLOCK_MONOTONIC time of the sample
+    bool has_psi;             // false on kernels without /proc/pressure
+    uint64_t cpu_some_us;     // cumulative time some tasks were stalled on CPU
+    uint64_t io_full_us;      // cumulative time all tasks were stalled on IO
+    double load1;             // 1-minute load average
+} PressureSample;
+
+// AIMD controller of the dispatch window:
+// doubles per uncongested interval until the first congestion (slow start),
+// then grows by one task per uncongested interval, halves on congestion.
+typedef struct ConcurrencyController {
+    int window;         // current number of tasks allowed to run
+    bool slow_start;
+    int min_window;
+    int max_window;
+    int num_cpus;
+    PressureSample last_sample;
+} ConcurrencyController;
+
+// Read current PSI counters and load average.
+// Returns false only if neither source could be read.
+bool ReadPressureSample(PressureSample* sample);
+
+// Initialize controller with a window of num_cpus, capped by max_window.
+// The window never shrinks below its initial value.
+void InitConcurrencyController(ConcurrencyController* controller, int num_cpus, int max_window);
+
+// Feed a new sample into the controller.
+// Window grows only if it was saturated during the interval, so idle periods don't inflate it.
+// Returns the updated window.
+int UpdateConcurrencyWindow(ConcurrencyController* controller, const PressureSample* sample, bool saturated);
@@ -8,9 +8,16 @@ Queue* NewQueue(void) {
         return NULL;
     }
 
-    res->first = NULL;
-    res->last = NULL;
-    res->is_empty = true;
+    res->items_ = malloc(sizeof(int) * QUEUE_INITIAL_CAPACITY);
+    if (!res->items_) {
+        free(res);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    res->capacity_ = QUEUE_INITIAL_CAPACITY;
+    res->head_ = 0;
+    res->len_ = 0;
 
     return res;
 }
@@ -20,28 +27,29 @@ void FreeQueue(Queue* queue) {
         return;
     }
 
-    if (queue->first == NULL) {
-        free(queue);
-        queue = NULL;
-        return;
-    }
-
-    Node* cur_node = queue->first;
-    Node* next_node;
+    free(queue->items_);
+    free(queue);
+}
 
-    while (true) {
-        next_node = cur_node->next_;
-        free(cur_node);
+// Double the buffer, the part wrapped around to the start is moved right past the old end,
+// so the elements stay in order from head_.
+// Returns false on error.
+static bool GrowQueue(Queue* queue) {
+    size_t old_capacity = queue->capacity_;
 
-        if (next_node == NULL) {
-            break;
-        }
+    int* items = realloc(queue->items_, sizeof(int) * old_capacity * 2);
+    if (!items) {
+        errno = ENOMEM;
+        return false;
+    }
 
-        cur_node = next_node;
+    if (queue->head_ + queue->len_ > old_capacity) {
+        memcpy(items + old_capacity, items, sizeof(int) * (queue->head_ + queue->len_ - old_capacity));
     }
 
-    free(queue);
-    queue = NULL;
+    queue->items_ = items;
+    queue->capacity_ = old_capacity * 2;
+    return true;
 }
 
 bool Push(Queue* queue, int elem) {
@@ -50,24 +58,12 @@ bool Push(Queue* queue, int elem) {
         return false;
     }
 
-    Node* node = malloc(sizeof(Node));
-    if (!node) {
-        errno = ENOMEM;
+    if (queue->len_ == queue->capacity_ && !GrowQueue(queue)) {
         return false;
     }
 
-    node->value_ = elem;
-    node->next_ = NULL;
-
-    if (queue->first == NULL) {
-        queue->first = node;
-    } else {
-        queue->last->next_ = node;
-    }
-
-    node->prev_ = queue->last;
-    queue->last = node;
-    queue->is_empty = false;
+    queue->items_[(queue->head_ + queue->len_) & (queue->capacity_ - 1)] = elem;
+    queue->len_++;
     return true;
 }
 
@@ -77,11 +73,11 @@ bool Front(const Queue* queue, int* elem) {
         return false;
     }
 
-    if (queue->first == NULL) {
+    if (queue->len_ == 0) {
         return false;
     }
-    
-    *elem = queue->first->value_;
+
+    *elem = queue->items_[queue->head_];
     return true;
 }
 
@@ -91,35 +87,15 @@ bool Pop(Queue* queue) {
         return false;
     }
 
-    if (queue->first == queue->last) {
-        free(queue->first);
-        queue->first = NULL;
-        queue->last = NULL;
-        queue->is_empty = true;
-    } else {
-        Node* next_node = queue->first->next_;
-        free(queue->first);
-        queue->first = next_node;
+    if (queue->len_ == 0) {
+        return true;
     }
 
+    queue->head_ = (queue->head_ + 1) & (queue->capacity_ - 1);
+    queue->len_--;
     return true;
 }
 
 bool IsEmpty(const Queue* queue) {
-    return queue == NULL || queue->is_empty;
+    return queue == NULL || queue->len_ == 0;
 }
-
-// void PrintQueue(Queue* queue) {
-//     if (queue == NULL) {
-//         return;
-//     }
-
-//     Node* cur_node = queue->first;
-
-//     while (cur_node != NULL) {
-//         printf("%d ", cur_node->value_);
-//         cur_node = cur_node->next_;
-//     }
-
-//     fputc('\n', stdout);
-// }
\ No newline at end of file
@@ -4,17 +4,16 @@
 #include <errno.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
-typedef struct Node {
-    int value_;
-    struct Node* next_;
-    struct Node* prev_;
-} Node;
+#define QUEUE_INITIAL_CAPACITY 16
 
+// FIFO of ints in a growable ring buffer, elements live contiguously and nothing is allocated per push.
 typedef struct Queue {
-    Node* first;
-    Node* last;
-    bool is_empty;
+    int* items_;
+    size_t capacity_;  // power of two
+    size_t head_;      // index of the front element
+    size_t len_;
 } Queue;
 
 // Create new queue instance.
@@ -33,12 +32,9 @@ bool Push(Queue* queue, int elem);
 // Returns true on success, otherwise returns false and changes errno.
 bool Front(const Queue* queue, int* elem);
 
-// Pop element from a queue.
+// Pop element from a queue, popping an empty queue does nothing.
 // Returns true on success, otherwise returns false and changes errno.
 bool Pop(Queue* queue);
 
 // Checks if a queue is empty.
 bool IsEmpty(const Queue* queue);
-
-// Printing queue
-// void PrintQueue(Queue* queue);
\ No newline at end of file
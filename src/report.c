@@ -0,0 +1,81 @@
+#include "report.h"
+
+static const char* GetTaskStatusName(TaskStatus status) {
+    switch (status) {
+        case TASK_STATUS_QUEUED:
+            return "queued";
+        case TASK_STATUS_RUNNING:
+            return "running";
+        case TASK_STATUS_SUCCESS:
+            return "success";
+        case TASK_STATUS_FAILED:
+            return "failed";
+        case TASK_STATUS_SKIPPED:
+            return "skipped";
+        default:
+            return "unknown";
+    }
+}
+
+static void WriteTaskReport(FILE* file, const Context* context, size_t task) {
+    const TaskInfo* info = &context->tasks[task];
+    const TaskRunRecord* run = &info->run;
+    bool finished = info->task_status == TASK_STATUS_SUCCESS || info->task_status == TASK_STATUS_FAILED;
+
+    fprintf(file, "    {\"name\": ");
+    WriteJsonString(file, context->config->tasks[task]->name);
+    fprintf(file, ", \"status\": \"%s\"", GetTaskStatusName(info->task_status));
+
+    if (!finished) {
+        fprintf(file, "}");
+        return;
+    }
+
+    if (WIFEXITED(run->wait_status)) {
+        fprintf(file, ", \"exit_code\": %d", WEXITSTATUS(run->wait_status));
+    } else if (WIFSIGNALED(run->wait_status)) {
+        fprintf(file, ", \"signal\": %d", WTERMSIG(run->wait_status));
+    }
+
+    fprintf(file,
+            ", \"wall_ms\": %.3f, \"user_ms\": %.3f, \"sys_ms\": %.3f, \"max_rss_kb\": %u"
+            ", \"voluntary_switches\": %u, \"involuntary_switches\": %u"
+            ", \"block_input\": %u, \"block_output\": %u}",
+            (run->end_ns - run->start_ns) / 1e6,
+            run->user_cpu_us / 1e3,
+            run->system_cpu_us / 1e3,
+            run->max_rss_kb,
+            run->voluntary_switches,
+            run->involuntary_switches,
+            run->block_input,
+            run->block_output);
+}
+
+bool WriteRunReport(const char* path, const Context* context, double makespan_s) {
+    if (!path || !context || !context->tasks || !context->config) {
+        errno = EINVAL;
+        return false;
+    }
+
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        return false;
+    }
+
+    fprintf(file, "{\n  \"makespan_s\": %.6f,\n  \"tasks\": [\n", makespan_s);
+    for (size_t i = 0; i < context->config->num_tasks; ++i) {
+        WriteTaskReport(file, context, i);
+        fprintf(file, i + 1 < context->config->num_tasks ? ",\n" : "\n");
+    }
+    fprintf(file, "  ]\n}\n");
+
+    bool failed = ferror(file);
+    if (fclose(file) == EOF || failed) {
+        if (!errno) {
+            errno = EIO;
+        }
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <errno.h>
+#include <sys/wait.h>
+
+#include "context.h"
+
+// Write a machine-readable JSON report of a finished run into path:
+// makespan and, per task, its status, exit code or signal, wall time and resource usage.
+// Returns true on success, otherwise returns false and changes errno.
+bool WriteRunReport(const char* path, const Context* context, double makespan_s);
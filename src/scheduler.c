@@ -0,0 +1,448 @@
+#include "scheduler.h"
+
+static void* FailedTrackerCreation(DependencyTracker* tracker, int error_code) {
+    FreeDependencyTracker(tracker);
+    errno = error_code;
+    return NULL;
+}
+
+DependencyTracker* NewDependencyTracker(const Graph* graph) {
+    if (!graph) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    DependencyTracker* tracker = malloc(sizeof(DependencyTracker));
+    if (!tracker) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    size_t num_tasks = GetGraphSize(graph);
+    tracker->num_tasks_ = num_tasks;
+    tracker->capacity_ = num_tasks;
+    tracker->dependent_lists_ = NULL;
+    tracker->remaining_ = malloc(sizeof(int) * (num_tasks + 1));
+    tracker->dependents_offsets_ = malloc(sizeof(size_t) * (num_tasks + 1));
+    tracker->dependents_ = malloc(sizeof(int) * (GetEdgeCount(graph) + 1));
+    tracker->skipped_ = calloc(num_tasks / 64 + 1, sizeof(uint64_t));
+    tracker->succeeded_ = calloc(num_tasks / 64 + 1, sizeof(uint64_t));
+    tracker->failed_ = calloc(num_tasks / 64 + 1, sizeof(uint64_t));
+    tracker->stack_ = malloc(sizeof(int) * (num_tasks + 1));
+    if (!tracker->remaining_ || !tracker->dependents_offsets_ || !tracker->dependents_ ||
+        !tracker->skipped_ || !tracker->succeeded_ || !tracker->failed_ || !tracker->stack_)
+    {
+        return FailedTrackerCreation(tracker, ENOMEM);
+    }
+
+    // Requirements are graph successors, dependents are graph predecessors
+    size_t filled = 0;
+    for (size_t task = 0; task < num_tasks; ++task) {
+        size_t num_required, num_dependents;
+
+        if (!GetSuccessorArray(graph, task, &num_required)) {
+            return FailedTrackerCreation(tracker, errno);
+        }
+        const int* dependents = GetPredecessorArray(graph, task, &num_dependents);
+
+        tracker->remaining_[task] = num_required;
+        tracker->dependents_offsets_[task] = filled;
+        memcpy(tracker->dependents_ + filled, dependents, sizeof(int) * num_dependents);
+        filled += num_dependents;
+    }
+    tracker->dependents_offsets_[num_tasks] = filled;
+
+    return tracker;
+}
+
+DependencyTracker* NewGrowingDependencyTracker(void) {
+    DependencyTracker* tracker = malloc(sizeof(DependencyTracker));
+    if (!tracker) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    size_t capacity = TRACKER_INITIAL_CAPACITY;
+    tracker->num_tasks_ = 0;
+    tracker->capacity_ = capacity;
+    tracker->dependents_offsets_ = NULL;
+    tracker->dependents_ = NULL;
+    tracker->remaining_ = malloc(sizeof(int) * capacity);
+    tracker->dependent_lists_ = calloc(capacity, sizeof(IntVector*));
+    tracker->skipped_ = calloc(capacity / 64 + 1, sizeof(uint64_t));
+    tracker->succeeded_ = calloc(capacity / 64 + 1, sizeof(uint64_t));
+    tracker->failed_ = calloc(capacity / 64 + 1, sizeof(uint64_t));
+    tracker->stack_ = malloc(sizeof(int) * capacity);
+    if (!tracker->remaining_ || !tracker->dependent_lists_ || !tracker->skipped_ ||
+        !tracker->succeeded_ || !tracker->failed_ || !tracker->stack_)
+    {
+        return FailedTrackerCreation(tracker, ENOMEM);
+    }
+
+    return tracker;
+}
+
+void FreeDependencyTracker(DependencyTracker* tracker) {
+    if (!tracker) {
+        return;
+    }
+
+    if (tracker->dependent_lists_) {
+        for (size_t task = 0; task < tracker->num_tasks_; ++task) {
+            FreeIntVector(tracker->dependent_lists_[task]);
+        }
+    }
+
+    free(tracker->remaining_);
+    free(tracker->dependents_offsets_);
+    free(tracker->dependents_);
+    free(tracker->dependent_lists_);
+    free(tracker->skipped_);
+    free(tracker->succeeded_);
+    free(tracker->failed_);
+    free(tracker->stack_);
+    free(tracker);
+}
+
+static bool TestBit(const uint64_t* bits, size_t idx) {
+    return (bits[idx / 64] >> (idx % 64)) & 1;
+}
+
+static void SetBit(uint64_t* bits, size_t idx) {
+    bits[idx / 64] |= (uint64_t)1 << (idx % 64);
+}
+
+// Reallocate the bitset for new_capacity bits, clearing the added words.
+static bool GrowBitset(uint64_t** bits, size_t capacity, size_t new_capacity) {
+    uint64_t* new_bits = realloc(*bits, sizeof(uint64_t) * (new_capacity / 64 + 1));
+    if (!new_bits) {
+        return false;
+    }
+
+    memset(new_bits + capacity / 64 + 1, 0, sizeof(uint64_t) * (new_capacity / 64 - capacity / 64));
+    *bits = new_bits;
+    return true;
+}
+
+// Make room for num_tasks tasks, doubling the capacity.
+// Returns false on error.
+static bool GrowTracker(DependencyTracker* tracker, size_t num_tasks) {
+    if (num_tasks <= tracker->capacity_) {
+        return true;
+    }
+
+    size_t capacity = tracker->capacity_;
+    size_t new_capacity = capacity * 2 > num_tasks ? capacity * 2 : num_tasks;
+
+    int* remaining = realloc(tracker->remaining_, sizeof(int) * new_capacity);
+    if (remaining) {
+        tracker->remaining_ = remaining;
+    }
+    int* stack = realloc(tracker->stack_, sizeof(int) * new_capacity);
+    if (stack) {
+        tracker->stack_ = stack;
+    }
+    IntVector** lists = realloc(tracker->dependent_lists_, sizeof(IntVector*) * new_capacity);
+    if (lists) {
+        tracker->dependent_lists_ = lists;
+        memset(lists + capacity, 0, sizeof(IntVector*) * (new_capacity - capacity));
+    }
+
+    if (!remaining || !stack || !lists ||
+        !GrowBitset(&tracker->skipped_, capacity, new_capacity) ||
+        !GrowBitset(&tracker->succeeded_, capacity, new_capacity) ||
+        !GrowBitset(&tracker->failed_, capacity, new_capacity))
+    {
+        // Grown arrays are kept, the capacity only moves once all of them have grown
+        errno = ENOMEM;
+        return false;
+    }
+
+    tracker->capacity_ = new_capacity;
+    return true;
+}
+
+bool AddTrackedTask(DependencyTracker* tracker, size_t task, const int* requirements, size_t num_requirements) {
+    if (!tracker || !tracker->dependent_lists_ || (num_requirements && !requirements)) {
+        errno = EINVAL;
+        return false;
+    }
+
+    for (size_t i = 0; i < num_requirements; ++i) {
+        if (requirements[i] < 0 || requirements[i] >= tracker->num_tasks_ || requirements[i] == task) {
+            errno = ERANGE;
+            return false;
+        }
+    }
+
+    if (!GrowTracker(tracker, task + 1)) {
+        return false;
+    }
+
+    // Tasks in between are added later, they have to look untouched till then
+    for (size_t idx = tracker->num_tasks_; idx < task; ++idx) {
+        tracker->remaining_[idx] = 0;
+    }
+    if (task >= tracker->num_tasks_) {
+        tracker->num_tasks_ = task + 1;
+    }
+
+    int remaining = 0;
+    bool skipped = false;
+
+    for (size_t i = 0; i < num_requirements; ++i) {
+        int required = requirements[i];
+
+        if (TestBit(tracker->failed_, required) || TestBit(tracker->skipped_, required)) {
+            skipped = true;
+        } else if (!TestBit(tracker->succeeded_, required)) {
+            IntVector** dependents = &tracker->dependent_lists_[required];
+            if (!*dependents && !(*dependents = NewIntVector(1))) {
+                return false;
+            }
+
+            if (!AppendToIntVector(*dependents, task)) {
+                errno = ENOMEM;
+                return false;
+            }
+            remaining++;
+        }
+    }
+
+    tracker->remaining_[task] = remaining;
+    if (skipped) {
+        SetBit(tracker->skipped_, task);
+    }
+
+    return true;
+}
+
+void FinishTrackedTask(DependencyTracker* tracker, size_t task, bool succeeded) {
+    if (!tracker || task >= tracker->num_tasks_) {
+        return;
+    }
+
+    SetBit(succeeded ? tracker->succeeded_ : tracker->failed_, task);
+}
+
+size_t GetTrackedTaskCount(const DependencyTracker* tracker) {
+    if (!tracker) {
+        errno = EINVAL;
+        return 0;
+    }
+
+    return tracker->num_tasks_;
+}
+
+bool IsTaskReady(const DependencyTracker* tracker, size_t task) {
+    if (!tracker) {
+        errno = EINVAL;
+        return false;
+    }
+
+    if (task >= tracker->num_tasks_) {
+        errno = ERANGE;
+        return false;
+    }
+
+    return tracker->remaining_[task] == 0;
+}
+
+const int* GetDependents(const DependencyTracker* tracker, size_t task, size_t* count) {
+    if (!tracker || !count) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    if (task >= tracker->num_tasks_) {
+        errno = ERANGE;
+        *count = 0;
+        return NULL;
+    }
+
+    if (tracker->dependent_lists_) {
+        static const int kNoDependents[1];
+        const IntVector* dependents = tracker->dependent_lists_[task];
+
+        *count = dependents ? GetIntVectorLength(dependents) : 0;
+        return dependents ? GetIntVectorData(dependents) : kNoDependents;
+    }
+
+    *count = tracker->dependents_offsets_[task + 1] - tracker->dependents_offsets_[task];
+    return tracker->dependents_ + tracker->dependents_offsets_[task];
+}
+
+int ResolveRequirement(DependencyTracker* tracker, size_t task) {
+    if (!tracker) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (task >= tracker->num_tasks_ || tracker->remaining_[task] == 0) {
+        errno = ERANGE;
+        return -1;
+    }
+
+    return --tracker->remaining_[task];
+}
+
+int SkipDependents(DependencyTracker* tracker, size_t task, IntVector* skipped) {
+    if (!tracker) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (task >= tracker->num_tasks_) {
+        errno = ERANGE;
+        return -1;
+    }
+
+    // Iterative DFS, each task is pushed at most once since it is marked on push
+    int* stack = tracker->stack_;
+    size_t stack_len = 0;
+    int num_skipped = 0;
+
+    stack[stack_len++] = task;
+    while (stack_len > 0) {
+        int current = stack[--stack_len];
+
+        size_t num_dependents;
+        const int* dependents = GetDependents(tracker, current, &num_dependents);
+
+        for (size_t i = 0; i < num_dependents; ++i) {
+            int dependent = dependents[i];
+
+            if (TestBit(tracker->skipped_, dependent)) {
+                continue;
+            }
+
+            SetBit(tracker->skipped_, dependent);
+            stack[stack_len++] = dependent;
+            num_skipped++;
+
+            if (skipped && !AppendToIntVector(skipped, dependent)) {
+                return -1;
+            }
+        }
+    }
+
+    return num_skipped;
+}
+
+bool IsTaskSkipped(const DependencyTracker* tracker, size_t task) {
+    if (!tracker) {
+        errno = EINVAL;
+        return false;
+    }
+
+    if (task >= tracker->num_tasks_) {
+        errno = ERANGE;
+        return false;
+    }
+
+    return TestBit(tracker->skipped_, task);
+}
+
+long long EstimateTaskDurationMs(const TaskConfig* task, const RuntimeStats* stats) {
+    if (!task) {
+        errno = EINVAL;
+        return 0;
+    }
+
+    if (stats && stats->num_runs != 0) {
+        return stats->median_ms;
+    }
+
+    if (task->type == TASK_TYPE_SLEEP) {
+        return (long long)task->sleep_args->duration * 1000;
+    }
+
+    return DEFAULT_EXEC_ESTIMATE_MS;
+}
+
+// Tasks are visited after all of their dependents (reverse topological order),
+// so every dependent path is final by the time a requirement reads it.
+bool ComputeCriticalPaths(const Graph* graph, const long long* weights, long long* paths) {
+    if (!graph || !weights || !paths) {
+        errno = EINVAL;
+        return false;
+    }
+
+    size_t num_tasks = GetGraphSize(graph);
+    size_t* pending_dependents = malloc(sizeof(size_t) * (num_tasks + 1));
+    int* stack = malloc(sizeof(int) * (num_tasks + 1));
+    if (!pending_dependents || !stack) {
+        free(pending_dependents);
+        free(stack);
+        errno = ENOMEM;
+        return false;
+    }
+
+    size_t stack_len = 0;
+    for (size_t task = 0; task < num_tasks; ++task) {
+        if (!GetPredecessorArray(graph, task, &pending_dependents[task])) {
+            free(pending_dependents);
+            free(stack);
+            return false;
+        }
+
+        paths[task] = weights[task];
+        if (pending_dependents[task] == 0) {
+            stack[stack_len++] = task;
+        }
+    }
+
+    size_t num_visited = 0;
+    while (stack_len != 0) {
+        int task = stack[--stack_len];
+        num_visited++;
+
+        size_t num_required;
+        const int* required = GetSuccessorArray(graph, task, &num_required);
+
+        for (size_t i = 0; i < num_required; ++i) {
+            int requirement = required[i];
+
+            if (paths[requirement] < weights[requirement] + paths[task]) {
+                paths[requirement] = weights[requirement] + paths[task];
+            }
+
+            if (--pending_dependents[requirement] == 0) {
+                stack[stack_len++] = requirement;
+            }
+        }
+    }
+
+    free(pending_dependents);
+    free(stack);
+
+    if (num_visited != num_tasks) {
+        errno = EINVAL;
+        return false;
+    }
+
+    return true;
+}
+
+void InitBackfillWindow(BackfillWindow* window, unsigned int free_cpus, unsigned int free_memory_mb) {
+    window->free_cpus = free_cpus;
+    window->free_memory_mb = free_memory_mb;
+    window->has_reservation = false;
+}
+
+bool AdmitBackfillTask(BackfillWindow* window, unsigned int cpus, unsigned int memory_mb) {
+    if (cpus <= window->free_cpus && memory_mb <= window->free_memory_mb) {
+        window->free_cpus -= cpus;
+        window->free_memory_mb -= memory_mb;
+        return true;
+    }
+
+    // The reserved demand exceeds what is free, so whatever it covers is held back
+    if (!window->has_reservation) {
+        window->free_cpus -= cpus < window->free_cpus ? cpus : window->free_cpus;
+        window->free_memory_mb -= memory_mb < window->free_memory_mb ? memory_mb : window->free_memory_mb;
+        window->has_reservation = true;
+    }
+
+    return false;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <string.h>
+
+#include "graph.h"
+#include "vector.h"
+#include "config.h"
+#include "history.h"
+
+#define TRACKER_INITIAL_CAPACITY 64
+
+// Kahn-style scheduler state built once from a dependency graph, or grown task by task
+// while the config is still arriving.
+// Finishing a task costs O(out-degree) and never mutates the graph.
+typedef struct DependencyTracker {
+    size_t num_tasks_;
+    size_t capacity_;             // tasks the per task arrays have room for
+    int* remaining_;              // number of unfinished requirements per task
+    size_t* dependents_offsets_;  // dependents of task i are dependents_[offsets[i]..offsets[i + 1])
+    int* dependents_;             // reverse adjacency: tasks waiting for each task
+    IntVector** dependent_lists_; // per task dependents of a growing tracker, NULL if built from a graph
+    uint64_t* skipped_;           // bitset of tasks whose requirements have failed
+    uint64_t* succeeded_;         // bitset of tasks finished successfully
+    uint64_t* failed_;            // bitset of tasks finished with a failure
+    int* stack_;                  // traversal scratch space for SkipDependents
+} DependencyTracker;
+
+// Free resources seen by one dispatch pass.
+// The first task that doesn't fit reserves its demand, later tasks are only
+// backfilled into what is left, so a wide task can't be starved by small ones.
+typedef struct BackfillWindow {
+    unsigned int free_cpus;
+    unsigned int free_memory_mb;
+    bool has_reservation;
+} BackfillWindow;
+
+// Create new tracker instance from a graph where an edge `task -> required` means dependency.
+// Returns NULL on error.
+DependencyTracker* NewDependencyTracker(const Graph* graph);
+
+// Create new tracker instance without tasks, they are added one by one with AddTrackedTask.
+// Returns NULL on error.
+DependencyTracker* NewGrowingDependencyTracker(void);
+
+// Add a task to a growing tracker, every requirement has to be added before.
+// Succeeded requirements count as finished, a failed or skipped one skips the task right away.
+// Returns false and sets errno variable on error.
+bool AddTrackedTask(DependencyTracker* tracker, size_t task, const int* requirements, size_t num_requirements);
+
+// Record how the task has finished, tasks added later are resolved against it.
+void FinishTrackedTask(DependencyTracker* tracker, size_t task, bool succeeded);
+
+// Free tracker instance.
+// Ignores NULL instance and fields.
+void FreeDependencyTracker(DependencyTracker* tracker);
+
+// Get number of tasks tracked.
+size_t GetTrackedTaskCount(const DependencyTracker* tracker);
+
+// Check whether all requirements of a task are finished.
+bool IsTaskReady(const DependencyTracker* tracker, size_t task);
+
+// Get tasks which require the provided one.
+// Stores their number into count, returned array is owned by the tracker.
+const int* GetDependents(const DependencyTracker* tracker, size_t task, size_t* count);
+
+// Mark one requirement of a task as finished.
+// Returns number of requirements still unfinished, or -1 on error.
+int ResolveRequirement(DependencyTracker* tracker, size_t task);
+
+// Mark every task which transitively requires the provided one as skipped.
+// Skipped tasks are never visited twice, so all calls together cost O(V + E).
+// Newly skipped tasks are appended to skipped unless it is NULL.
+// Returns number of newly skipped tasks, or -1 on error.
+int SkipDependents(DependencyTracker* tracker, size_t task, IntVector* skipped);
+
+// Check whether a task was skipped because of a failed requirement.
+bool IsTaskSkipped(const DependencyTracker* tracker, size_t task);
+
+// Estimate task run time in milliseconds.
+// Uses the median of recorded runs when stats are known, otherwise the task config.
+long long EstimateTaskDurationMs(const TaskConfig* task, const RuntimeStats* stats);
+
+// Compute the longest downstream path of every task: its own weight plus
+// the heaviest chain of tasks that (transitively) require it.
+// weights and paths hold one entry per graph vertex, graph must be acyclic.
+// Returns false and sets errno variable on error.
+bool ComputeCriticalPaths(const Graph* graph, const long long* weights, long long* paths);
+
+// Start a dispatch pass with the resources that aren't used by running tasks.
+void InitBackfillWindow(BackfillWindow* window, unsigned int free_cpus, unsigned int free_memory_mb);
+
+// Check whether a task with the provided demand may start now and take its resources if so.
+// A refused task reserves its demand when no other task holds the reservation.
+bool AdmitBackfillTask(BackfillWindow* window, unsigned int cpus, unsigned int memory_mb);
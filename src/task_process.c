@@ -0,0 +1,298 @@
+#include "task_process.h"
+
+extern char** environ;
+
+static const char* const kOutputNames[TASK_OUTPUT_COUNT] = {"stdout", "stderr"};
+
+// Write the whole buffer, retrying on partial writes.
+// Returns false on error.
+static bool WriteAll(int fd, const void* buf, size_t size) {
+    const char* ptr = buf;
+
+    while (size) {
+        ssize_t diff = write(fd, ptr, size);
+        if (diff < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+
+        ptr += diff;
+        size -= diff;
+    }
+
+    return true;
+}
+
+void WriteTaskLog(const TaskProcess* process, const char* message) {
+    if (!process || process->log_fd == -1) {
+        return;
+    }
+
+    WriteAll(process->log_fd, message, strlen(message));
+}
+
+static void CloseLogSection(TaskProcess* process) {
+    if (process->log_section == -1) {
+        return;
+    }
+
+    WriteTaskLog(process, "=== End of task output to ");
+    WriteTaskLog(process, kOutputNames[process->log_section]);
+    WriteTaskLog(process, " ===\n");
+    process->log_section = -1;
+}
+
+// Output chunks of both pipes may interleave, every switch starts a new section in the log
+static void OpenLogSection(TaskProcess* process, int output) {
+    if (process->log_section == output) {
+        return;
+    }
+
+    CloseLogSection(process);
+    WriteTaskLog(process, "=== Task output to ");
+    WriteTaskLog(process, kOutputNames[output]);
+    WriteTaskLog(process, " ===\n");
+    process->log_section = output;
+}
+
+static void CloseOutput(TaskProcess* process, EventSource* source, EventLoop* loop) {
+    if (source->fd == -1) {
+        return;
+    }
+
+    UnwatchEventSource(loop, source);
+    close(source->fd);
+    source->fd = -1;
+}
+
+// Mark the process as finished without running, e.g. when it couldn't be spawned
+static bool FailedSpawningTask(TaskProcess* process, EventLoop* loop, int wait_status, const char* message) {
+    int saved_errno = errno;
+
+    WriteTaskLog(process, message);
+    for (int i = 0; i < TASK_OUTPUT_COUNT; ++i) {
+        CloseOutput(process, &process->outputs[i], loop);
+    }
+
+    process->exited = true;
+    process->wait_status = wait_status;
+    memset(&process->usage, 0, sizeof(process->usage));
+
+    errno = saved_errno;
+    return false;
+}
+
+static void InitTaskProcess(TaskProcess* process, const TaskConfig* config, void* owner) {
+    process->config = config;
+    process->owner = owner;
+    process->pid = -1;
+    process->log_fd = -1;
+    process->log_section = -1;
+    process->exited = false;
+    process->timed_out = false;
+    process->wait_status = 0;
+    for (int i = 0; i < TASK_OUTPUT_COUNT; ++i) {
+        process->outputs[i].fd = -1;
+        process->outputs[i].handler = NULL;
+        process->outputs[i].data = process;
+    }
+}
+
+bool StartSleepTask(TaskProcess* process, const TaskConfig* config, void* owner) {
+    if (!process || !config || config->type != TASK_TYPE_SLEEP) {
+        errno = EINVAL;
+        return false;
+    }
+
+    InitTaskProcess(process, config, owner);
+
+    process->log_fd = open(config->log_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (process->log_fd == -1) {
+        return FailedSpawningTask(process, NULL, SIGKILL, "");
+    }
+
+    WriteTaskLog(process, "Feeling sleepy..\n");
+    return true;
+}
+
+bool SpawnTaskProcess(
+    TaskProcess* process,
+    const TaskConfig* config,
+    const sigset_t* child_mask,
+    EventLoop* loop,
+    EventHandler output_handler,
+    void* owner)
+{
+    if (!process || !config || config->type != TASK_TYPE_EXEC || !child_mask || !loop || !output_handler) {
+        errno = EINVAL;
+        return false;
+    }
+
+    InitTaskProcess(process, config, owner);
+    for (int i = 0; i < TASK_OUTPUT_COUNT; ++i) {
+        process->outputs[i].handler = output_handler;
+    }
+
+    // A task which can't even log is killed, same as a failed worker setup
+    process->log_fd = open(config->log_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (process->log_fd == -1) {
+        return FailedSpawningTask(process, loop, SIGKILL, "");
+    }
+
+    int pipes[TASK_OUTPUT_COUNT][2];
+    int num_pipes = 0;
+
+    for (; num_pipes < TASK_OUTPUT_COUNT; ++num_pipes) {
+        if (pipe(pipes[num_pipes]) == -1) {
+            break;
+        }
+
+        process->outputs[num_pipes].fd = pipes[num_pipes][0];
+        fcntl(pipes[num_pipes][0], F_SETFD, FD_CLOEXEC);
+        fcntl(pipes[num_pipes][1], F_SETFD, FD_CLOEXEC);
+        fcntl(pipes[num_pipes][0], F_SETFL, O_NONBLOCK);
+    }
+
+    if (num_pipes != TASK_OUTPUT_COUNT) {
+        for (int i = 0; i < num_pipes; ++i) {
+            close(pipes[i][1]);
+        }
+        return FailedSpawningTask(process, loop, SIGKILL, "Pipe creation error occured\n");
+    }
+
+    // dup2 clears close-on-exec on the targets, every other pipe end is closed by exec
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attr;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, pipes[TASK_OUTPUT_STDOUT][1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, pipes[TASK_OUTPUT_STDERR][1], STDERR_FILENO);
+    posix_spawnattr_init(&attr);
+    posix_spawnattr_setsigmask(&attr, child_mask);
+    // Own process group, so that a timeout kills the whole task
+    posix_spawnattr_setpgroup(&attr, 0);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETPGROUP);
+
+    WriteTaskLog(process, "Executing commands\n");
+
+    // glibc implements posix_spawn with clone(CLONE_VM | CLONE_VFORK), no page tables are copied
+    int spawn_error = posix_spawn(
+        &process->pid,
+        config->exec_args->binary_path,
+        &actions,
+        &attr,
+        config->exec_args->argv,
+        environ);
+
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+    for (int i = 0; i < TASK_OUTPUT_COUNT; ++i) {
+        close(pipes[i][1]);
+    }
+
+    if (spawn_error != 0) {
+        errno = spawn_error;
+        return FailedSpawningTask(process, loop, W_EXITCODE(127, 0), "Exec failed\n");
+    }
+
+    for (int i = 0; i < TASK_OUTPUT_COUNT; ++i) {
+        if (!WatchEventSource(loop, &process->outputs[i], EPOLLIN)) {
+            // The process is already running, its output is dropped but it still gets reaped
+            CloseOutput(process, &process->outputs[i], loop);
+        }
+    }
+
+    return true;
+}
+
+bool PumpTaskOutput(TaskProcess* process, EventSource* source, EventLoop* loop) {
+    if (!process || !source || !loop) {
+        errno = EINVAL;
+        return false;
+    }
+
+    int output = source == &process->outputs[TASK_OUTPUT_STDOUT] ? TASK_OUTPUT_STDOUT : TASK_OUTPUT_STDERR;
+    char buffer[BUF_SIZE];
+
+    while (true) {
+        ssize_t nbytes = read(source->fd, buffer, sizeof(buffer));
+
+        if (nbytes > 0) {
+            OpenLogSection(process, output);
+            WriteAll(process->log_fd, buffer, nbytes);
+            WriteAll(STDOUT_FILENO, buffer, nbytes);
+            continue;
+        }
+
+        if (nbytes == -1 && errno == EINTR) {
+            continue;
+        }
+
+        if (nbytes == -1 && errno == EAGAIN) {
+            return true;
+        }
+
+        // EOF or a read error, nothing more will come from this pipe either way
+        CloseOutput(process, source, loop);
+        return true;
+    }
+}
+
+void SetTaskProcessExited(TaskProcess* process, int wait_status, const struct rusage* usage) {
+    if (!process) {
+        return;
+    }
+
+    process->exited = true;
+    process->wait_status = wait_status;
+    if (usage) {
+        process->usage = *usage;
+    } else {
+        memset(&process->usage, 0, sizeof(process->usage));
+    }
+}
+
+bool IsTaskProcessDone(const TaskProcess* process) {
+    if (!process) {
+        errno = EINVAL;
+        return false;
+    }
+
+    return process->exited &&
+           process->outputs[TASK_OUTPUT_STDOUT].fd == -1 &&
+           process->outputs[TASK_OUTPUT_STDERR].fd == -1;
+}
+
+void FinishTaskProcess(TaskProcess* process, EventLoop* loop) {
+    if (!process) {
+        return;
+    }
+
+    // Same status as if the kill had reached the leader
+    if (process->timed_out) {
+        process->wait_status = SIGKILL;
+    }
+
+    for (int i = 0; i < TASK_OUTPUT_COUNT; ++i) {
+        CloseOutput(process, &process->outputs[i], loop);
+    }
+    CloseLogSection(process);
+
+    if (process->log_fd == -1) {
+        return;
+    }
+
+    char code[16];
+    snprintf(code, sizeof(code), "%d", WEXITSTATUS(process->wait_status));
+
+    if (WIFEXITED(process->wait_status)) {
+        WriteTaskLog(process, "Proccess ended normally with code ");
+    } else {
+        WriteTaskLog(process, "Proccess aborted with code ");
+    }
+    WriteTaskLog(process, code);
+
+    close(process->log_fd);
+    process->log_fd = -1;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "config.h"
+#include "event_loop.h"
+
+#define TASK_OUTPUT_STDOUT 0
+#define TASK_OUTPUT_STDERR 1
+#define TASK_OUTPUT_COUNT 2
+
+// Task run by the master without a worker process.
+// EXEC tasks are spawned directly, their output pipes are watched by the master event loop and teed
+// into the log file and stdout, the task is finished once the process has been reaped and both pipes reached EOF.
+// SLEEP tasks have no process and no pipes, only the log.
+typedef struct TaskProcess {
+    const TaskConfig* config;
+    void* owner;                                 // handler payload of the output sources
+    pid_t pid;
+    int log_fd;
+    EventSource outputs[TASK_OUTPUT_COUNT];      // read ends of stdout and stderr pipes, fd -1 once closed
+    int log_section;                             // output whose log section is open, -1 if none
+    bool exited;                                 // process has been reaped
+    bool timed_out;                              // killed at the deadline, whatever it exited with
+    int wait_status;
+    struct rusage usage;
+} TaskProcess;
+
+// Open the task log and spawn the command with its stdout and stderr piped to the master.
+// Read ends of the pipes are non-blocking and watched in the loop with output_handler,
+// their sources carry the process itself as data.
+// The child starts with child_mask as its signal mask.
+// Returns false and sets errno if the process could not be started, a reason is written to the log if it's open.
+bool SpawnTaskProcess(
+    TaskProcess* process,
+    const TaskConfig* config,
+    const sigset_t* child_mask,
+    EventLoop* loop,
+    EventHandler output_handler,
+    void* owner);
+
+// Open the log of a SLEEP task, which the master runs as a timer without any process.
+// Returns false and marks the task finished if the log could not be opened.
+bool StartSleepTask(TaskProcess* process, const TaskConfig* config, void* owner);
+
+// Tee all currently available output of the source into the log and stdout.
+// Unwatches and closes the pipe on EOF or read error.
+// Returns false on invalid arguments.
+bool PumpTaskOutput(TaskProcess* process, EventSource* source, EventLoop* loop);
+
+// Store wait status and resource usage of the reaped process.
+void SetTaskProcessExited(TaskProcess* process, int wait_status, const struct rusage* usage);
+
+// Append a message to the task log.
+void WriteTaskLog(const TaskProcess* process, const char* message);
+
+// Check whether the process has been reaped and its output fully drained.
+bool IsTaskProcessDone(const TaskProcess* process);
+
+// Write the exit line into the log, close the log and any pipes left open.
+// A timed out process is finished as killed by SIGKILL, even if its leader exited on its own before.
+void FinishTaskProcess(TaskProcess* process, EventLoop* loop);
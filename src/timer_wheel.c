@@ -0,0 +1,250 @@
+#include "timer_wheel.h"
+
+#define WHEEL_SLOT_MASK (WHEEL_SLOTS - 1)
+#define WHEEL_RANGE ((uint64_t)1 << (WHEEL_SLOT_BITS * WHEEL_LEVELS))
+
+static void InitListHead(WheelTimer* head) {
+    head->prev_ = head;
+    head->next_ = head;
+}
+
+static bool IsListEmpty(const WheelTimer* head) {
+    return head->next_ == head;
+}
+
+static void LinkTimer(WheelTimer* head, WheelTimer* timer) {
+    timer->prev_ = head->prev_;
+    timer->next_ = head;
+    head->prev_->next_ = timer;
+    head->prev_ = timer;
+}
+
+static void UnlinkTimer(WheelTimer* timer) {
+    timer->prev_->next_ = timer->next_;
+    timer->next_->prev_ = timer->prev_;
+    timer->prev_ = timer;
+    timer->next_ = timer;
+}
+
+TimerWheel* NewTimerWheel(uint64_t now_ms) {
+    TimerWheel* wheel = malloc(sizeof(TimerWheel));
+    if (!wheel) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    wheel->now_ms_ = now_ms;
+    wheel->num_armed_ = 0;
+    InitListHead(&wheel->expired_);
+
+    for (int level = 0; level < WHEEL_LEVELS; ++level) {
+        wheel->occupied_[level] = 0;
+        for (int slot = 0; slot < WHEEL_SLOTS; ++slot) {
+            InitListHead(&wheel->slots_[level][slot]);
+        }
+    }
+
+    return wheel;
+}
+
+void FreeTimerWheel(TimerWheel* wheel) {
+    free(wheel);
+}
+
+void InitWheelTimer(WheelTimer* timer, void* data) {
+    if (!timer) {
+        return;
+    }
+
+    InitListHead(timer);
+    timer->expires_ms_ = 0;
+    timer->level_ = -1;
+    timer->slot_ = 0;
+    timer->data = data;
+}
+
+// Put the timer into the level whose slots are just fine enough for its distance from now.
+// A slot of level k is cascaded one level down when the wheel reaches its first tick.
+static void InsertTimer(TimerWheel* wheel, WheelTimer* timer) {
+    uint64_t expires = timer->expires_ms_;
+
+    if (expires <= wheel->now_ms_) {
+        timer->level_ = WHEEL_LEVELS;
+        LinkTimer(&wheel->expired_, timer);
+        return;
+    }
+
+    // Too far timers wait in the last level and get placed again on cascade
+    uint64_t delta = expires - wheel->now_ms_;
+    if (delta >= WHEEL_RANGE) {
+        expires = wheel->now_ms_ + WHEEL_RANGE - 1;
+        delta = WHEEL_RANGE - 1;
+    }
+
+    int level = 0;
+    while (delta >= ((uint64_t)1 << (WHEEL_SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+
+    int slot = (expires >> (WHEEL_SLOT_BITS * level)) & WHEEL_SLOT_MASK;
+    timer->level_ = level;
+    timer->slot_ = slot;
+    LinkTimer(&wheel->slots_[level][slot], timer);
+    wheel->occupied_[level] |= (uint64_t)1 << slot;
+}
+
+static void RemoveTimer(TimerWheel* wheel, WheelTimer* timer) {
+    UnlinkTimer(timer);
+
+    if (timer->level_ < WHEEL_LEVELS && IsListEmpty(&wheel->slots_[timer->level_][timer->slot_])) {
+        wheel->occupied_[timer->level_] &= ~((uint64_t)1 << timer->slot_);
+    }
+
+    timer->level_ = -1;
+}
+
+bool ArmWheelTimer(TimerWheel* wheel, WheelTimer* timer, uint64_t expires_ms) {
+    if (!wheel || !timer) {
+        errno = EINVAL;
+        return false;
+    }
+
+    if (timer->level_ != -1) {
+        RemoveTimer(wheel, timer);
+    } else {
+        wheel->num_armed_++;
+    }
+
+    timer->expires_ms_ = expires_ms;
+    InsertTimer(wheel, timer);
+    return true;
+}
+
+void CancelWheelTimer(TimerWheel* wheel, WheelTimer* timer) {
+    if (!wheel || !timer || timer->level_ == -1) {
+        return;
+    }
+
+    RemoveTimer(wheel, timer);
+    wheel->num_armed_--;
+}
+
+bool IsWheelTimerArmed(const WheelTimer* timer) {
+    return timer && timer->level_ != -1;
+}
+
+size_t GetArmedWheelTimerCount(const TimerWheel* wheel) {
+    if (!wheel) {
+        errno = EINVAL;
+        return 0;
+    }
+
+    return wheel->num_armed_;
+}
+
+static void CascadeSlot(TimerWheel* wheel, int level, int slot) {
+    WheelTimer* head = &wheel->slots_[level][slot];
+
+    wheel->occupied_[level] &= ~((uint64_t)1 << slot);
+    while (!IsListEmpty(head)) {
+        WheelTimer* timer = head->next_;
+        UnlinkTimer(timer);
+        InsertTimer(wheel, timer);
+    }
+}
+
+static void ProcessTick(TimerWheel* wheel, uint64_t tick) {
+    wheel->now_ms_ = tick;
+
+    for (int level = WHEEL_LEVELS - 1; level > 0; --level) {
+        uint64_t span_mask = ((uint64_t)1 << (WHEEL_SLOT_BITS * level)) - 1;
+
+        if ((tick & span_mask) == 0) {
+            CascadeSlot(wheel, level, (tick >> (WHEEL_SLOT_BITS * level)) & WHEEL_SLOT_MASK);
+        }
+    }
+
+    int slot = tick & WHEEL_SLOT_MASK;
+    WheelTimer* head = &wheel->slots_[0][slot];
+
+    wheel->occupied_[0] &= ~((uint64_t)1 << slot);
+    while (!IsListEmpty(head)) {
+        WheelTimer* timer = head->next_;
+        UnlinkTimer(timer);
+        timer->level_ = WHEEL_LEVELS;
+        LinkTimer(&wheel->expired_, timer);
+    }
+}
+
+// Number of slot steps from the one after `position` to the next occupied slot, 1 to WHEEL_SLOTS
+static uint64_t DistanceToOccupied(uint64_t occupied, uint64_t position) {
+    unsigned int shift = (position + 1) & WHEEL_SLOT_MASK;
+    uint64_t rotated = shift ? (occupied >> shift) | (occupied << (WHEEL_SLOTS - shift)) : occupied;
+
+    return __builtin_ctzll(rotated) + 1;
+}
+
+// First tick after now at which a slot gets collected or cascaded.
+// Returns false if the wheel is empty.
+static bool GetNextEventTick(const TimerWheel* wheel, uint64_t* tick) {
+    bool found = false;
+
+    for (int level = 0; level < WHEEL_LEVELS; ++level) {
+        if (!wheel->occupied_[level]) {
+            continue;
+        }
+
+        unsigned int shift = WHEEL_SLOT_BITS * level;
+        uint64_t position = wheel->now_ms_ >> shift;
+        uint64_t candidate = (position + DistanceToOccupied(wheel->occupied_[level], position)) << shift;
+
+        if (!found || candidate < *tick) {
+            *tick = candidate;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+void AdvanceTimerWheel(TimerWheel* wheel, uint64_t now_ms) {
+    if (!wheel) {
+        return;
+    }
+
+    // Empty slots are skipped, so the cost depends on the number of timers rather than elapsed ticks
+    uint64_t tick;
+    while (wheel->now_ms_ < now_ms) {
+        if (!GetNextEventTick(wheel, &tick) || tick > now_ms) {
+            wheel->now_ms_ = now_ms;
+            break;
+        }
+
+        ProcessTick(wheel, tick);
+    }
+}
+
+WheelTimer* PopExpiredWheelTimer(TimerWheel* wheel) {
+    if (!wheel || IsListEmpty(&wheel->expired_)) {
+        return NULL;
+    }
+
+    WheelTimer* timer = wheel->expired_.next_;
+    RemoveTimer(wheel, timer);
+    wheel->num_armed_--;
+    return timer;
+}
+
+bool GetNextWheelDeadline(const TimerWheel* wheel, uint64_t* deadline_ms) {
+    if (!wheel || !deadline_ms) {
+        errno = EINVAL;
+        return false;
+    }
+
+    if (!IsListEmpty(&wheel->expired_)) {
+        *deadline_ms = wheel->now_ms_;
+        return true;
+    }
+
+    return GetNextEventTick(wheel, deadline_ms);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <errno.h>
+
+// Hierarchical timing wheel with millisecond ticks.
+// Level k has WHEEL_SLOTS slots of WHEEL_SLOTS^k ticks each, so arm and cancel are O(1)
+// and timers move down one level at a time as their expiry approaches.
+#define WHEEL_LEVELS 4
+#define WHEEL_SLOT_BITS 6
+#define WHEEL_SLOTS (1 << WHEEL_SLOT_BITS)
+
+typedef struct WheelTimer WheelTimer;
+
+// Intrusive timer node, embedded into the owner's state.
+typedef struct WheelTimer {
+    WheelTimer* prev_;
+    WheelTimer* next_;
+    uint64_t expires_ms_;
+    int level_;  // -1 if not armed, WHEEL_LEVELS if collected
+    int slot_;
+    void* data;  // owner payload, not touched by the wheel
+} WheelTimer;
+
+typedef struct TimerWheel {
+    uint64_t now_ms_;                                  // every timer expiring at or before it has been collected
+    uint64_t occupied_[WHEEL_LEVELS];                  // bitmap of non-empty slots per level
+    WheelTimer slots_[WHEEL_LEVELS][WHEEL_SLOTS];      // list heads
+    WheelTimer expired_;                               // collected timers waiting to be popped
+    size_t num_armed_;
+} TimerWheel;
+
+// Create new wheel starting at now_ms.
+// Returns NULL on error.
+TimerWheel* NewTimerWheel(uint64_t now_ms);
+
+// Free wheel instance, armed timers are left untouched.
+// Ignores NULL instance.
+void FreeTimerWheel(TimerWheel* wheel);
+
+// Initialize timer node before its first use.
+void InitWheelTimer(WheelTimer* timer, void* data);
+
+// Arm the timer to expire at expires_ms, rearming it if it's already armed.
+// Expiries in the past are collected by the next advance.
+// Returns false and sets errno on error.
+bool ArmWheelTimer(TimerWheel* wheel, WheelTimer* timer, uint64_t expires_ms);
+
+// Disarm the timer, whether it is pending or already collected.
+// Ignores timers which aren't armed.
+void CancelWheelTimer(TimerWheel* wheel, WheelTimer* timer);
+
+// Check whether the timer is armed and hasn't been popped yet.
+bool IsWheelTimerArmed(const WheelTimer* timer);
+
+// Get number of armed timers.
+size_t GetArmedWheelTimerCount(const TimerWheel* wheel);
+
+// Move the wheel to now_ms and collect every timer expiring at or before it.
+void AdvanceTimerWheel(TimerWheel* wheel, uint64_t now_ms);
+
+// Pop one collected timer, which becomes disarmed.
+// Returns NULL if there are none.
+WheelTimer* PopExpiredWheelTimer(TimerWheel* wheel);
+
+// Get the time the wheel has to be advanced at next.
+// It is exact for timers due within WHEEL_SLOTS ticks and a lower bound for later ones.
+// Returns false if there are no armed timers.
+bool GetNextWheelDeadline(const TimerWheel* wheel, uint64_t* deadline_ms);
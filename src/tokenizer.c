@@ -0,0 +1,309 @@
+#include "tokenizer.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CONFIG_SCANNER_X86 1
+#endif
+
+bool LoadConfigBuffer(FILE* file, ConfigBuffer* buffer) {
+    if (!file || !buffer) {
+        errno = EINVAL;
+        return false;
+    }
+
+    buffer->data = NULL;
+    buffer->size = 0;
+    buffer->map_ = NULL;
+    buffer->map_size_ = 0;
+
+    // The stream may have been read from already, the text starts at its logical position
+    struct stat st;
+    long offset = ftell(file);
+    int fd = fileno(file);
+
+    if (offset >= 0 && fd != -1 && fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > offset) {
+        void* map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            madvise(map, st.st_size, MADV_SEQUENTIAL);
+            buffer->map_ = map;
+            buffer->map_size_ = st.st_size;
+            buffer->data = (const char*)map + offset;
+            buffer->size = st.st_size - offset;
+            return true;
+        }
+    }
+
+    // Pipes and other streams are read whole
+    size_t capacity = 1 << 16;
+    char* data = malloc(capacity);
+    if (!data) {
+        errno = ENOMEM;
+        return false;
+    }
+
+    size_t size = 0;
+    size_t nbytes;
+    while ((nbytes = fread(data + size, 1, capacity - size, file)) > 0) {
+        size += nbytes;
+        if (size == capacity) {
+            char* new_data = realloc(data, capacity * 2);
+            if (!new_data) {
+                free(data);
+                errno = ENOMEM;
+                return false;
+            }
+            data = new_data;
+            capacity *= 2;
+        }
+    }
+
+    if (ferror(file)) {
+        free(data);
+        errno = EIO;
+        return false;
+    }
+
+    buffer->data = data;
+    buffer->size = size;
+    return true;
+}
+
+void ReleaseConfigBuffer(ConfigBuffer* buffer) {
+    if (!buffer) {
+        return;
+    }
+
+    if (buffer->map_) {
+        munmap(buffer->map_, buffer->map_size_);
+    } else {
+        free((char*)buffer->data);
+    }
+
+    buffer->data = NULL;
+    buffer->size = 0;
+    buffer->map_ = NULL;
+}
+
+static const char* ScanConfigLineScalar(const char* begin, const char* end, const char** colon) {
+    *colon = NULL;
+
+    for (const char* ptr = begin; ptr < end; ++ptr) {
+        if (*ptr == '\n') {
+            return ptr;
+        }
+        if (*ptr == ':' && !*colon) {
+            *colon = ptr;
+        }
+    }
+
+    return end;
+}
+
+#ifdef CONFIG_SCANNER_X86
+
+// Masks of newlines and colons are found per block, the first newline bounds the colon search
+static const char* ScanConfigLineSse2(const char* begin, const char* end, const char** colon) {
+    const __m128i newlines = _mm_set1_epi8('\n');
+    const __m128i colons = _mm_set1_epi8(':');
+    const char* ptr = begin;
+
+    *colon = NULL;
+    for (; ptr + 16 <= end; ptr += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)ptr);
+        unsigned int newline_mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, newlines));
+        unsigned int colon_mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, colons));
+
+        if (newline_mask) {
+            // Only colons before the newline count
+            colon_mask &= (1u << __builtin_ctz(newline_mask)) - 1;
+        }
+        if (colon_mask && !*colon) {
+            *colon = ptr + __builtin_ctz(colon_mask);
+        }
+        if (newline_mask) {
+            return ptr + __builtin_ctz(newline_mask);
+        }
+    }
+
+    const char* tail_colon;
+    const char* newline = ScanConfigLineScalar(ptr, end, &tail_colon);
+    if (!*colon) {
+        *colon = tail_colon;
+    }
+    return newline;
+}
+
+__attribute__((target("avx2")))
+static const char* ScanConfigLineAvx2(const char* begin, const char* end, const char** colon) {
+    const __m256i newlines = _mm256_set1_epi8('\n');
+    const __m256i colons = _mm256_set1_epi8(':');
+    const char* ptr = begin;
+
+    *colon = NULL;
+    for (; ptr + 32 <= end; ptr += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)ptr);
+        uint32_t newline_mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newlines));
+        uint32_t colon_mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, colons));
+
+        if (newline_mask) {
+            colon_mask &= (uint32_t)((1ull << __builtin_ctz(newline_mask)) - 1);
+        }
+        if (colon_mask && !*colon) {
+            *colon = ptr + __builtin_ctz(colon_mask);
+        }
+        if (newline_mask) {
+            return ptr + __builtin_ctz(newline_mask);
+        }
+    }
+
+    const char* tail_colon;
+    const char* newline = ScanConfigLineSse2(ptr, end, &tail_colon);
+    if (!*colon) {
+        *colon = tail_colon;
+    }
+    return newline;
+}
+
+#endif
+
+typedef const char* (*ConfigLineScanner)(const char* begin, const char* end, const char** colon);
+
+// Picked once by the running CPU
+static ConfigLineScanner GetConfigLineScanner(void) {
+    static ConfigLineScanner scanner = NULL;
+
+    if (!scanner) {
+#ifdef CONFIG_SCANNER_X86
+        __builtin_cpu_init();
+        scanner = __builtin_cpu_supports("avx2") ? ScanConfigLineAvx2 : ScanConfigLineSse2;
+#else
+        scanner = ScanConfigLineScalar;
+#endif
+    }
+
+    return scanner;
+}
+
+const char* ScanConfigLine(const char* begin, const char* end, const char** colon) {
+    return GetConfigLineScanner()(begin, end, colon);
+}
+
+void InitConfigLineReader(ConfigLineReader* reader, const ConfigBuffer* buffer) {
+    reader->pos_ = buffer->data;
+    reader->end_ = buffer->data + buffer->size;
+    reader->line_number_ = 0;
+}
+
+static StringView TrimView(StringView view) {
+    while (view.len && view.data[0] == ' ') {
+        view.data++;
+        view.len--;
+    }
+    while (view.len && view.data[view.len - 1] == ' ') {
+        view.len--;
+    }
+
+    return view;
+}
+
+bool NextConfigLine(ConfigLineReader* reader, ConfigLine* line) {
+    if (reader->pos_ >= reader->end_) {
+        return false;
+    }
+
+    const char* colon;
+    const char* begin = reader->pos_;
+    const char* newline = ScanConfigLine(begin, reader->end_, &colon);
+
+    reader->pos_ = newline < reader->end_ ? newline + 1 : newline;
+    reader->line_number_++;
+
+    StringView rest = {begin, newline - begin};
+    line->first = (StringView){begin, 0};
+    NextViewToken(&rest, &line->first);
+    line->value = TrimView(rest);
+
+    // A key is the whole first token up to the first colon of the line
+    if (colon && colon + 1 == line->first.data + line->first.len) {
+        line->key = line->first;
+    } else {
+        line->key = (StringView){begin, 0};
+    }
+
+    return true;
+}
+
+int GetConfigLineNumber(const ConfigLineReader* reader) {
+    return reader->line_number_;
+}
+
+bool NextViewToken(StringView* rest, StringView* token) {
+    size_t start = 0;
+    while (start < rest->len && rest->data[start] == ' ') {
+        start++;
+    }
+
+    if (start == rest->len) {
+        rest->data += rest->len;
+        rest->len = 0;
+        return false;
+    }
+
+    size_t stop = start;
+    while (stop < rest->len && rest->data[stop] != ' ') {
+        stop++;
+    }
+
+    token->data = rest->data + start;
+    token->len = stop - start;
+    rest->data += stop;
+    rest->len -= stop;
+    return true;
+}
+
+size_t CountViewTokens(StringView view) {
+    StringView token;
+    size_t count = 0;
+
+    while (NextViewToken(&view, &token)) {
+        count++;
+    }
+
+    return count;
+}
+
+bool ViewEquals(StringView view, const char* str) {
+    return view.data && strlen(str) == view.len && memcmp(view.data, str, view.len) == 0;
+}
+
+char* ViewToString(StringView view) {
+    char* str = malloc(view.len + 1);
+    if (!str) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    memcpy(str, view.data, view.len);
+    str[view.len] = '\0';
+    return str;
+}
+
+unsigned int ViewToUnsigned(StringView view) {
+    if (!view.data) {
+        return -1;
+    }
+
+    // strtol saturates at LONG_MAX, the result is then truncated as in MyAtoi
+    unsigned long long value = 0;
+    for (size_t i = 0; i < view.len; ++i) {
+        if (view.data[i] < '0' || '9' < view.data[i]) {
+            return -1;
+        }
+
+        if (value <= LONG_MAX) {
+            value = value * 10 + (view.data[i] - '0');
+        }
+    }
+
+    return (unsigned int)(value > LONG_MAX ? LONG_MAX : value);
+}
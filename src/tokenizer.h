@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Non-owning slice of a string, not NUL-terminated.
+typedef struct StringView {
+    const char* data;  // NULL for an absent value
+    size_t len;
+} StringView;
+
+// Whole config text, mapped when the file is regular and read into memory otherwise.
+typedef struct ConfigBuffer {
+    const char* data;
+    size_t size;
+    void* map_;         // mapping to unmap, NULL if the text was read
+    size_t map_size_;
+} ConfigBuffer;
+
+// Line-by-line cursor over a config buffer.
+typedef struct ConfigLineReader {
+    const char* pos_;
+    const char* end_;
+    int line_number_;
+} ConfigLineReader;
+
+// One config line split into its first token and the rest.
+typedef struct ConfigLine {
+    StringView first;  // first space separated token, empty for blank lines
+    StringView key;    // `name:` and alike, empty if the first token is not a key
+    StringView value;  // text after the first token with surrounding spaces trimmed
+} ConfigLine;
+
+// Load the rest of the file starting at its current position.
+// Returns false and sets errno on error.
+bool LoadConfigBuffer(FILE* file, ConfigBuffer* buffer);
+
+// Unmap or free the buffer text.
+void ReleaseConfigBuffer(ConfigBuffer* buffer);
+
+// Find the first '\n' in [begin, end) and the first ':' before it, 16 or 32 bytes per step.
+// Returns end if there is no newline, *colon is NULL if there is no colon.
+const char* ScanConfigLine(const char* begin, const char* end, const char** colon);
+
+// Start reading lines of the buffer.
+void InitConfigLineReader(ConfigLineReader* reader, const ConfigBuffer* buffer);
+
+// Read and split the next line.
+// Returns false at the end of the buffer.
+bool NextConfigLine(ConfigLineReader* reader, ConfigLine* line);
+
+// Get number of the line read last, starting from 1.
+int GetConfigLineNumber(const ConfigLineReader* reader);
+
+// Cut the next space separated token off the front of rest.
+// Returns false if there are no tokens left.
+bool NextViewToken(StringView* rest, StringView* token);
+
+// Count space separated tokens.
+size_t CountViewTokens(StringView view);
+
+// Compare the view with a NUL-terminated string.
+bool ViewEquals(StringView view, const char* str);
+
+// Copy the view into a new NUL-terminated string.
+// Returns NULL on error.
+char* ViewToString(StringView view);
+
+// Parse a non-negative decimal number, same rules as MyAtoi.
+// Returns -1 if the view has anything but digits.
+unsigned int ViewToUnsigned(StringView view);
@@ -0,0 +1,243 @@
+#include "trace.h"
+
+#define TRACE_PID_QUEUE 1
+#define TRACE_PID_SLOTS 2
+
+TraceRecorder* NewTraceRecorder(size_t num_tasks) {
+    TraceRecorder* recorder = malloc(sizeof(TraceRecorder));
+    if (!recorder) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    recorder->capacity_ = num_tasks * TRACE_EVENTS_PER_TASK;
+    recorder->events_ = malloc(sizeof(TraceEvent) * (recorder->capacity_ ? recorder->capacity_ : 1));
+    if (!recorder->events_) {
+        free(recorder);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    recorder->num_events_ = 0;
+    recorder->num_dropped_ = 0;
+    recorder->num_tasks_ = num_tasks;
+    recorder->start_ns_ = GetTimeNs(CLOCK_MONOTONIC);
+    return recorder;
+}
+
+bool GrowTraceRecorder(TraceRecorder* recorder, size_t num_tasks) {
+    if (!recorder) {
+        errno = EINVAL;
+        return false;
+    }
+
+    if (num_tasks <= recorder->num_tasks_) {
+        return true;
+    }
+
+    // Doubled at least, so that a stream of single tasks doesn't copy the buffer every time
+    size_t capacity = num_tasks * TRACE_EVENTS_PER_TASK;
+    if (capacity > recorder->capacity_) {
+        if (capacity < recorder->capacity_ * 2) {
+            capacity = recorder->capacity_ * 2;
+        }
+
+        TraceEvent* events = realloc(recorder->events_, sizeof(TraceEvent) * capacity);
+        if (!events) {
+            errno = ENOMEM;
+            return false;
+        }
+
+        recorder->events_ = events;
+        recorder->capacity_ = capacity;
+    }
+
+    recorder->num_tasks_ = num_tasks;
+    return true;
+}
+
+void FreeTraceRecorder(TraceRecorder* recorder) {
+    if (!recorder) {
+        return;
+    }
+
+    free(recorder->events_);
+    free(recorder);
+}
+
+void RecordTraceEvent(TraceRecorder* recorder, TraceEventType type, int task, int cause) {
+    if (!recorder) {
+        return;
+    }
+
+    if (recorder->num_events_ == recorder->capacity_) {
+        recorder->num_dropped_++;
+        return;
+    }
+
+    TraceEvent* event = &recorder->events_[recorder->num_events_++];
+    event->ts_ns = GetTimeNs(CLOCK_MONOTONIC);
+    event->task = task;
+    event->cause = cause;
+    event->type = type;
+}
+
+size_t GetTraceEventCount(const TraceRecorder* recorder) {
+    if (!recorder) {
+        errno = EINVAL;
+        return 0;
+    }
+
+    return recorder->num_events_;
+}
+
+// Trace-event timestamps are microseconds since the start of the run
+static double ToTraceUs(const TraceRecorder* recorder, int64_t ts_ns) {
+    return (ts_ns - recorder->start_ns_) / 1e3;
+}
+
+static void WriteTrackName(FILE* file, int pid, int tid, const char* kind, const char* name, int index) {
+    fprintf(file, ",\n{\"ph\": \"M\", \"pid\": %d, \"tid\": %d, \"name\": \"%s\", \"args\": {\"name\": \"%s", pid, tid, kind, name);
+    if (index >= 0) {
+        fprintf(file, " %d", index);
+    }
+    fprintf(file, "\"}}");
+}
+
+static void WriteSpan(
+    FILE* file,
+    const TraceRecorder* recorder,
+    const char* name,
+    const char* task_name,
+    int slot,
+    int64_t begin_ns,
+    int64_t end_ns)
+{
+    fprintf(file, ",\n{\"ph\": \"X\", \"pid\": %d, \"tid\": %d, \"cat\": \"%s\", \"name\": ",
+            TRACE_PID_SLOTS, slot, name);
+    WriteJsonString(file, task_name);
+    fprintf(file, ", \"ts\": %.3f, \"dur\": %.3f}", ToTraceUs(recorder, begin_ns), (end_ns - begin_ns) / 1e3);
+}
+
+static void WriteQueueEdge(FILE* file, const TraceRecorder* recorder, char phase, const char* task_name, int task, int64_t ts_ns) {
+    fprintf(file, ",\n{\"ph\": \"%c\", \"pid\": %d, \"tid\": 0, \"cat\": \"queued\", \"id\": %d, \"name\": ",
+            phase, TRACE_PID_QUEUE, task);
+    WriteJsonString(file, task_name);
+    fprintf(file, ", \"ts\": %.3f}", ToTraceUs(recorder, ts_ns));
+}
+
+// Events are replayed in recording order, which is chronological:
+// a task takes the most recently freed slot when it is started and frees it once it is done.
+static void WriteTraceEvents(FILE* file, const TraceRecorder* recorder, const ExecutionConfig* config, int64_t* marks, int* task_slots, int* free_slots) {
+    int num_free_slots = 0;
+    int num_slots = 0;
+
+    for (size_t i = 0; i < recorder->num_events_; ++i) {
+        const TraceEvent* event = &recorder->events_[i];
+        int64_t* task_marks = &marks[event->task * TRACE_EVENT_RELEASE];
+        const char* task_name = config->tasks[event->task]->name;
+        int slot = task_slots[event->task];
+
+        switch (event->type) {
+            case TRACE_EVENT_QUEUED:
+                WriteQueueEdge(file, recorder, 'b', task_name, event->task, event->ts_ns);
+                break;
+            case TRACE_EVENT_SPAWN:
+                if (task_marks[TRACE_EVENT_QUEUED] != -1) {
+                    WriteQueueEdge(file, recorder, 'e', task_name, event->task, event->ts_ns);
+                }
+                slot = num_free_slots ? free_slots[--num_free_slots] : num_slots++;
+                task_slots[event->task] = slot;
+                break;
+            case TRACE_EVENT_RUNNING:
+                if (slot != -1 && task_marks[TRACE_EVENT_SPAWN] != -1) {
+                    WriteSpan(file, recorder, "spawn", task_name, slot, task_marks[TRACE_EVENT_SPAWN], event->ts_ns);
+                }
+                break;
+            case TRACE_EVENT_EXITED:
+                if (slot != -1 && task_marks[TRACE_EVENT_RUNNING] != -1) {
+                    WriteSpan(file, recorder, "run", task_name, slot, task_marks[TRACE_EVENT_RUNNING], event->ts_ns);
+                }
+                break;
+            case TRACE_EVENT_DONE:
+                if (slot == -1) {
+                    break;
+                }
+                if (task_marks[TRACE_EVENT_EXITED] != -1) {
+                    WriteSpan(file, recorder, "drain", task_name, slot, task_marks[TRACE_EVENT_EXITED], event->ts_ns);
+                }
+                free_slots[num_free_slots++] = slot;
+                break;
+            case TRACE_EVENT_RELEASE:
+                fprintf(file, ",\n{\"ph\": \"i\", \"s\": \"t\", \"pid\": %d, \"tid\": %d, \"cat\": \"release\", \"name\": ",
+                        TRACE_PID_SLOTS, event->cause >= 0 && task_slots[event->cause] != -1 ? task_slots[event->cause] : 0);
+                WriteJsonString(file, task_name);
+                fprintf(file, ", \"ts\": %.3f, \"args\": {\"released_by\": ", ToTraceUs(recorder, event->ts_ns));
+                WriteJsonString(file, event->cause >= 0 ? config->tasks[event->cause]->name : "");
+                fprintf(file, "}}");
+                break;
+        }
+
+        if (event->type < TRACE_EVENT_RELEASE) {
+            task_marks[event->type] = event->ts_ns;
+        }
+    }
+
+    for (int slot = 0; slot < num_slots; ++slot) {
+        WriteTrackName(file, TRACE_PID_SLOTS, slot, "thread_name", "slot", slot);
+    }
+}
+
+bool WriteTrace(const TraceRecorder* recorder, const ExecutionConfig* config, const char* path) {
+    if (!recorder || !config || !path || config->num_tasks != recorder->num_tasks_) {
+        errno = EINVAL;
+        return false;
+    }
+
+    size_t num_tasks = recorder->num_tasks_ ? recorder->num_tasks_ : 1;
+    int64_t* marks = malloc(sizeof(int64_t) * num_tasks * TRACE_EVENT_RELEASE);
+    int* task_slots = malloc(sizeof(int) * num_tasks);
+    int* free_slots = malloc(sizeof(int) * num_tasks);
+    if (!marks || !task_slots || !free_slots) {
+        free(marks);
+        free(task_slots);
+        free(free_slots);
+        errno = ENOMEM;
+        return false;
+    }
+
+    for (size_t i = 0; i < num_tasks * TRACE_EVENT_RELEASE; ++i) {
+        marks[i] = -1;
+    }
+    for (size_t i = 0; i < num_tasks; ++i) {
+        task_slots[i] = -1;
+    }
+
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        free(marks);
+        free(task_slots);
+        free(free_slots);
+        return false;
+    }
+
+    fprintf(file, "{\"displayTimeUnit\": \"ms\", \"otherData\": {\"dropped_events\": %zu}, \"traceEvents\": [\n", recorder->num_dropped_);
+    fprintf(file, "{\"ph\": \"M\", \"pid\": %d, \"name\": \"process_name\", \"args\": {\"name\": \"ready queue\"}}", TRACE_PID_QUEUE);
+    WriteTrackName(file, TRACE_PID_SLOTS, 0, "process_name", "concurrency slots", -1);
+    WriteTraceEvents(file, recorder, config, marks, task_slots, free_slots);
+    fprintf(file, "\n]}\n");
+
+    free(marks);
+    free(task_slots);
+    free(free_slots);
+
+    bool failed = ferror(file);
+    if (fclose(file) == EOF || failed) {
+        if (!errno) {
+            errno = EIO;
+        }
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+
+#include "config.h"
+#include "utils.h"
+
+// Every task goes through each state transition once and is released once
+#define TRACE_EVENTS_PER_TASK 6
+
+typedef enum TraceEventType {
+    TRACE_EVENT_QUEUED,   // task became ready
+    TRACE_EVENT_SPAWN,    // task left the ready set and is being started
+    TRACE_EVENT_RUNNING,  // process was spawned or sleep timer armed
+    TRACE_EVENT_EXITED,   // process was reaped or sleep timer fired
+    TRACE_EVENT_DONE,     // output drained, log closed and task completed
+    TRACE_EVENT_RELEASE,  // last requirement of the task completed, cause is that requirement
+} TraceEventType;
+
+typedef struct TraceEvent {
+    int64_t ts_ns;  // CLOCK_MONOTONIC
+    int32_t task;
+    int32_t cause;  // releasing task for TRACE_EVENT_RELEASE, -1 otherwise
+    uint32_t type;
+} TraceEvent;
+
+// Run timeline recorder.
+// Recording only stores a timestamped event into a buffer preallocated for the whole run,
+// spans and concurrency slot tracks are built when the trace is written.
+typedef struct TraceRecorder {
+    TraceEvent* events_;
+    size_t num_events_;
+    size_t capacity_;
+    size_t num_dropped_;  // events which didn't fit, e.g. recorded twice for a task
+    size_t num_tasks_;
+    int64_t start_ns_;
+} TraceRecorder;
+
+// Create new recorder for a run of num_tasks tasks.
+// Returns NULL on error.
+TraceRecorder* NewTraceRecorder(size_t num_tasks);
+
+// Make room for the events of num_tasks tasks, for a run whose config is still arriving.
+// Returns false and sets errno on error.
+bool GrowTraceRecorder(TraceRecorder* recorder, size_t num_tasks);
+
+// Free recorder instance.
+// Ignores NULL instance.
+void FreeTraceRecorder(TraceRecorder* recorder);
+
+// Record a state transition of a task at the current time.
+// Ignores NULL recorder, so tracing can be disabled by passing it.
+void RecordTraceEvent(TraceRecorder* recorder, TraceEventType type, int task, int cause);
+
+// Get number of recorded events.
+size_t GetTraceEventCount(const TraceRecorder* recorder);
+
+// Write the recorded run to path as Chrome trace-event JSON, loadable by chrome://tracing and Perfetto.
+// Queued time of every task is an async span on the ready queue track,
+// spawn, run and drain spans are placed on one thread track per concurrency slot,
+// dependency releases are instant events on the slot of the releasing task.
+// Returns true on success, otherwise returns false and changes errno.
+bool WriteTrace(const TraceRecorder* recorder, const ExecutionConfig* config, const char* path);
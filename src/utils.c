@@ -141,4 +141,24 @@ unsigned int MyAtoi(const char* str) {
     }
 
     return (unsigned int)strtol(str, NULL, 10);
-}
\ No newline at end of file
+}
+
+int64_t GetTimeNs(clockid_t clock_id) {
+    struct timespec ts;
+    clock_gettime(clock_id, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+void WriteJsonString(FILE* file, const char* str) {
+    fputc('"', file);
+    for (const unsigned char* ptr = (const unsigned char*)str; *ptr; ++ptr) {
+        if (*ptr == '"' || *ptr == '\\') {
+            fprintf(file, "\\%c", *ptr);
+        } else if (*ptr < 0x20) {
+            fprintf(file, "\\u%04x", *ptr);
+        } else {
+            fputc(*ptr, file);
+        }
+    }
+    fputc('"', file);
+}
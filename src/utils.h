@@ -1,6 +1,9 @@
 #pragma once
 
 #include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
 
 #include "vector.h"
 #include "queue.h"
@@ -22,4 +25,10 @@ char* JoinPath(const char* prefix, const char* suffix);
 
 // Check whether the specified string str is the correct positive number and return it, 
 // otherwise return -1
-unsigned int MyAtoi(const char* str);
\ No newline at end of file
+unsigned int MyAtoi(const char* str);
+
+// Get current time of the given clock in nanoseconds.
+int64_t GetTimeNs(clockid_t clock_id);
+
+// Write a quoted JSON string, escaping quotes, backslashes and control characters.
+void WriteJsonString(FILE* file, const char* str);
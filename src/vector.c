@@ -131,6 +131,28 @@ void ReverseIntVector(IntVector* vec) {
         SetIntVectorElement(vec, i, buf);
     }
 }
+void TruncateIntVector(IntVector* vector, size_t len) {
+    if (vector == NULL) {
+        errno = EINVAL;
+        return;
+    }
+
+    if (len > vector->len_) {
+        errno = ERANGE;
+        return;
+    }
+
+    vector->len_ = len;
+}
+
+const int* GetIntVectorData(const IntVector* vector) {
+    if (vector == NULL || vector->arr_ == NULL) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    return vector->arr_;
+}
 
 
 
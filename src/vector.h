@@ -44,6 +44,12 @@ int ChangeIntVectorElement(IntVector* vector, size_t idx, int delta);
 // Reverse int vector
 void ReverseIntVector(IntVector* vec);
 
+// Shrink vector length to len, keeping its capacity.
+void TruncateIntVector(IntVector* vector, size_t len);
+
+// Get pointer to vector elements, valid until the next append.
+const int* GetIntVectorData(const IntVector* vector);
+
 
 typedef struct StringVector {
     char** arr_;
@@ -0,0 +1,62 @@
+#include "arena_test.h"
+
+START_TEST(test_arena_alignment) {
+    Arena* arena = NewArena(64);
+    ck_assert_ptr_nonnull(arena);
+
+    char* str = ArenaStrdup(arena, "abc");
+    ck_assert_str_eq(str, "abc");
+
+    // Objects after a string are aligned for any type again
+    long double* value = ArenaAlloc(arena, sizeof(long double));
+    ck_assert_ptr_nonnull(value);
+    ck_assert((uintptr_t)value % _Alignof(max_align_t) == 0);
+    *value = 1.5L;
+
+    char* copy = ArenaStrndup(arena, "hello world", 5);
+    ck_assert_str_eq(copy, "hello");
+    ck_assert(GetArenaBlockCount(arena) == 1);
+
+    FreeArena(arena);
+} END_TEST
+
+START_TEST(test_arena_growth) {
+    Arena* arena = NewArena(0);
+    int* blocks[1000];
+
+    for (int i = 0; i < 1000; ++i) {
+        blocks[i] = ArenaAlloc(arena, sizeof(int) * 100);
+        ck_assert_ptr_nonnull(blocks[i]);
+        for (int k = 0; k < 100; ++k) {
+            blocks[i][k] = i;
+        }
+    }
+
+    // Earlier allocations survive new blocks
+    for (int i = 0; i < 1000; ++i) {
+        ck_assert(blocks[i][0] == i && blocks[i][99] == i);
+    }
+
+    ck_assert(GetArenaUsedBytes(arena) >= sizeof(int) * 100 * 1000);
+    ck_assert(GetArenaBlockCount(arena) > 1);
+    ck_assert(GetArenaBlockCount(arena) < 16);
+
+    // Bigger than a whole block
+    char* big = ArenaAlloc(arena, 1 << 22);
+    ck_assert_ptr_nonnull(big);
+    big[(1 << 22) - 1] = 'x';
+
+    FreeArena(arena);
+    FreeArena(NULL);
+} END_TEST
+
+Suite* make_arena_suite(void) {
+    Suite *s = suite_create("Arena tests");
+    TCase *tc = tcase_create("Arena");
+
+    tcase_add_test(tc, test_arena_alignment);
+    tcase_add_test(tc, test_arena_growth);
+    suite_add_tcase(s, tc);
+
+    return s;
+}
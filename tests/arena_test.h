@@ -0,0 +1,8 @@
+#pragma once
+
+#include <check.h>
+#include <stdbool.h>
+
+#include "../src/arena.h"
+
+Suite* make_arena_suite(void);
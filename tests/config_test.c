@@ -68,6 +68,299 @@ START_TEST(test_config_good) {
 } END_TEST
 
 
+START_TEST(test_config_bad8) {
+    FILE* file = fopen("./tests/config_folder/bad8.cfg", "r");
+    ExecutionConfig* config = ReadExecutionConfig(file, ".");
+
+    ck_assert(config == NULL);
+    fclose(file);
+} END_TEST
+
+START_TEST(test_config_bad9) {
+    FILE* file = fopen("./tests/config_folder/bad9.cfg", "r");
+    ExecutionConfig* config = ReadExecutionConfig(file, ".");
+
+    ck_assert(config == NULL);
+    fclose(file);
+} END_TEST
+
+START_TEST(test_config_bad10) {
+    FILE* file = fopen("./tests/config_folder/bad10.cfg", "r");
+    ExecutionConfig* config = ReadExecutionConfig(file, ".");
+
+    ck_assert(config == NULL);
+    fclose(file);
+} END_TEST
+
+START_TEST(test_config_bad11) {
+    FILE* file = fopen("./tests/config_folder/bad11.cfg", "r");
+    ExecutionConfig* config = ReadExecutionConfig(file, ".");
+
+    ck_assert(config == NULL);
+    fclose(file);
+} END_TEST
+
+START_TEST(test_config_timeouts) {
+    FILE* file = fopen("./tests/config_folder/timeouts.cfg", "r");
+    ExecutionConfig* config = ReadExecutionConfig(file, ".");
+
+    ck_assert(config != NULL);
+    ck_assert(config->tasks[0]->timeout_ms == 250);
+    ck_assert(config->tasks[1]->timeout_ms == 2000);
+    ck_assert(config->tasks[2]->timeout_ms == 5000);
+    ck_assert(config->tasks[3]->timeout_ms == 5000);
+    fclose(file);
+    FreeExecutionConfig(config);
+} END_TEST
+
+START_TEST(test_config_resources) {
+    FILE* file = fopen("./tests/config_folder/resources.cfg", "r");
+    ExecutionConfig* config = ReadExecutionConfig(file, ".");
+
+    ck_assert(config != NULL);
+    ck_assert(config->cpu_budget == 8);
+    ck_assert(config->memory_budget_mb == 1024);
+    ck_assert(config->tasks[0]->cpus == 4);
+    ck_assert(config->tasks[0]->memory_mb == 512);
+    ck_assert(config->tasks[1]->cpus == 0);
+    ck_assert(config->tasks[1]->memory_mb == 0);
+    fclose(file);
+    FreeExecutionConfig(config);
+} END_TEST
+
+START_TEST(test_config_many_tasks) {
+    FILE* file = tmpfile();
+    ck_assert(file != NULL);
+
+    fprintf(file, "[main]\nmax_concurrent_tasks: 4\n\n");
+    for (int i = 0; i < 5000; ++i) {
+        fprintf(file, "[task]\nname: task-%d\ntype: SLEEP\nsleep_duration: 0\n", i);
+        if (i > 0) {
+            fprintf(file, "requires: task-%d\n", i - 1);
+        }
+        fprintf(file, "\n");
+    }
+    rewind(file);
+
+    ExecutionConfig* config = ReadExecutionConfig(file, ".");
+
+    ck_assert(config != NULL);
+    ck_assert(config->num_tasks == 5000);
+    ck_assert_str_eq(config->tasks[4999]->name, "task-4999");
+    ck_assert(config->tasks[4999]->num_dependencies == 1);
+    ck_assert(config->tasks[4999]->dependencies[0] == 4998);
+    fclose(file);
+    FreeExecutionConfig(config);
+} END_TEST
+
+static ExecutionConfig* ReadConfigText(const char* text) {
+    FILE* file = tmpfile();
+    fputs(text, file);
+    rewind(file);
+
+    ExecutionConfig* config = ReadExecutionConfig(file, ".");
+    fclose(file);
+    return config;
+}
+
+START_TEST(test_config_dependencies) {
+    // Requirements may point forward, `none` alone means no requirements
+    ExecutionConfig* config = ReadConfigText(
+        "[task]\nname: a\ntype: SLEEP\nsleep_duration: 0\nrequires: c b\n\n"
+        "[task]\nname: b\ntype: SLEEP\nsleep_duration: 0\nrequires: none\n\n"
+        "[task]\nname: c\ntype: SLEEP\nsleep_duration: 0\nrequires: b\n");
+
+    ck_assert(config != NULL);
+    ck_assert(config->tasks[0]->num_dependencies == 2);
+    ck_assert(config->tasks[0]->dependencies[0] == 2);
+    ck_assert(config->tasks[0]->dependencies[1] == 1);
+    ck_assert(config->tasks[1]->num_dependencies == 0);
+    ck_assert(config->tasks[2]->num_dependencies == 1);
+    ck_assert(config->tasks[2]->dependencies[0] == 1);
+    FreeExecutionConfig(config);
+
+    // Unknown requirement
+    ck_assert(ReadConfigText("[task]\nname: a\ntype: SLEEP\nsleep_duration: 0\nrequires: b\n") == NULL);
+
+    // Duplicate names
+    ck_assert(ReadConfigText(
+        "[task]\nname: a\ntype: SLEEP\nsleep_duration: 0\n\n"
+        "[task]\nname: a\ntype: SLEEP\nsleep_duration: 0\n") == NULL);
+
+    // `none` among other requirements
+    ck_assert(ReadConfigText(
+        "[task]\nname: a\ntype: SLEEP\nsleep_duration: 0\n\n"
+        "[task]\nname: b\ntype: SLEEP\nsleep_duration: 0\nrequires: a none\n") == NULL);
+} END_TEST
+
+START_TEST(test_config_adaptive) {
+    FILE* file = fopen("./tests/config_folder/adaptive.cfg", "r");
+    ExecutionConfig* config = ReadExecutionConfig(file, ".");
+
+    ck_assert(config != NULL);
+    ck_assert(config->adaptive_concurrency);
+    ck_assert(config->max_concurrent_tasks == 2 * ADAPTIVE_CONCURRENCY_FACTOR);
+    fclose(file);
+    FreeExecutionConfig(config);
+
+    file = fopen("./tests/config_folder/resources.cfg", "r");
+    config = ReadExecutionConfig(file, ".");
+
+    ck_assert(config != NULL);
+    ck_assert(!config->adaptive_concurrency);
+    ck_assert(config->max_concurrent_tasks == 2);
+    fclose(file);
+    FreeExecutionConfig(config);
+} END_TEST
+
+static void WriteConfigText(int fd, const char* text) {
+    ck_assert(write(fd, text, strlen(text)) == (ssize_t)strlen(text));
+}
+
+static int PumpConfigStreamToEnd(ConfigStream* stream) {
+    int status;
+    while ((status = PumpConfigStream(stream)) == 1) {
+    }
+    return status;
+}
+
+START_TEST(test_config_stream_admission) {
+    int fds[2];
+    ck_assert(pipe(fds) == 0);
+    ConfigStream* stream = NewConfigStream(fds[0], ".");
+    ck_assert_ptr_nonnull(stream);
+    int task;
+
+    // b waits for c, which hasn't arrived yet, a and d are admitted before the input is over
+    WriteConfigText(fds[1],
+        "[main]\nmax_concurrent_tasks: 2\n\n"
+        "[task]\nname: a\ntype: SLEEP\nsleep_duration: 0\n\n"
+        "[task]\nname: b\ntype: SLEEP\nsleep_duration: 0\nrequires: c a\n\n"
+        "[task]\nname: d\ntype: SLEEP\nsleep_duration: 0\nrequires: a\n\n");
+    ck_assert_int_eq(PumpConfigStream(stream), 1);
+    ck_assert(IsConfigStreamSettled(stream));
+    ck_assert(stream->config->max_concurrent_tasks == 2);
+    ck_assert(stream->config->num_tasks == 3);
+    ck_assert(NextAdmittedTask(stream, &task) && task == 0);
+    ck_assert(NextAdmittedTask(stream, &task) && task == 2);
+    ck_assert(!NextAdmittedTask(stream, &task));
+
+    WriteConfigText(fds[1], "[task]\nname: c\ntype: SLEEP\nsleep_duration: 0\n");
+    close(fds[1]);
+    ck_assert_int_eq(PumpConfigStreamToEnd(stream), 0);
+    ck_assert(stream->config->num_tasks == 4);
+
+    // c closes at the end of input and unblocks b
+    ck_assert(NextAdmittedTask(stream, &task) && task == 3);
+    ck_assert(NextAdmittedTask(stream, &task) && task == 1);
+    ck_assert(!NextAdmittedTask(stream, &task));
+
+    const TaskConfig* b = stream->config->tasks[1];
+    ck_assert_str_eq(b->name, "b");
+    ck_assert(b->num_dependencies == 2);
+    ck_assert(b->dependencies[0] == 3 && b->dependencies[1] == 0);
+
+    ExecutionConfig* config = stream->config;
+    FreeConfigStream(stream);
+    FreeExecutionConfig(config);
+    close(fds[0]);
+} END_TEST
+
+// Stream text and return the pump status after it, the input is left open unless close_input.
+static int StreamConfigText(const char* text, bool close_input) {
+    int fds[2];
+    ck_assert(pipe(fds) == 0);
+    ConfigStream* stream = NewConfigStream(fds[0], ".");
+    ck_assert_ptr_nonnull(stream);
+
+    WriteConfigText(fds[1], text);
+    if (close_input) {
+        close(fds[1]);
+    }
+
+    int status = close_input ? PumpConfigStreamToEnd(stream) : PumpConfigStream(stream);
+
+    ExecutionConfig* config = stream->config;
+    FreeConfigStream(stream);
+    FreeExecutionConfig(config);
+    close(fds[0]);
+    if (!close_input) {
+        close(fds[1]);
+    }
+    return status;
+}
+
+START_TEST(test_config_stream_errors) {
+    // The cycle is found as soon as its last section is over, with more input still to come
+    ck_assert_int_eq(StreamConfigText(
+        "[task]\nname: a\ntype: SLEEP\nsleep_duration: 0\nrequires: b\n\n"
+        "[task]\nname: b\ntype: SLEEP\nsleep_duration: 0\nrequires: a\n\n", false), -1);
+
+    ck_assert_int_eq(StreamConfigText(
+        "[task]\nname: a\ntype: SLEEP\nsleep_duration: 0\nrequires: a\n\n", false), -1);
+
+    // A missing requirement is only known at the end of input
+    ck_assert_int_eq(StreamConfigText(
+        "[task]\nname: a\ntype: SLEEP\nsleep_duration: 0\nrequires: b\n\n", false), 1);
+    ck_assert_int_eq(StreamConfigText(
+        "[task]\nname: a\ntype: SLEEP\nsleep_duration: 0\nrequires: b\n", true), -1);
+
+    // Tasks are started with the settings of the main section
+    ck_assert_int_eq(StreamConfigText(
+        "[task]\nname: a\ntype: SLEEP\nsleep_duration: 0\n\n[main]\nmax_concurrent_tasks: 2\n", true), -1);
+
+    ck_assert_int_eq(StreamConfigText(
+        "[task]\nname: a\ntype: SLEEP\nsleep_duration: 0\n\n"
+        "[task]\nname: a\ntype: SLEEP\nsleep_duration: 0\n", true), -1);
+
+    ck_assert_int_eq(StreamConfigText("", true), 0);
+} END_TEST
+
+START_TEST(test_config_stream_matches_batch) {
+    // Long chain in reverse order: every section waits for the next one until the input is over
+    FILE* file = tmpfile();
+    ck_assert(file != NULL);
+    for (int i = 2999; i >= 0; --i) {
+        fprintf(file, "[task]\nname: task-%d\ntype: SLEEP\nsleep_duration: 0\n", i);
+        if (i > 0) {
+            fprintf(file, "requires: task-%d\n", i - 1);
+        }
+        fprintf(file, "\n");
+    }
+    rewind(file);
+
+    ExecutionConfig* batch = ReadExecutionConfig(file, ".");
+    ck_assert(batch != NULL);
+    rewind(file);
+
+    ConfigStream* stream = NewConfigStream(fileno(file), ".");
+    ck_assert_ptr_nonnull(stream);
+    ck_assert_int_eq(PumpConfigStreamToEnd(stream), 0);
+
+    ExecutionConfig* config = stream->config;
+    ck_assert(config->num_tasks == batch->num_tasks);
+    for (size_t i = 0; i < config->num_tasks; ++i) {
+        ck_assert_str_eq(config->tasks[i]->name, batch->tasks[i]->name);
+        ck_assert_str_eq(config->tasks[i]->log_path, batch->tasks[i]->log_path);
+        ck_assert(config->tasks[i]->num_dependencies == batch->tasks[i]->num_dependencies);
+        if (config->tasks[i]->num_dependencies) {
+            ck_assert(config->tasks[i]->dependencies[0] == batch->tasks[i]->dependencies[0]);
+        }
+    }
+
+    // Admitted in dependency order, i.e. the reverse of the input
+    int task;
+    for (int i = 2999; i >= 0; --i) {
+        ck_assert(NextAdmittedTask(stream, &task) && task == i);
+    }
+
+    FreeConfigStream(stream);
+    FreeExecutionConfig(config);
+    FreeExecutionConfig(batch);
+    fclose(file);
+} END_TEST
+
+
 Suite* make_config_suite(void) {
     Suite *s = suite_create("Graph::IsAcyclic");
     TCase *tc;
@@ -80,7 +373,19 @@ Suite* make_config_suite(void) {
     tcase_add_test(tc, test_config_bad5);
     tcase_add_test(tc, test_config_bad6);
     tcase_add_test(tc, test_config_bad7);
+    tcase_add_test(tc, test_config_bad8);
+    tcase_add_test(tc, test_config_bad9);
+    tcase_add_test(tc, test_config_bad10);
+    tcase_add_test(tc, test_config_bad11);
+    tcase_add_test(tc, test_config_timeouts);
+    tcase_add_test(tc, test_config_resources);
+    tcase_add_test(tc, test_config_adaptive);
+    tcase_add_test(tc, test_config_many_tasks);
+    tcase_add_test(tc, test_config_dependencies);
     tcase_add_test(tc, test_config_good);
+    tcase_add_test(tc, test_config_stream_admission);
+    tcase_add_test(tc, test_config_stream_errors);
+    tcase_add_test(tc, test_config_stream_matches_batch);
     suite_add_tcase(s, tc);
 
     return s;
@@ -0,0 +1,136 @@
+#include "dag_cache_test.h"
+
+static const char* kConfigText =
+    "[main]\nmax_concurrent_tasks: 3\n\n"
+    "[task]\nname: build\ntype: EXEC\nexec_command: make  all\ntimeout: 4\ncpus: 2\n\n"
+    "[task]\nname: test\ntype: SLEEP\nsleep_duration: 1\nrequires: build\n\n"
+    "[task]\nname: lint\ntype: EXEC\nexec_command: true\nrequires: build test\nmemory_mb: 64\n";
+
+static ExecutionConfig* ParseText(const char* text, uint64_t* key) {
+    // The parser takes the buffer over and frees the copy itself, even when parsing fails
+    char* copy = strdup(text);
+    ConfigBuffer buffer = {copy, strlen(copy), NULL, 0};
+
+    *key = HashDagCacheKey(&buffer, "/tmp/logs");
+    return ParseExecutionConfig(&buffer, "/tmp/logs");
+}
+
+static Graph* BuildGraph(const ExecutionConfig* config) {
+    Graph* graph = NewGraph(config->num_tasks);
+    for (size_t i = 0; i < config->num_tasks; ++i) {
+        for (size_t k = 0; k < config->tasks[i]->num_dependencies; ++k) {
+            AddDirectedEdge(graph, i, config->tasks[i]->dependencies[k]);
+        }
+    }
+
+    CompileGraph(graph);
+    return graph;
+}
+
+START_TEST(test_dag_cache_round_trip) {
+    char path[64];
+    MakeTempPath(path, "dag_cache_test");
+
+    uint64_t key;
+    ExecutionConfig* config = ParseText(kConfigText, &key);
+    ck_assert_ptr_nonnull(config);
+    Graph* graph = BuildGraph(config);
+    ck_assert(WriteDagCache(path, key, config, graph));
+
+    Graph* loaded_graph = NULL;
+    ExecutionConfig* loaded = LoadDagCache(path, key, &loaded_graph);
+    ck_assert_ptr_nonnull(loaded);
+    ck_assert_ptr_nonnull(loaded_graph);
+
+    ck_assert(loaded->num_tasks == 3);
+    ck_assert(loaded->max_concurrent_tasks == 3);
+    ck_assert(loaded->cpu_budget == config->cpu_budget);
+    ck_assert(loaded->memory_budget_mb == config->memory_budget_mb);
+
+    for (size_t i = 0; i < 3; ++i) {
+        const TaskConfig* expected = config->tasks[i];
+        const TaskConfig* task = loaded->tasks[i];
+
+        ck_assert_str_eq(task->name, expected->name);
+        ck_assert_str_eq(task->log_path, expected->log_path);
+        ck_assert(task->type == expected->type);
+        ck_assert(task->timeout_ms == expected->timeout_ms);
+        ck_assert(task->cpus == expected->cpus);
+        ck_assert(task->memory_mb == expected->memory_mb);
+        ck_assert(task->num_dependencies == expected->num_dependencies);
+        for (size_t k = 0; k < task->num_dependencies; ++k) {
+            ck_assert(task->dependencies[k] == expected->dependencies[k]);
+        }
+    }
+
+    ck_assert_str_eq(loaded->tasks[0]->exec_args->argv[0], PATH_TO_EXECUTABLE);
+    ck_assert_str_eq(loaded->tasks[0]->exec_args->command, "make all");
+    ck_assert(loaded->tasks[1]->sleep_args->duration == 1);
+
+    // Graph arrays are used in place
+    ck_assert(GetEdgeCount(loaded_graph) == GetEdgeCount(graph));
+    for (size_t v = 0; v < 3; ++v) {
+        size_t count, expected_count;
+        const int* successors = GetSuccessorArray(loaded_graph, v, &count);
+        const int* expected = GetSuccessorArray(graph, v, &expected_count);
+        ck_assert(count == expected_count);
+        ck_assert(memcmp(successors, expected, sizeof(int) * count) == 0);
+
+        GetPredecessorArray(loaded_graph, v, &count);
+        GetPredecessorArray(graph, v, &expected_count);
+        ck_assert(count == expected_count);
+    }
+    ck_assert(IsAcyclic(loaded_graph));
+
+    FreeGraph(loaded_graph);
+    FreeExecutionConfig(loaded);
+    FreeGraph(graph);
+    FreeExecutionConfig(config);
+    unlink(path);
+} END_TEST
+
+START_TEST(test_dag_cache_stale) {
+    char path[64];
+    MakeTempPath(path, "dag_cache_test");
+
+    uint64_t key;
+    ExecutionConfig* config = ParseText(kConfigText, &key);
+    Graph* graph = BuildGraph(config);
+    ck_assert(WriteDagCache(path, key, config, graph));
+
+    // Another text or log directory is another key
+    uint64_t other_key;
+    char* changed = strdup(kConfigText);
+    changed[strlen(changed) - 2] = '5';
+    ConfigBuffer buffer = {changed, strlen(changed), NULL, 0};
+    other_key = HashDagCacheKey(&buffer, "/tmp/logs");
+    ck_assert(other_key != key);
+    ck_assert(HashDagCacheKey(&buffer, "/tmp/other") != other_key);
+    free(changed);
+
+    Graph* loaded_graph = NULL;
+    ck_assert_ptr_null(LoadDagCache(path, other_key, &loaded_graph));
+
+    // Truncated file
+    ck_assert(truncate(path, 100) == 0);
+    ck_assert_ptr_null(LoadDagCache(path, key, &loaded_graph));
+
+    // Missing file
+    unlink(path);
+    ck_assert_ptr_null(LoadDagCache(path, key, &loaded_graph));
+    ck_assert_ptr_null(loaded_graph);
+
+    FreeGraph(graph);
+    FreeExecutionConfig(config);
+} END_TEST
+
+Suite* make_dag_cache_suite(void) {
+    Suite *s = suite_create("DAG cache tests");
+    TCase *tc = tcase_create("DagCache");
+
+    tcase_add_test(tc, test_dag_cache_round_trip);
+    tcase_add_test(tc, test_dag_cache_stale);
+    suite_add_tcase(s, tc);
+
+    return s;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <check.h>
+#include <stdbool.h>
+
+#include "../src/dag_cache.h"
+#include "test_utils.h"
+
+Suite* make_dag_cache_suite(void);
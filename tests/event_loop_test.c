@@ -0,0 +1,186 @@
+#include "event_loop_test.h"
+
+typedef struct HandlerLog {
+    int num_calls;
+    uint32_t last_events;
+    bool drain;  // read the ready fd empty, otherwise level triggering reports it again
+} HandlerLog;
+
+static bool LogEvent(EventSource* source, uint32_t events) {
+    HandlerLog* log = source->data;
+    log->num_calls++;
+    log->last_events = events;
+    if (log->drain) {
+        DrainEventFd(source->fd);
+    }
+    return true;
+}
+
+static bool FailEvent(EventSource* source, uint32_t events) {
+    return false;
+}
+
+static volatile sig_atomic_t num_alarms = 0;
+
+static void CountAlarm(int signal) {
+    num_alarms++;
+}
+
+START_TEST(test_event_loop_watch_unwatch) {
+    EventLoop* loop = NewEventLoop();
+    ck_assert_ptr_nonnull(loop);
+
+    int fds[2];
+    ck_assert_int_eq(pipe(fds), 0);
+    ck_assert_int_eq(fcntl(fds[0], F_SETFL, O_NONBLOCK), 0);
+
+    HandlerLog log = {.drain = true};
+    EventSource source = {.fd = fds[0], .handler = LogEvent, .data = &log};
+    ck_assert(WatchEventSource(loop, &source, EPOLLIN));
+    ck_assert_uint_eq(GetEventSourceCount(loop), 1);
+
+    // Nothing ready yet
+    ck_assert_int_eq(PollEventLoop(loop, 0), 0);
+    ck_assert_int_eq(log.num_calls, 0);
+
+    ck_assert_int_eq(write(fds[1], "x", 1), 1);
+    ck_assert_int_eq(PollEventLoop(loop, 100), 1);
+    ck_assert_int_eq(log.num_calls, 1);
+    ck_assert(log.last_events & EPOLLIN);
+
+    ck_assert(UnwatchEventSource(loop, &source));
+    ck_assert_uint_eq(GetEventSourceCount(loop), 0);
+    ck_assert_int_eq(write(fds[1], "x", 1), 1);
+    ck_assert_int_eq(PollEventLoop(loop, 0), 0);
+    ck_assert_int_eq(log.num_calls, 1);
+
+    // A failing handler fails the poll
+    EventSource failing = {.fd = fds[0], .handler = FailEvent, .data = NULL};
+    ck_assert(WatchEventSource(loop, &failing, EPOLLIN));
+    ck_assert_int_eq(PollEventLoop(loop, 0), -1);
+
+    EventSource no_handler = {.fd = fds[1], .handler = NULL, .data = NULL};
+    ck_assert(!WatchEventSource(loop, &no_handler, EPOLLOUT));
+    ck_assert_int_eq(errno, EINVAL);
+
+    close(fds[0]);
+    close(fds[1]);
+    FreeEventLoop(loop);
+} END_TEST
+
+START_TEST(test_event_loop_poll_retries_on_eintr) {
+    EventLoop* loop = NewEventLoop();
+    ck_assert_ptr_nonnull(loop);
+
+    // Without SA_RESTART the alarm interrupts epoll_wait before the timer fires
+    struct sigaction action = {0}, old_action;
+    action.sa_handler = CountAlarm;
+    sigemptyset(&action.sa_mask);
+    ck_assert_int_eq(sigaction(SIGALRM, &action, &old_action), 0);
+    num_alarms = 0;
+
+    int timer_fd = OpenIntervalTimerFd(200);
+    ck_assert_int_ne(timer_fd, -1);
+    HandlerLog log = {.drain = true};
+    EventSource source = {.fd = timer_fd, .handler = LogEvent, .data = &log};
+    ck_assert(WatchEventSource(loop, &source, EPOLLIN));
+
+    struct itimerval alarm_timer = {.it_value = {.tv_sec = 0, .tv_usec = 20000}};
+    ck_assert_int_eq(setitimer(ITIMER_REAL, &alarm_timer, NULL), 0);
+
+    int num_dispatched = PollEventLoop(loop, 2000);
+
+    sigaction(SIGALRM, &old_action, NULL);
+    ck_assert_int_eq(num_alarms, 1);
+    ck_assert_int_eq(num_dispatched, 1);
+    ck_assert_int_eq(log.num_calls, 1);
+
+    close(timer_fd);
+    FreeEventLoop(loop);
+} END_TEST
+
+START_TEST(test_event_loop_child_signal_fd) {
+    EventLoop* loop = NewEventLoop();
+    ck_assert_ptr_nonnull(loop);
+
+    sigset_t old_mask;
+    int signal_fd = OpenChildSignalFd(&old_mask);
+    ck_assert_int_ne(signal_fd, -1);
+
+    HandlerLog log = {.drain = true};
+    EventSource source = {.fd = signal_fd, .handler = LogEvent, .data = &log};
+    ck_assert(WatchEventSource(loop, &source, EPOLLIN));
+
+    pid_t pid = fork();
+    ck_assert_int_ne(pid, -1);
+    if (pid == 0) {
+        _exit(7);
+    }
+
+    ck_assert_int_eq(PollEventLoop(loop, 2000), 1);
+    ck_assert_int_eq(log.num_calls, 1);
+
+    int status;
+    ck_assert_int_eq(waitpid(pid, &status, WNOHANG), pid);
+    ck_assert(WIFEXITED(status) && WEXITSTATUS(status) == 7);
+
+    // Drained by the handler, nothing is left to report
+    ck_assert_int_eq(PollEventLoop(loop, 0), 0);
+
+    close(signal_fd);
+    sigprocmask(SIG_SETMASK, &old_mask, NULL);
+    FreeEventLoop(loop);
+} END_TEST
+
+START_TEST(test_event_loop_interval_timer) {
+    EventLoop* loop = NewEventLoop();
+    ck_assert_ptr_nonnull(loop);
+
+    int timer_fd = OpenIntervalTimerFd(10);
+    ck_assert_int_ne(timer_fd, -1);
+    HandlerLog log = {.drain = true};
+    EventSource source = {.fd = timer_fd, .handler = LogEvent, .data = &log};
+    ck_assert(WatchEventSource(loop, &source, EPOLLIN));
+
+    // Fires every interval, not just once
+    for (int i = 0; i < 3; ++i) {
+        ck_assert_int_eq(PollEventLoop(loop, 1000), 1);
+    }
+    ck_assert_int_eq(log.num_calls, 3);
+
+    close(timer_fd);
+    FreeEventLoop(loop);
+} END_TEST
+
+START_TEST(test_event_loop_drain) {
+    int timer_fd = OpenIntervalTimerFd(1);
+    ck_assert_int_ne(timer_fd, -1);
+    usleep(20000);
+
+    // Several expirations are consumed at once and the fd is left empty
+    ck_assert(DrainEventFd(timer_fd));
+    uint64_t expirations;
+    ck_assert_int_eq(read(timer_fd, &expirations, sizeof(expirations)), -1);
+    ck_assert_int_eq(errno, EAGAIN);
+    ck_assert(DrainEventFd(timer_fd));
+
+    close(timer_fd);
+    ck_assert(!DrainEventFd(timer_fd));
+} END_TEST
+
+
+Suite* make_event_loop_suite(void) {
+    Suite *s = suite_create("Event loop tests");
+    TCase *tc;
+
+    tc = tcase_create("EventLoopTests");
+    tcase_add_test(tc, test_event_loop_watch_unwatch);
+    tcase_add_test(tc, test_event_loop_poll_retries_on_eintr);
+    tcase_add_test(tc, test_event_loop_child_signal_fd);
+    tcase_add_test(tc, test_event_loop_interval_timer);
+    tcase_add_test(tc, test_event_loop_drain);
+
+    suite_add_tcase(s, tc);
+
+    return s;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <check.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+
+#include "../src/event_loop.h"
+
+Suite* make_event_loop_suite(void);
@@ -96,6 +96,119 @@ START_TEST(test_graph_is_acyclic_very_large_chain) {
     FreeGraph(g);
 } END_TEST
 
+START_TEST(test_graph_csr_arrays) {
+    Graph* g = NewGraph(4);
+    ck_assert_ptr_nonnull(g);
+
+    AddDirectedEdge(g, 0, 1);
+    AddDirectedEdge(g, 0, 2);
+    AddDirectedEdge(g, 3, 2);
+    ck_assert(CompileGraph(g));
+
+    size_t count;
+    const int* successors = GetSuccessorArray(g, 0, &count);
+    ck_assert(count == 2);
+    ck_assert((successors[0] == 1 && successors[1] == 2) || (successors[0] == 2 && successors[1] == 1));
+
+    const int* predecessors = GetPredecessorArray(g, 2, &count);
+    ck_assert(count == 2);
+    ck_assert((predecessors[0] == 0 && predecessors[1] == 3) || (predecessors[0] == 3 && predecessors[1] == 0));
+
+    GetSuccessorArray(g, 1, &count);
+    ck_assert(count == 0);
+    GetPredecessorArray(g, 3, &count);
+    ck_assert(count == 0);
+
+    ck_assert(GetEdgeCount(g) == 3);
+    FreeGraph(g);
+} END_TEST
+
+START_TEST(test_graph_csr_merges_multiple_edges) {
+    Graph* g = NewGraph(3);
+    ck_assert_ptr_nonnull(g);
+
+    for (int i = 0; i < 10; ++i) {
+        AddDirectedEdge(g, 0, 1);
+        AddDirectedEdge(g, 2, 1);
+    }
+
+    size_t count;
+    GetSuccessorArray(g, 0, &count);
+    ck_assert(count == 1);
+    GetPredecessorArray(g, 1, &count);
+    ck_assert(count == 2);
+    ck_assert(GetEdgeCount(g) == 2);
+
+    FreeGraph(g);
+} END_TEST
+
+START_TEST(test_graph_recompile_after_new_edges) {
+    Graph* g = NewGraph(3);
+    ck_assert_ptr_nonnull(g);
+
+    AddDirectedEdge(g, 0, 1);
+    AddDirectedEdge(g, 1, 2);
+    ck_assert(IsAcyclic(g));
+
+    AddDirectedEdge(g, 2, 0);
+    ck_assert(!IsAcyclic(g));
+    ck_assert(GetEdgeCount(g) == 3);
+
+    FreeGraph(g);
+} END_TEST
+
+START_TEST(test_graph_successors_vector) {
+    Graph* g = NewGraph(5);
+    ck_assert_ptr_nonnull(g);
+
+    AddDirectedEdge(g, 4, 0);
+    AddDirectedEdge(g, 4, 3);
+
+    IntVector* successors = GetSuccessors(g, 4);
+    ck_assert_ptr_nonnull(successors);
+    ck_assert(GetIntVectorLength(successors) == 2);
+    ck_assert(VertexHasSuccessors(g, 4));
+    ck_assert(!VertexHasSuccessors(g, 0));
+    ck_assert(!VertexHasSuccessors(g, 5));
+    ck_assert(!VertexHasSuccessors(NULL, 0));
+
+    FreeIntVector(successors);
+    FreeGraph(g);
+} END_TEST
+
+START_TEST(test_graph_out_of_range) {
+    Graph* g = NewGraph(2);
+    ck_assert_ptr_nonnull(g);
+
+    ck_assert(!AddDirectedEdge(g, 0, 2));
+    ck_assert(!AddDirectedEdge(g, 2, 0));
+
+    size_t count;
+    ck_assert_ptr_null(GetSuccessorArray(g, 2, &count));
+    ck_assert(count == 0);
+
+    FreeGraph(g);
+} END_TEST
+
+START_TEST(test_graph_is_acyclic_huge_sparse) {
+    // Would need 40 GB as a dense matrix
+    int vertices_count = 100000;
+    Graph* g = NewGraph(vertices_count);
+    ck_assert_ptr_nonnull(g);
+
+    for (int i = 1; i < vertices_count; ++i) {
+        AddDirectedEdge(g, i, i / 2);
+        AddDirectedEdge(g, i, i - 1);
+    }
+
+    ck_assert(IsAcyclic(g));
+
+    AddDirectedEdge(g, 0, vertices_count - 1);
+    ck_assert(!IsAcyclic(g));
+
+    FreeGraph(g);
+} END_TEST
+
 Suite* make_graph_is_acyclic_suite(void) {
     Suite *s = suite_create("Graph::IsAcyclic");
     TCase *tc;
@@ -107,11 +220,20 @@ Suite* make_graph_is_acyclic_suite(void) {
     tcase_add_test(tc, test_graph_is_acyclic_single_loop);
     suite_add_tcase(s, tc);
 
+    tc = tcase_create("CsrTests");
+    tcase_add_test(tc, test_graph_csr_arrays);
+    tcase_add_test(tc, test_graph_csr_merges_multiple_edges);
+    tcase_add_test(tc, test_graph_recompile_after_new_edges);
+    tcase_add_test(tc, test_graph_successors_vector);
+    tcase_add_test(tc, test_graph_out_of_range);
+    suite_add_tcase(s, tc);
+
     tc = tcase_create("StressTests");
     tcase_add_test(tc, test_graph_is_acyclic_multiple_edges);
     tcase_add_test(tc, test_graph_is_acyclic_many_loops);
     tcase_add_test(tc, test_graph_is_acyclic_very_large_loop);
     tcase_add_test(tc, test_graph_is_acyclic_very_large_chain);
+    tcase_add_test(tc, test_graph_is_acyclic_huge_sparse);
     suite_add_tcase(s, tc);
 
     return s;
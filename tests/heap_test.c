@@ -0,0 +1,101 @@
+#include "heap_test.h"
+
+START_TEST(test_heap_simple1) {
+    Heap* h = NewHeap(1);
+    ck_assert_ptr_nonnull(h);
+
+    PushHeap(h, 1, 10);
+    PushHeap(h, 2, 30);
+    PushHeap(h, 3, 20);
+
+    int n1, n2, n3;
+
+    TopHeap(h, &n1);
+    PopHeap(h);
+    TopHeap(h, &n2);
+    PopHeap(h);
+    TopHeap(h, &n3);
+    PopHeap(h);
+
+    ck_assert((n1 == 2) && (n2 == 3) && (n3 == 1));
+    ck_assert(IsHeapEmpty(h));
+    FreeHeap(h);
+} END_TEST
+
+START_TEST(test_heap_equal_priorities) {
+    Heap* h = NewHeap(4);
+    ck_assert_ptr_nonnull(h);
+
+    PushHeap(h, 7, 5);
+    PushHeap(h, 3, 5);
+    PushHeap(h, 5, 5);
+
+    int n1, n2, n3;
+
+    TopHeap(h, &n1);
+    PopHeap(h);
+    TopHeap(h, &n2);
+    PopHeap(h);
+    TopHeap(h, &n3);
+    PopHeap(h);
+
+    ck_assert((n1 == 3) && (n2 == 5) && (n3 == 7));
+    FreeHeap(h);
+} END_TEST
+
+START_TEST(test_heap_empty) {
+    Heap* h = NewHeap(0);
+    ck_assert_ptr_nonnull(h);
+
+    int value;
+    ck_assert(!TopHeap(h, &value));
+    PopHeap(h);
+    PopHeap(h);
+
+    ck_assert(IsHeapEmpty(h));
+    ck_assert(GetHeapSize(h) == 0);
+    FreeHeap(h);
+} END_TEST
+
+START_TEST(test_heap_large_test) {
+    int n = 100000;
+
+    Heap* h = NewHeap(1);
+    ck_assert_ptr_nonnull(h);
+
+    // Pushing priorities in scrambled order
+    for (int i = 0; i < n; ++i) {
+        int priority = (int)(((long long)i * 7919) % n);
+        PushHeap(h, priority, priority);
+    }
+
+    ck_assert(GetHeapSize(h) == n);
+
+    bool res = true;
+    int value;
+    for (int i = n - 1; i >= 0; --i) {
+        TopHeap(h, &value);
+        res = res && (value == i);
+        PopHeap(h);
+    }
+
+    ck_assert(res);
+    ck_assert(IsHeapEmpty(h));
+    FreeHeap(h);
+} END_TEST
+
+
+Suite* make_heap_suite(void) {
+    Suite *s = suite_create("Heap tests");
+    TCase *tc;
+
+    tc = tcase_create("HeapTests");
+    tcase_add_test(tc, test_heap_simple1);
+    tcase_add_test(tc, test_heap_equal_priorities);
+    tcase_add_test(tc, test_heap_empty);
+    tcase_add_test(tc, test_heap_large_test);
+
+    suite_add_tcase(s, tc);
+
+    return s;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <check.h>
+#include <stdbool.h>
+
+#include "../src/heap.h"
+
+Suite* make_heap_suite(void);
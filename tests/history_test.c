@@ -0,0 +1,188 @@
+#include "history_test.h"
+
+static char* task_names[] = {"build", "test", "deploy"};
+
+static void AppendRun(RuntimeHistory* history, size_t task, int64_t duration_ms, int wait_status) {
+    TaskRunRecord record = {
+        .start_ns = 1000000000,
+        .end_ns = 1000000000 + duration_ms * 1000000,
+        .wait_status = wait_status
+    };
+
+    AppendTaskRun(history, task, &record);
+}
+
+START_TEST(test_history_empty_file) {
+    FakeConfig fake;
+    InitFakeConfig(&fake, task_names, 3, 1);
+    char path[64];
+    MakeTempPath(path, "history_test");
+
+    RuntimeHistory* history = NewRuntimeHistory(path, &fake.config);
+    ck_assert_ptr_nonnull(history);
+
+    RuntimeStats stats;
+    ck_assert(!GetTaskRuntimeStats(history, 0, &stats));
+    ck_assert(stats.num_runs == 0);
+    FreeRuntimeHistory(history);
+
+    // A missing file is the same as an empty one
+    unlink(path);
+    history = NewRuntimeHistory(path, &fake.config);
+    ck_assert_ptr_nonnull(history);
+    ck_assert(!GetTaskRuntimeStats(history, 0, &stats));
+
+    FreeRuntimeHistory(history);
+    unlink(path);
+} END_TEST
+
+START_TEST(test_history_median_and_p95) {
+    FakeConfig fake;
+    InitFakeConfig(&fake, task_names, 3, 1);
+    char path[64];
+    MakeTempPath(path, "history_test");
+
+    RuntimeHistory* history = NewRuntimeHistory(path, &fake.config);
+    ck_assert_ptr_nonnull(history);
+
+    // 1..20 seconds for "test", in scrambled order
+    for (int i = 0; i < 20; ++i) {
+        AppendRun(history, 1, ((i * 7) % 20 + 1) * 1000, 0);
+    }
+    AppendRun(history, 0, 500, 0);
+    FreeRuntimeHistory(history);
+
+    history = NewRuntimeHistory(path, &fake.config);
+    ck_assert_ptr_nonnull(history);
+
+    RuntimeStats stats;
+    ck_assert(GetTaskRuntimeStats(history, 1, &stats));
+    ck_assert(stats.num_runs == 20);
+    ck_assert(stats.median_ms == 10000);
+    ck_assert(stats.p95_ms == 19000);
+
+    ck_assert(GetTaskRuntimeStats(history, 0, &stats));
+    ck_assert(stats.num_runs == 1 && stats.median_ms == 500 && stats.p95_ms == 500);
+
+    ck_assert(!GetTaskRuntimeStats(history, 2, &stats));
+
+    FreeRuntimeHistory(history);
+    unlink(path);
+} END_TEST
+
+START_TEST(test_history_ignores_failed_runs) {
+    FakeConfig fake;
+    InitFakeConfig(&fake, task_names, 3, 1);
+    char path[64];
+    MakeTempPath(path, "history_test");
+
+    RuntimeHistory* history = NewRuntimeHistory(path, &fake.config);
+    AppendRun(history, 2, 100, 0);
+    AppendRun(history, 2, 999999, SIGKILL);
+    AppendRun(history, 2, 999999, 1 << 8);
+    FreeRuntimeHistory(history);
+
+    history = NewRuntimeHistory(path, &fake.config);
+    RuntimeStats stats;
+    ck_assert(GetTaskRuntimeStats(history, 2, &stats));
+    ck_assert(stats.num_runs == 1 && stats.median_ms == 100);
+
+    FreeRuntimeHistory(history);
+    unlink(path);
+} END_TEST
+
+START_TEST(test_history_keeps_latest_window) {
+    FakeConfig fake;
+    InitFakeConfig(&fake, task_names, 3, 1);
+    char path[64];
+    MakeTempPath(path, "history_test");
+
+    RuntimeHistory* history = NewRuntimeHistory(path, &fake.config);
+    for (int i = 0; i < HISTORY_WINDOW; ++i) {
+        AppendRun(history, 0, 100000, 0);
+    }
+    for (int i = 0; i < HISTORY_WINDOW; ++i) {
+        AppendRun(history, 0, 10, 0);
+    }
+    FreeRuntimeHistory(history);
+
+    history = NewRuntimeHistory(path, &fake.config);
+    RuntimeStats stats;
+    ck_assert(GetTaskRuntimeStats(history, 0, &stats));
+    ck_assert(stats.num_runs == HISTORY_WINDOW);
+    ck_assert(stats.p95_ms == 10);
+
+    FreeRuntimeHistory(history);
+    unlink(path);
+} END_TEST
+
+START_TEST(test_history_foreign_file) {
+    FakeConfig fake;
+    InitFakeConfig(&fake, task_names, 3, 1);
+    char path[64];
+    MakeTempPath(path, "history_test");
+
+    FILE* file = fopen(path, "w");
+    fputs("definitely not a history file", file);
+    fclose(file);
+
+    RuntimeHistory* history = NewRuntimeHistory(path, &fake.config);
+    ck_assert_ptr_nonnull(history);
+
+    RuntimeStats stats;
+    ck_assert(!GetTaskRuntimeStats(history, 0, &stats));
+
+    // Appends are dropped instead of corrupting the foreign file
+    AppendRun(history, 0, 10, 0);
+    FreeRuntimeHistory(history);
+
+    struct stat st;
+    stat(path, &st);
+    ck_assert(st.st_size == strlen("definitely not a history file"));
+
+    unlink(path);
+} END_TEST
+
+START_TEST(test_history_torn_record) {
+    FakeConfig fake;
+    InitFakeConfig(&fake, task_names, 3, 1);
+    char path[64];
+    MakeTempPath(path, "history_test");
+
+    RuntimeHistory* history = NewRuntimeHistory(path, &fake.config);
+    AppendRun(history, 0, 10, 0);
+    FreeRuntimeHistory(history);
+
+    // Simulating an interrupted append
+    int fd = open(path, O_WRONLY | O_APPEND);
+    ck_assert(write(fd, "torn", 4) == 4);
+    close(fd);
+
+    history = NewRuntimeHistory(path, &fake.config);
+    AppendRun(history, 0, 20, 0);
+    FreeRuntimeHistory(history);
+
+    history = NewRuntimeHistory(path, &fake.config);
+    RuntimeStats stats;
+    ck_assert(GetTaskRuntimeStats(history, 0, &stats));
+    ck_assert(stats.num_runs == 2 && stats.median_ms == 10 && stats.p95_ms == 20);
+
+    FreeRuntimeHistory(history);
+    unlink(path);
+} END_TEST
+
+Suite* make_history_suite(void) {
+    Suite *s = suite_create("History tests");
+    TCase *tc;
+
+    tc = tcase_create("RuntimeHistory");
+    tcase_add_test(tc, test_history_empty_file);
+    tcase_add_test(tc, test_history_median_and_p95);
+    tcase_add_test(tc, test_history_ignores_failed_runs);
+    tcase_add_test(tc, test_history_keeps_latest_window);
+    tcase_add_test(tc, test_history_foreign_file);
+    tcase_add_test(tc, test_history_torn_record);
+    suite_add_tcase(s, tc);
+
+    return s;
+}
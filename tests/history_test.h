@@ -0,0 +1,9 @@
+#pragma once
+
+#include <check.h>
+#include <stdbool.h>
+
+#include "../src/history.h"
+#include "test_utils.h"
+
+Suite* make_history_suite(void);
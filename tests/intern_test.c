@@ -0,0 +1,56 @@
+#include "intern_test.h"
+
+static StringView View(const char* str) {
+    return (StringView){str, strlen(str)};
+}
+
+START_TEST(test_intern_dense_ids) {
+    NameTable* table = NewNameTable();
+    ck_assert_ptr_nonnull(table);
+
+    ck_assert(InternName(table, View("build")) == 0);
+    ck_assert(InternName(table, View("test")) == 1);
+    ck_assert(InternName(table, View("build")) == 0);
+
+    // Views of other buffers with the same bytes are the same name
+    const char* text = "test lint";
+    ck_assert(InternName(table, (StringView){text, 4}) == 1);
+    ck_assert(InternName(table, (StringView){text + 5, 4}) == 2);
+    ck_assert(InternName(table, (StringView){text, 2}) == 3);
+
+    ck_assert(FindInternedName(table, View("lint")) == 2);
+    ck_assert(FindInternedName(table, View("deploy")) == -1);
+    ck_assert(GetInternedNameCount(table) == 4);
+    ck_assert(ViewEquals(GetInternedName(table, 1), "test"));
+    ck_assert_ptr_null(GetInternedName(table, 4).data);
+
+    FreeNameTable(table);
+} END_TEST
+
+START_TEST(test_intern_growth) {
+    NameTable* table = NewNameTable();
+    static char names[10000][16];
+
+    for (int i = 0; i < 10000; ++i) {
+        snprintf(names[i], sizeof(names[i]), "task-%d", i);
+        ck_assert(InternName(table, View(names[i])) == i);
+    }
+
+    for (int i = 0; i < 10000; ++i) {
+        ck_assert(FindInternedName(table, View(names[i])) == i);
+    }
+    ck_assert(GetInternedNameCount(table) == 10000);
+
+    FreeNameTable(table);
+} END_TEST
+
+Suite* make_intern_suite(void) {
+    Suite *s = suite_create("Intern tests");
+    TCase *tc = tcase_create("NameTable");
+
+    tcase_add_test(tc, test_intern_dense_ids);
+    tcase_add_test(tc, test_intern_growth);
+    suite_add_tcase(s, tc);
+
+    return s;
+}
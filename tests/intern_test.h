@@ -0,0 +1,8 @@
+#pragma once
+
+#include <check.h>
+#include <stdbool.h>
+
+#include "../src/intern.h"
+
+Suite* make_intern_suite(void);
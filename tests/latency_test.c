@@ -0,0 +1,104 @@
+#include "latency_test.h"
+
+START_TEST(test_latency_small_values_exact) {
+    LatencyHistogram histogram;
+    InitLatencyHistogram(&histogram);
+
+    ck_assert(GetLatencyPercentile(&histogram, 50) == 0);
+
+    for (uint64_t i = 1; i <= 100; ++i) {
+        RecordLatency(&histogram, i);
+    }
+
+    ck_assert(GetLatencyCount(&histogram) == 100);
+    ck_assert(GetLatencyPercentile(&histogram, 50) == 50);
+    ck_assert(GetLatencyPercentile(&histogram, 99) == 99);
+    ck_assert(GetLatencyPercentile(&histogram, 100) == 100);
+    ck_assert(GetLatencyPercentile(&histogram, 0) == 1);
+    ck_assert(GetLatencyMax(&histogram) == 100);
+} END_TEST
+
+START_TEST(test_latency_relative_error) {
+    LatencyHistogram histogram;
+
+    // A single value comes back as its bucket bound, clamped by the exact maximum
+    const uint64_t values[] = {127, 128, 1000, 123456, 987654321, 3600000000000ULL};
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+        InitLatencyHistogram(&histogram);
+        RecordLatency(&histogram, values[i]);
+        RecordLatency(&histogram, values[i] * 2);
+
+        uint64_t p50 = GetLatencyPercentile(&histogram, 50);
+        ck_assert(p50 >= values[i]);
+        ck_assert(p50 - values[i] <= values[i] / 64);
+        ck_assert(GetLatencyPercentile(&histogram, 100) == values[i] * 2);
+    }
+
+    // Values past the tracked range share the last bucket
+    InitLatencyHistogram(&histogram);
+    RecordLatency(&histogram, UINT64_MAX);
+    ck_assert(GetLatencyCount(&histogram) == 1);
+    ck_assert(GetLatencyMax(&histogram) == UINT64_MAX);
+} END_TEST
+
+START_TEST(test_latency_p99) {
+    LatencyHistogram histogram;
+    InitLatencyHistogram(&histogram);
+
+    for (int i = 0; i < 990; ++i) {
+        RecordLatency(&histogram, 1000);
+    }
+    for (int i = 0; i < 10; ++i) {
+        RecordLatency(&histogram, 1000000);
+    }
+
+    ck_assert(GetLatencyPercentile(&histogram, 50) < 1016);
+    ck_assert(GetLatencyPercentile(&histogram, 99) < 1016);
+    ck_assert(GetLatencyPercentile(&histogram, 99.9) >= 1000000);
+} END_TEST
+
+START_TEST(test_latency_stages) {
+    SchedulingStats* stats = NewSchedulingStats(2);
+    ck_assert_ptr_nonnull(stats);
+
+    for (int stage = SCHEDULING_STAGE_READY; stage < SCHEDULING_STAGE_COUNT; ++stage) {
+        MarkSchedulingStage(stats, 0, stage);
+    }
+
+    // Task 1 fails to spawn and is released without being reaped
+    MarkSchedulingStage(stats, 1, SCHEDULING_STAGE_READY);
+    MarkSchedulingStage(stats, 1, SCHEDULING_STAGE_ENQUEUED);
+    MarkSchedulingStage(stats, 1, SCHEDULING_STAGE_DEQUEUED);
+    MarkSchedulingStage(stats, 1, SCHEDULING_STAGE_RELEASED);
+
+    // Out of range tasks and disabled stats are ignored
+    MarkSchedulingStage(stats, 2, SCHEDULING_STAGE_READY);
+    MarkSchedulingStage(NULL, 0, SCHEDULING_STAGE_READY);
+
+    ck_assert(GetLatencyCount(GetStageLatencies(stats, SCHEDULING_STAGE_READY)) == 0);
+    ck_assert(GetLatencyCount(GetStageLatencies(stats, SCHEDULING_STAGE_ENQUEUED)) == 2);
+    ck_assert(GetLatencyCount(GetStageLatencies(stats, SCHEDULING_STAGE_DEQUEUED)) == 2);
+    ck_assert(GetLatencyCount(GetStageLatencies(stats, SCHEDULING_STAGE_SPAWNED)) == 1);
+    ck_assert(GetLatencyCount(GetStageLatencies(stats, SCHEDULING_STAGE_REAPED)) == 1);
+    ck_assert(GetLatencyCount(GetStageLatencies(stats, SCHEDULING_STAGE_RELEASED)) == 1);
+    ck_assert_ptr_null(GetStageLatencies(stats, SCHEDULING_STAGE_COUNT));
+
+    FreeSchedulingStats(stats);
+} END_TEST
+
+Suite* make_latency_suite(void) {
+    Suite *s = suite_create("Latency tests");
+    TCase *tc;
+
+    tc = tcase_create("LatencyHistogram");
+    tcase_add_test(tc, test_latency_small_values_exact);
+    tcase_add_test(tc, test_latency_relative_error);
+    tcase_add_test(tc, test_latency_p99);
+    suite_add_tcase(s, tc);
+
+    tc = tcase_create("SchedulingStats");
+    tcase_add_test(tc, test_latency_stages);
+    suite_add_tcase(s, tc);
+
+    return s;
+}
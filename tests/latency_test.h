@@ -0,0 +1,8 @@
+#pragma once
+
+#include <check.h>
+#include <stdbool.h>
+
+#include "../src/latency.h"
+
+Suite* make_latency_suite(void);
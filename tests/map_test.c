@@ -60,6 +60,42 @@ START_TEST(test_intmap_full_capacity) {
 
 
 
+START_TEST(test_intmap_dense) {
+    int num_vertices = 1000;
+
+    IntMap* map = NewDenseIntMap(num_vertices);
+    ck_assert_ptr_nonnull(map);
+
+    for (int i = 0; i < num_vertices; i += 3) {
+        ck_assert(SetIntMapValue(map, i, -i, false));
+    }
+    // Keys out of the dense range are hashed
+    ck_assert(SetIntMapValue(map, -1, 7, false));
+    ck_assert(SetIntMapValue(map, num_vertices, 8, false));
+    ck_assert(!SetIntMapValue(map, 3, 0, false));
+    ck_assert_uint_eq(GetIntMapLength(map), (num_vertices + 2) / 3 + 2);
+
+    int value;
+    for (int i = 0; i < num_vertices; ++i) {
+        ck_assert(GetIntMapValue(map, i, &value) == (i % 3 == 0));
+    }
+    ck_assert(GetIntMapValue(map, 999, &value));
+    ck_assert_int_eq(value, -999);
+    ck_assert(GetIntMapValue(map, -1, &value));
+    ck_assert_int_eq(value, 7);
+    ck_assert(GetIntMapValue(map, num_vertices, &value));
+    ck_assert_int_eq(value, 8);
+
+    ck_assert(DeleteIntMapValue(map, 0));
+    ck_assert(!DeleteIntMapValue(map, 0));
+    ck_assert(DeleteIntMapValue(map, -1));
+    ck_assert(!GetIntMapValue(map, 0, &value));
+    ck_assert(!GetIntMapValue(map, -1, &value));
+    ck_assert_uint_eq(GetIntMapLength(map), (num_vertices + 2) / 3);
+
+    FreeIntMap(map);
+} END_TEST
+
 
 
 START_TEST(test_stringmap_simple1) {
@@ -95,7 +131,7 @@ START_TEST(test_stringmap_simple2) {
     GetStringMapValue(map, "000000000000000000000000000000000000", &n3);
 
     ck_assert((n1 == 1) && (n2 == 2) && (n3 == 3));
-    FreeIntMap(map);
+    FreeStringMap(map);
 } END_TEST
 
 START_TEST(test_stringmap_full_capacity_with_same_key_and_change) {
@@ -132,6 +168,93 @@ START_TEST(test_stringmap_full_capacity_with_same_key_and_no_change) {
     FreeStringMap(map);
 } END_TEST
 
+START_TEST(test_stringmap_growth) {
+    int num_keys = 100000;
+    char key[32];
+
+    StringMap* map = NewStringMap(1);
+    ck_assert_ptr_nonnull(map);
+
+    for (int i = 0; i < num_keys; ++i) {
+        snprintf(key, sizeof(key), "task-%d", i);
+        ck_assert(SetStringMapValue(map, key, i, false));
+    }
+    ck_assert_uint_eq(GetStringMapLength(map), num_keys);
+
+    int value;
+    for (int i = 0; i < num_keys; ++i) {
+        snprintf(key, sizeof(key), "task-%d", i);
+        ck_assert(GetStringMapValue(map, key, &value));
+        ck_assert_int_eq(value, i);
+    }
+    ck_assert(!GetStringMapValue(map, "task-100000", &value));
+
+    FreeStringMap(map);
+} END_TEST
+
+START_TEST(test_stringmap_delete) {
+    int num_keys = 5000;
+    char key[32];
+    int value;
+
+    StringMap* map = NewStringMap(0);
+    ck_assert_ptr_nonnull(map);
+
+    for (int i = 0; i < num_keys; ++i) {
+        snprintf(key, sizeof(key), "%d", i);
+        SetStringMapValue(map, key, i, false);
+    }
+
+    // Deleting every other key shifts the rest back, all of them have to stay reachable
+    for (int i = 0; i < num_keys; i += 2) {
+        snprintf(key, sizeof(key), "%d", i);
+        ck_assert(DeleteStringMapValue(map, key));
+    }
+    ck_assert(!DeleteStringMapValue(map, "0"));
+    ck_assert_uint_eq(GetStringMapLength(map), num_keys / 2);
+
+    for (int i = 0; i < num_keys; ++i) {
+        snprintf(key, sizeof(key), "%d", i);
+        if (i % 2 == 0) {
+            ck_assert(!GetStringMapValue(map, key, &value));
+        } else {
+            ck_assert(GetStringMapValue(map, key, &value));
+            ck_assert_int_eq(value, i);
+        }
+    }
+
+    // Deleted keys come back as new ones
+    ck_assert(SetStringMapValue(map, "0", 42, false));
+    ck_assert(GetStringMapValue(map, "0", &value));
+    ck_assert_int_eq(value, 42);
+
+    FreeStringMap(map);
+} END_TEST
+
+START_TEST(test_intmap_churn) {
+    IntMap* map = NewIntMap(0);
+    ck_assert_ptr_nonnull(map);
+
+    // Pid map pattern: a few keys live at once, far more pass through
+    int value;
+    for (int i = 0; i < 50000; ++i) {
+        ck_assert(SetIntMapValue(map, i, i, true));
+        if (i >= 8) {
+            ck_assert(DeleteIntMapValue(map, i - 8));
+        }
+    }
+    ck_assert_uint_eq(GetIntMapLength(map), 8);
+    ck_assert_uint_le(map->capacity_, 16);
+
+    for (int i = 50000 - 8; i < 50000; ++i) {
+        ck_assert(GetIntMapValue(map, i, &value));
+        ck_assert_int_eq(value, i);
+    }
+    ck_assert(!GetIntMapValue(map, 50000 - 9, &value));
+
+    FreeIntMap(map);
+} END_TEST
+
 
 Suite* make_map_suite(void) {
     Suite *s = suite_create("Map tests");
@@ -141,6 +264,8 @@ Suite* make_map_suite(void) {
     tcase_add_test(tc, test_intmap_simple1);
     tcase_add_test(tc, test_intmap_simple2);
     tcase_add_test(tc, test_intmap_full_capacity);
+    tcase_add_test(tc, test_intmap_churn);
+    tcase_add_test(tc, test_intmap_dense);
 
     suite_add_tcase(s, tc);
 
@@ -149,6 +274,8 @@ Suite* make_map_suite(void) {
     tcase_add_test(tc, test_stringmap_simple2);
     tcase_add_test(tc, test_stringmap_full_capacity_with_same_key_and_change);
     tcase_add_test(tc, test_stringmap_full_capacity_with_same_key_and_no_change);
+    tcase_add_test(tc, test_stringmap_growth);
+    tcase_add_test(tc, test_stringmap_delete);
 
     suite_add_tcase(s, tc);
 
@@ -0,0 +1,146 @@
+#include "mpmc_queue_test.h"
+
+#define MPMC_TEST_THREADS 4
+#define MPMC_TEST_PER_PRODUCER 100000
+
+START_TEST(test_mpmc_queue_simple) {
+    MpmcQueue* queue = NewMpmcQueue(5);
+    ck_assert_ptr_nonnull(queue);
+
+    // Capacity is rounded up to 8
+    for (int i = 0; i < 8; ++i) {
+        ck_assert(PushMpmcQueue(queue, i));
+    }
+    ck_assert(!PushMpmcQueue(queue, 8));
+    ck_assert_int_eq(errno, EAGAIN);
+
+    int value;
+    for (int i = 0; i < 8; ++i) {
+        ck_assert(PopMpmcQueue(queue, &value));
+        ck_assert_int_eq(value, i);
+    }
+    ck_assert(!PopMpmcQueue(queue, &value));
+
+    FreeMpmcQueue(queue);
+} END_TEST
+
+START_TEST(test_mpmc_queue_wraparound) {
+    MpmcQueue* queue = NewMpmcQueue(4);
+    ck_assert_ptr_nonnull(queue);
+
+    int value;
+    for (int i = 0; i < 10000; ++i) {
+        ck_assert(PushMpmcQueue(queue, i));
+        ck_assert(PushMpmcQueue(queue, -i));
+        ck_assert(PopMpmcQueue(queue, &value));
+        ck_assert_int_eq(value, i);
+        ck_assert(PopMpmcQueue(queue, &value));
+        ck_assert_int_eq(value, -i);
+    }
+    ck_assert(!PopMpmcQueue(queue, &value));
+
+    FreeMpmcQueue(queue);
+} END_TEST
+
+typedef struct MpmcTestWorker {
+    MpmcQueue* queue;
+    atomic_int* popped;  // shared count of elements popped by all consumers
+    int producer;
+    int* seen;           // consumers: how many times each value was popped
+    long long last[MPMC_TEST_THREADS];  // consumers: last sequence seen from each producer
+    bool in_order;
+} MpmcTestWorker;
+
+static void* ProduceMpmcTestValues(void* arg) {
+    MpmcTestWorker* worker = arg;
+    for (int i = 0; i < MPMC_TEST_PER_PRODUCER; ++i) {
+        while (!PushMpmcQueue(worker->queue, worker->producer * MPMC_TEST_PER_PRODUCER + i)) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void* ConsumeMpmcTestValues(void* arg) {
+    MpmcTestWorker* worker = arg;
+    int total = MPMC_TEST_THREADS * MPMC_TEST_PER_PRODUCER;
+    int value;
+
+    while (atomic_load(worker->popped) < total) {
+        if (!PopMpmcQueue(worker->queue, &value)) {
+            sched_yield();
+            continue;
+        }
+        atomic_fetch_add(worker->popped, 1);
+
+        // Each consumer has to see any single producer's values in push order
+        int producer = value / MPMC_TEST_PER_PRODUCER;
+        int sequence = value % MPMC_TEST_PER_PRODUCER;
+        if (sequence <= worker->last[producer]) {
+            worker->in_order = false;
+        }
+        worker->last[producer] = sequence;
+        __atomic_fetch_add(&worker->seen[value], 1, __ATOMIC_RELAXED);
+    }
+    return NULL;
+}
+
+START_TEST(test_mpmc_queue_threads) {
+    int total = MPMC_TEST_THREADS * MPMC_TEST_PER_PRODUCER;
+    MpmcQueue* queue = NewMpmcQueue(64);
+    int* seen = calloc(total, sizeof(int));
+    ck_assert_ptr_nonnull(queue);
+    ck_assert_ptr_nonnull(seen);
+
+    atomic_int popped;
+    atomic_init(&popped, 0);
+    MpmcTestWorker producers[MPMC_TEST_THREADS];
+    MpmcTestWorker consumers[MPMC_TEST_THREADS];
+    pthread_t threads[2 * MPMC_TEST_THREADS];
+
+    for (int i = 0; i < MPMC_TEST_THREADS; ++i) {
+        consumers[i] = (MpmcTestWorker){.queue = queue, .popped = &popped, .seen = seen, .in_order = true};
+        for (int p = 0; p < MPMC_TEST_THREADS; ++p) {
+            consumers[i].last[p] = -1;
+        }
+        ck_assert_int_eq(pthread_create(&threads[i], NULL, ConsumeMpmcTestValues, &consumers[i]), 0);
+    }
+    for (int i = 0; i < MPMC_TEST_THREADS; ++i) {
+        producers[i] = (MpmcTestWorker){.queue = queue, .producer = i};
+        ck_assert_int_eq(pthread_create(&threads[MPMC_TEST_THREADS + i], NULL, ProduceMpmcTestValues, &producers[i]), 0);
+    }
+    for (int i = 0; i < 2 * MPMC_TEST_THREADS; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    // Every value came out exactly once
+    bool exactly_once = true;
+    for (int i = 0; i < total; ++i) {
+        exactly_once = exactly_once && seen[i] == 1;
+    }
+    ck_assert(exactly_once);
+    for (int i = 0; i < MPMC_TEST_THREADS; ++i) {
+        ck_assert(consumers[i].in_order);
+    }
+
+    int value;
+    ck_assert(!PopMpmcQueue(queue, &value));
+
+    free(seen);
+    FreeMpmcQueue(queue);
+} END_TEST
+
+
+Suite* make_mpmc_queue_suite(void) {
+    Suite *s = suite_create("MPMC queue tests");
+    TCase *tc;
+
+    tc = tcase_create("MpmcQueueTests");
+    tcase_add_test(tc, test_mpmc_queue_simple);
+    tcase_add_test(tc, test_mpmc_queue_wraparound);
+    tcase_add_test(tc, test_mpmc_queue_threads);
+
+    suite_add_tcase(s, tc);
+
+    return s;
+}
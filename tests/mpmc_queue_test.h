@@ -0,0 +1,10 @@
+#pragma once
+
+#include <check.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "../src/mpmc_queue.h"
+
+Suite* make_mpmc_queue_suite(void);
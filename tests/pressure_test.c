@@ -0,0 +1,131 @@
+#include "pressure_test.h"
+
+// Sample taken `ms` milliseconds after the start with given cumulative stalls
+static PressureSample MakeSample(int64_t ms, uint64_t cpu_some_us, uint64_t io_full_us, double load1) {
+    PressureSample sample = {
+        .taken_ns = ms * 1000000,
+        .has_psi = true,
+        .cpu_some_us = cpu_some_us,
+        .io_full_us = io_full_us,
+        .load1 = load1
+    };
+    return sample;
+}
+
+static void ResetController(ConcurrencyController* ctrl, int num_cpus, int window, int max_window) {
+    InitConcurrencyController(ctrl, num_cpus, max_window);
+    ctrl->window = window;
+    ctrl->last_sample = MakeSample(0, 0, 0, 0);
+}
+
+START_TEST(test_pressure_initial_window) {
+    ConcurrencyController ctrl;
+
+    InitConcurrencyController(&ctrl, 4, 16);
+    ck_assert_int_eq(ctrl.window, 4);
+
+    InitConcurrencyController(&ctrl, 8, 2);
+    ck_assert_int_eq(ctrl.window, 2);
+
+    InitConcurrencyController(&ctrl, 0, 0);
+    ck_assert_int_eq(ctrl.window, 1);
+} END_TEST
+
+START_TEST(test_pressure_slow_start) {
+    ConcurrencyController ctrl;
+    ResetController(&ctrl, 2, 2, 64);
+
+    PressureSample sample = MakeSample(500, 0, 0, 0.5);
+    ck_assert_int_eq(UpdateConcurrencyWindow(&ctrl, &sample, true), 4);
+
+    sample = MakeSample(1000, 0, 0, 0.5);
+    ck_assert_int_eq(UpdateConcurrencyWindow(&ctrl, &sample, true), 8);
+
+    // First congestion ends slow start
+    sample = MakeSample(1500, 400000, 0, 0.5);
+    ck_assert_int_eq(UpdateConcurrencyWindow(&ctrl, &sample, true), 4);
+    ck_assert(!ctrl.slow_start);
+
+    sample = MakeSample(2000, 400000, 0, 0.5);
+    ck_assert_int_eq(UpdateConcurrencyWindow(&ctrl, &sample, true), 5);
+} END_TEST
+
+START_TEST(test_pressure_additive_increase) {
+    ConcurrencyController ctrl;
+    ResetController(&ctrl, 2, 2, 8);
+    ctrl.slow_start = false;
+
+    PressureSample sample = MakeSample(500, 1000, 0, 0.5);
+    ck_assert_int_eq(UpdateConcurrencyWindow(&ctrl, &sample, true), 3);
+
+    // Idle window must not grow
+    sample = MakeSample(1000, 2000, 0, 0.5);
+    ck_assert_int_eq(UpdateConcurrencyWindow(&ctrl, &sample, false), 3);
+
+    for (int i = 0; i < 10; ++i) {
+        sample = MakeSample(1500 + i * 500, 3000 + i * 1000, 0, 0.5);
+        UpdateConcurrencyWindow(&ctrl, &sample, true);
+    }
+    ck_assert_int_eq(ctrl.window, 8);
+} END_TEST
+
+START_TEST(test_pressure_multiplicative_decrease) {
+    ConcurrencyController ctrl;
+    ResetController(&ctrl, 1, 8, 8);
+
+    // Half of the interval stalled on CPU
+    PressureSample sample = MakeSample(500, 250000, 0, 0.5);
+    ck_assert_int_eq(UpdateConcurrencyWindow(&ctrl, &sample, true), 4);
+
+    // IO stall over threshold
+    sample = MakeSample(1000, 250000, 100000, 0.5);
+    ck_assert_int_eq(UpdateConcurrencyWindow(&ctrl, &sample, true), 2);
+
+    sample = MakeSample(1500, 500000, 200000, 0.5);
+    ck_assert_int_eq(UpdateConcurrencyWindow(&ctrl, &sample, true), 1);
+
+    // Never below one task per CPU
+    sample = MakeSample(2000, 750000, 300000, 0.5);
+    ck_assert_int_eq(UpdateConcurrencyWindow(&ctrl, &sample, true), 1);
+} END_TEST
+
+START_TEST(test_pressure_load_average_fallback) {
+    ConcurrencyController ctrl;
+    ResetController(&ctrl, 2, 4, 8);
+    ctrl.slow_start = false;
+
+    PressureSample sample = MakeSample(500, 0, 0, 1.0);
+    sample.has_psi = false;
+    ck_assert_int_eq(UpdateConcurrencyWindow(&ctrl, &sample, true), 5);
+
+    sample = MakeSample(1000, 0, 0, 4.0);
+    sample.has_psi = false;
+    ck_assert_int_eq(UpdateConcurrencyWindow(&ctrl, &sample, true), 2);
+} END_TEST
+
+START_TEST(test_pressure_read_sample) {
+    PressureSample sample;
+
+    // Either PSI or load average exists on any Linux
+    ck_assert(ReadPressureSample(&sample));
+    ck_assert(sample.load1 >= 0);
+    ck_assert(!ReadPressureSample(NULL));
+} END_TEST
+
+
+Suite* make_pressure_suite(void) {
+    Suite *s = suite_create("Pressure tests");
+    TCase *tc;
+
+    tc = tcase_create("ConcurrencyControllerTests");
+    tcase_add_test(tc, test_pressure_initial_window);
+    tcase_add_test(tc, test_pressure_slow_start);
+    tcase_add_test(tc, test_pressure_additive_increase);
+    tcase_add_test(tc, test_pressure_multiplicative_decrease);
+    tcase_add_test(tc, test_pressure_load_average_fallback);
+    tcase_add_test(tc, test_pressure_read_sample);
+
+    suite_add_tcase(s, tc);
+
+    return s;
+}
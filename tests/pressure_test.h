@@ -0,0 +1,8 @@
+#pragma once
+
+#include <check.h>
+#include <stdbool.h>
+
+#include "../src/pressure.h"
+
+Suite* make_pressure_suite(void);
@@ -74,6 +74,34 @@ START_TEST(test_queue_large_test) {
     FreeQueue(q);
 } END_TEST
 
+START_TEST(test_queue_wraparound) {
+    Queue* q = NewQueue();
+    ck_assert_ptr_nonnull(q);
+
+    // The front walks around the buffer while it grows, order has to survive every growth
+    int next_push = 0, next_pop = 0, value;
+    for (int round = 0; round < 1000; ++round) {
+        for (int i = 0; i < 3; ++i) {
+            ck_assert(Push(q, next_push++));
+        }
+        for (int i = 0; i < 2; ++i) {
+            ck_assert(Front(q, &value));
+            ck_assert_int_eq(value, next_pop++);
+            ck_assert(Pop(q));
+        }
+    }
+
+    while (!IsEmpty(q)) {
+        ck_assert(Front(q, &value));
+        ck_assert_int_eq(value, next_pop++);
+        Pop(q);
+    }
+    ck_assert_int_eq(next_pop, next_push);
+    ck_assert(!Front(q, &value));
+
+    FreeQueue(q);
+} END_TEST
+
 
 Suite* make_queue_suite(void) {
     Suite *s = suite_create("Queue tests");
@@ -84,6 +112,7 @@ Suite* make_queue_suite(void) {
     tcase_add_test(tc, test_queue_simple2);
     tcase_add_test(tc, test_queue_large_test);
     tcase_add_test(tc, test_queue_empty);
+    tcase_add_test(tc, test_queue_wraparound);
 
     suite_add_tcase(s, tc);
 
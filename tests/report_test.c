@@ -0,0 +1,76 @@
+#include "report_test.h"
+
+static char* task_names[] = {"build", "say \"hi\"", "deploy"};
+
+typedef struct FakeRun {
+    FakeConfig base;  // the config the context points to
+    TaskInfo infos[3];
+    Context context;
+} FakeRun;
+
+static void InitFakeRun(FakeRun* run) {
+    memset(run, 0, sizeof(FakeRun));
+    InitFakeConfig(&run->base, task_names, 3, 1);
+    run->context.tasks = run->infos;
+    run->context.config = &run->base.config;
+}
+
+START_TEST(test_report_tasks) {
+    FakeRun fake;
+    InitFakeRun(&fake);
+    char path[64];
+    MakeTempPath(path, "report_test");
+
+    fake.infos[0].task_status = TASK_STATUS_SUCCESS;
+    fake.infos[0].run = (TaskRunRecord){
+        .start_ns = 1000000000,
+        .end_ns = 1250000000,
+        .user_cpu_us = 120000,
+        .system_cpu_us = 30000,
+        .wait_status = W_EXITCODE(3, 0),
+        .max_rss_kb = 2048,
+        .voluntary_switches = 7,
+        .involuntary_switches = 2,
+        .block_input = 5,
+        .block_output = 9
+    };
+    fake.infos[1].task_status = TASK_STATUS_FAILED;
+    fake.infos[1].run = (TaskRunRecord){.wait_status = SIGKILL};
+    fake.infos[2].task_status = TASK_STATUS_SKIPPED;
+
+    ck_assert(WriteRunReport(path, &fake.context, 1.5));
+
+    char buffer[2048];
+    ReadFile(path, buffer, sizeof(buffer));
+    ck_assert_ptr_nonnull(strstr(buffer, "\"makespan_s\": 1.500000"));
+    ck_assert_ptr_nonnull(strstr(buffer,
+        "{\"name\": \"build\", \"status\": \"success\", \"exit_code\": 3"
+        ", \"wall_ms\": 250.000, \"user_ms\": 120.000, \"sys_ms\": 30.000, \"max_rss_kb\": 2048"
+        ", \"voluntary_switches\": 7, \"involuntary_switches\": 2"
+        ", \"block_input\": 5, \"block_output\": 9}"));
+    ck_assert_ptr_nonnull(strstr(buffer, "{\"name\": \"say \\\"hi\\\"\", \"status\": \"failed\", \"signal\": 9"));
+    ck_assert_ptr_nonnull(strstr(buffer, "{\"name\": \"deploy\", \"status\": \"skipped\"}\n"));
+
+    unlink(path);
+} END_TEST
+
+START_TEST(test_report_bad_path) {
+    FakeRun fake;
+    InitFakeRun(&fake);
+
+    ck_assert(!WriteRunReport("/nonexistent/dir/report.json", &fake.context, 0));
+    ck_assert(!WriteRunReport(NULL, &fake.context, 0));
+    ck_assert(errno == EINVAL);
+} END_TEST
+
+Suite* make_report_suite(void) {
+    Suite *s = suite_create("Report tests");
+    TCase *tc;
+
+    tc = tcase_create("WriteRunReport");
+    tcase_add_test(tc, test_report_tasks);
+    tcase_add_test(tc, test_report_bad_path);
+    suite_add_tcase(s, tc);
+
+    return s;
+}
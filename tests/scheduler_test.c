@@ -0,0 +1,357 @@
+#include "scheduler_test.h"
+
+// Diamond: 1 and 2 require 0, 3 requires both 1 and 2
+static Graph* NewDiamondGraph(void) {
+    Graph* g = NewGraph(4);
+
+    AddDirectedEdge(g, 1, 0);
+    AddDirectedEdge(g, 2, 0);
+    AddDirectedEdge(g, 3, 1);
+    AddDirectedEdge(g, 3, 2);
+
+    return g;
+}
+
+START_TEST(test_tracker_initial_ready) {
+    Graph* g = NewDiamondGraph();
+    DependencyTracker* tracker = NewDependencyTracker(g);
+    ck_assert_ptr_nonnull(tracker);
+
+    ck_assert(GetTrackedTaskCount(tracker) == 4);
+    ck_assert(IsTaskReady(tracker, 0));
+    ck_assert(!IsTaskReady(tracker, 1));
+    ck_assert(!IsTaskReady(tracker, 2));
+    ck_assert(!IsTaskReady(tracker, 3));
+
+    FreeDependencyTracker(tracker);
+    FreeGraph(g);
+} END_TEST
+
+START_TEST(test_tracker_dependents) {
+    Graph* g = NewDiamondGraph();
+    DependencyTracker* tracker = NewDependencyTracker(g);
+    ck_assert_ptr_nonnull(tracker);
+
+    size_t count;
+    const int* dependents = GetDependents(tracker, 0, &count);
+    ck_assert(count == 2);
+    ck_assert((dependents[0] == 1 && dependents[1] == 2) || (dependents[0] == 2 && dependents[1] == 1));
+
+    GetDependents(tracker, 3, &count);
+    ck_assert(count == 0);
+
+    FreeDependencyTracker(tracker);
+    FreeGraph(g);
+} END_TEST
+
+START_TEST(test_tracker_resolve) {
+    Graph* g = NewDiamondGraph();
+    DependencyTracker* tracker = NewDependencyTracker(g);
+    ck_assert_ptr_nonnull(tracker);
+
+    ck_assert(ResolveRequirement(tracker, 1) == 0);
+    ck_assert(ResolveRequirement(tracker, 2) == 0);
+    ck_assert(ResolveRequirement(tracker, 3) == 1);
+    ck_assert(!IsTaskReady(tracker, 3));
+    ck_assert(ResolveRequirement(tracker, 3) == 0);
+    ck_assert(IsTaskReady(tracker, 3));
+
+    // Resolving an already ready task is an error
+    ck_assert(ResolveRequirement(tracker, 3) == -1);
+
+    FreeDependencyTracker(tracker);
+    FreeGraph(g);
+} END_TEST
+
+START_TEST(test_tracker_does_not_mutate_graph) {
+    Graph* g = NewDiamondGraph();
+    DependencyTracker* tracker = NewDependencyTracker(g);
+    ck_assert_ptr_nonnull(tracker);
+
+    ResolveRequirement(tracker, 1);
+    ResolveRequirement(tracker, 2);
+
+    ck_assert(VertexHasSuccessors(g, 1));
+    ck_assert(VertexHasSuccessors(g, 2));
+    ck_assert(!VertexHasSuccessors(g, 0));
+
+    FreeDependencyTracker(tracker);
+    FreeGraph(g);
+} END_TEST
+
+START_TEST(test_tracker_bad_args) {
+    ck_assert_ptr_null(NewDependencyTracker(NULL));
+
+    Graph* g = NewGraph(2);
+    DependencyTracker* tracker = NewDependencyTracker(g);
+    ck_assert_ptr_nonnull(tracker);
+
+    size_t count;
+    ck_assert_ptr_null(GetDependents(tracker, 2, &count));
+    ck_assert(count == 0);
+    ck_assert(!IsTaskReady(tracker, 5));
+
+    FreeDependencyTracker(tracker);
+    FreeGraph(g);
+} END_TEST
+
+START_TEST(test_tracker_full_run_on_chain) {
+    int n = 1000;
+    Graph* g = NewGraph(n);
+    for (int i = 1; i < n; ++i) {
+        AddDirectedEdge(g, i, i - 1);
+    }
+
+    DependencyTracker* tracker = NewDependencyTracker(g);
+    ck_assert_ptr_nonnull(tracker);
+
+    int finished = 0;
+    int current = 0;
+    while (current != -1) {
+        finished++;
+
+        size_t count;
+        const int* dependents = GetDependents(tracker, current, &count);
+        current = -1;
+
+        for (size_t k = 0; k < count; ++k) {
+            if (ResolveRequirement(tracker, dependents[k]) == 0) {
+                current = dependents[k];
+            }
+        }
+    }
+
+    ck_assert(finished == n);
+    FreeDependencyTracker(tracker);
+    FreeGraph(g);
+} END_TEST
+
+START_TEST(test_tracker_skip_diamond) {
+    Graph* g = NewDiamondGraph();
+    DependencyTracker* tracker = NewDependencyTracker(g);
+    IntVector* skipped = NewIntVector(1);
+    ck_assert_ptr_nonnull(tracker);
+
+    // 3 is reachable through both 1 and 2 but skipped once
+    ck_assert_int_eq(SkipDependents(tracker, 0, skipped), 3);
+    ck_assert(GetIntVectorLength(skipped) == 3);
+    ck_assert(!IsTaskSkipped(tracker, 0));
+    ck_assert(IsTaskSkipped(tracker, 1));
+    ck_assert(IsTaskSkipped(tracker, 2));
+    ck_assert(IsTaskSkipped(tracker, 3));
+
+    ck_assert_int_eq(SkipDependents(tracker, 1, NULL), 0);
+    ck_assert_int_eq(SkipDependents(tracker, 4, NULL), -1);
+
+    FreeIntVector(skipped);
+    FreeDependencyTracker(tracker);
+    FreeGraph(g);
+} END_TEST
+
+START_TEST(test_tracker_skip_partial) {
+    Graph* g = NewDiamondGraph();
+    DependencyTracker* tracker = NewDependencyTracker(g);
+    ck_assert_ptr_nonnull(tracker);
+
+    ck_assert_int_eq(SkipDependents(tracker, 1, NULL), 1);
+    ck_assert(!IsTaskSkipped(tracker, 2));
+    ck_assert(IsTaskSkipped(tracker, 3));
+
+    // Only tasks not skipped yet are counted
+    ck_assert_int_eq(SkipDependents(tracker, 2, NULL), 0);
+    ck_assert_int_eq(SkipDependents(tracker, 0, NULL), 2);
+
+    FreeDependencyTracker(tracker);
+    FreeGraph(g);
+} END_TEST
+
+START_TEST(test_tracker_skip_deep_lattice) {
+    // Layers of two tasks, each requiring both tasks of the previous layer:
+    // 2^depth paths lead to the last layer
+    const int depth = 5000;
+    Graph* g = NewGraph(2 * depth);
+
+    for (int layer = 1; layer < depth; ++layer) {
+        for (int k = 0; k < 2; ++k) {
+            AddDirectedEdge(g, 2 * layer + k, 2 * (layer - 1));
+            AddDirectedEdge(g, 2 * layer + k, 2 * (layer - 1) + 1);
+        }
+    }
+
+    DependencyTracker* tracker = NewDependencyTracker(g);
+    ck_assert_ptr_nonnull(tracker);
+
+    ck_assert_int_eq(SkipDependents(tracker, 0, NULL), 2 * depth - 2);
+    ck_assert(!IsTaskSkipped(tracker, 1));
+    ck_assert(IsTaskSkipped(tracker, 2 * depth - 1));
+
+    FreeDependencyTracker(tracker);
+    FreeGraph(g);
+} END_TEST
+
+START_TEST(test_tracker_growing) {
+    DependencyTracker* tracker = NewGrowingDependencyTracker();
+    ck_assert_ptr_nonnull(tracker);
+
+    // The diamond arriving task by task, 0 finishes before 2 is added
+    int requirements[] = {0, 1, 2};
+    ck_assert(AddTrackedTask(tracker, 0, NULL, 0));
+    ck_assert(AddTrackedTask(tracker, 1, requirements, 1));
+    ck_assert(IsTaskReady(tracker, 0));
+    ck_assert(!IsTaskReady(tracker, 1));
+
+    FinishTrackedTask(tracker, 0, true);
+    ck_assert(ResolveRequirement(tracker, 1) == 0);
+    ck_assert(AddTrackedTask(tracker, 2, requirements, 1));
+    ck_assert(IsTaskReady(tracker, 2));
+
+    ck_assert(AddTrackedTask(tracker, 3, requirements + 1, 2));
+    ck_assert(GetTrackedTaskCount(tracker) == 4);
+    ck_assert(!IsTaskReady(tracker, 3));
+
+    size_t count;
+    const int* dependents = GetDependents(tracker, 1, &count);
+    ck_assert(count == 1 && dependents[0] == 3);
+    GetDependents(tracker, 3, &count);
+    ck_assert(count == 0);
+
+    // Requirements have to be added before, a task can't require itself
+    ck_assert(!AddTrackedTask(tracker, 5, (int[]){6}, 1));
+    ck_assert(!AddTrackedTask(tracker, 5, (int[]){5}, 1));
+
+    FreeDependencyTracker(tracker);
+} END_TEST
+
+START_TEST(test_tracker_growing_skip) {
+    DependencyTracker* tracker = NewGrowingDependencyTracker();
+    ck_assert_ptr_nonnull(tracker);
+
+    // 1 requires 0, which fails; 2 is added after that and is skipped right away
+    int requirements[] = {0, 1};
+    ck_assert(AddTrackedTask(tracker, 0, NULL, 0));
+    ck_assert(AddTrackedTask(tracker, 1, requirements, 1));
+
+    FinishTrackedTask(tracker, 0, false);
+    ck_assert_int_eq(SkipDependents(tracker, 0, NULL), 1);
+    ck_assert(IsTaskSkipped(tracker, 1));
+
+    ck_assert(AddTrackedTask(tracker, 2, requirements, 1));
+    ck_assert(IsTaskSkipped(tracker, 2));
+    ck_assert(AddTrackedTask(tracker, 3, requirements + 1, 1));
+    ck_assert(IsTaskSkipped(tracker, 3));
+
+    // Well past the initial capacity
+    for (int task = 4; task < 10 * TRACKER_INITIAL_CAPACITY; ++task) {
+        int previous = task - 1;
+        ck_assert(AddTrackedTask(tracker, task, task == 4 ? NULL : &previous, task == 4 ? 0 : 1));
+    }
+    ck_assert(IsTaskReady(tracker, 4));
+    ck_assert_int_eq(SkipDependents(tracker, 4, NULL), 10 * TRACKER_INITIAL_CAPACITY - 5);
+
+    FreeDependencyTracker(tracker);
+} END_TEST
+
+START_TEST(test_critical_paths_diamond) {
+    Graph* g = NewDiamondGraph();
+    long long weights[] = {1, 5, 2, 10};
+    long long paths[4];
+
+    ck_assert(ComputeCriticalPaths(g, weights, paths));
+    ck_assert(paths[3] == 10);
+    ck_assert(paths[2] == 12);
+    ck_assert(paths[1] == 15);
+    ck_assert(paths[0] == 16);
+
+    FreeGraph(g);
+} END_TEST
+
+START_TEST(test_critical_paths_independent) {
+    Graph* g = NewGraph(3);
+    long long weights[] = {4, 0, 7};
+    long long paths[3];
+
+    ck_assert(ComputeCriticalPaths(g, weights, paths));
+    ck_assert(paths[0] == 4 && paths[1] == 0 && paths[2] == 7);
+
+    FreeGraph(g);
+} END_TEST
+
+START_TEST(test_critical_paths_cycle) {
+    Graph* g = NewGraph(2);
+    AddDirectedEdge(g, 0, 1);
+    AddDirectedEdge(g, 1, 0);
+
+    long long weights[] = {1, 1};
+    long long paths[2];
+
+    ck_assert(!ComputeCriticalPaths(g, weights, paths));
+    FreeGraph(g);
+} END_TEST
+
+START_TEST(test_backfill_wide_task_starts) {
+    BackfillWindow window;
+
+    // 3 of 4 CPUs are busy, the wide task waits and small ones must not take the freed CPU
+    InitBackfillWindow(&window, 1, 1024);
+    ck_assert(!AdmitBackfillTask(&window, 4, 0));
+    ck_assert(!AdmitBackfillTask(&window, 1, 0));
+
+    // Its demand has freed up on the next pass
+    InitBackfillWindow(&window, 4, 1024);
+    ck_assert(AdmitBackfillTask(&window, 4, 0));
+    ck_assert(!AdmitBackfillTask(&window, 1, 0));
+    ck_assert(window.free_cpus == 0);
+    ck_assert(window.free_memory_mb == 1024);
+} END_TEST
+
+START_TEST(test_backfill_around_reservation) {
+    BackfillWindow window;
+    InitBackfillWindow(&window, 4, 100);
+
+    // Short of memory, so it holds 2 CPUs and all the memory
+    ck_assert(!AdmitBackfillTask(&window, 2, 200));
+    ck_assert(window.has_reservation);
+    ck_assert(window.free_cpus == 2);
+    ck_assert(window.free_memory_mb == 0);
+
+    ck_assert(!AdmitBackfillTask(&window, 1, 1));
+    ck_assert(AdmitBackfillTask(&window, 1, 0));
+
+    // Only the first refused task reserves
+    ck_assert(!AdmitBackfillTask(&window, 2, 0));
+    ck_assert(window.free_cpus == 1);
+    ck_assert(AdmitBackfillTask(&window, 1, 0));
+    ck_assert(window.free_cpus == 0);
+} END_TEST
+
+Suite* make_scheduler_suite(void) {
+    Suite *s = suite_create("Scheduler tests");
+    TCase *tc;
+
+    tc = tcase_create("DependencyTracker");
+    tcase_add_test(tc, test_tracker_initial_ready);
+    tcase_add_test(tc, test_tracker_dependents);
+    tcase_add_test(tc, test_tracker_resolve);
+    tcase_add_test(tc, test_tracker_does_not_mutate_graph);
+    tcase_add_test(tc, test_tracker_bad_args);
+    tcase_add_test(tc, test_tracker_full_run_on_chain);
+    tcase_add_test(tc, test_tracker_skip_diamond);
+    tcase_add_test(tc, test_tracker_skip_partial);
+    tcase_add_test(tc, test_tracker_skip_deep_lattice);
+    tcase_add_test(tc, test_tracker_growing);
+    tcase_add_test(tc, test_tracker_growing_skip);
+    suite_add_tcase(s, tc);
+
+    tc = tcase_create("CriticalPath");
+    tcase_add_test(tc, test_critical_paths_diamond);
+    tcase_add_test(tc, test_critical_paths_independent);
+    tcase_add_test(tc, test_critical_paths_cycle);
+    suite_add_tcase(s, tc);
+
+    tc = tcase_create("Backfill");
+    tcase_add_test(tc, test_backfill_wide_task_starts);
+    tcase_add_test(tc, test_backfill_around_reservation);
+    suite_add_tcase(s, tc);
+
+    return s;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <check.h>
+#include <stdbool.h>
+
+#include "../src/scheduler.h"
+
+Suite* make_scheduler_suite(void);
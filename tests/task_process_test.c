@@ -0,0 +1,153 @@
+#include "task_process_test.h"
+
+static bool OnOutput(EventSource* source, uint32_t events) {
+    TaskProcess* process = source->data;
+    return PumpTaskOutput(process, source, process->owner);
+}
+
+static char* ReadWholeFile(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return NULL;
+    }
+
+    char* content = calloc(4096, 1);
+    fread(content, 1, 4095, file);
+    fclose(file);
+    return content;
+}
+
+START_TEST(test_task_process_output_and_status) {
+    FILE* file = fopen("./tests/config_folder/spawn.cfg", "r");
+    ExecutionConfig* config = ReadExecutionConfig(file, "/tmp");
+    ck_assert_ptr_nonnull(config);
+    fclose(file);
+
+    EventLoop* loop = NewEventLoop();
+    ck_assert_ptr_nonnull(loop);
+
+    sigset_t mask;
+    sigemptyset(&mask);
+
+    TaskProcess process;
+    ck_assert(SpawnTaskProcess(&process, config->tasks[0], &mask, loop, OnOutput, loop));
+    ck_assert(process.pid > 0);
+    ck_assert(GetEventSourceCount(loop) == 2);
+
+    // Output pipes close once the command exits
+    while (GetEventSourceCount(loop) != 0) {
+        ck_assert(PollEventLoop(loop, 5000) > 0);
+    }
+    ck_assert(!IsTaskProcessDone(&process));
+
+    struct rusage usage;
+    int wait_status;
+    ck_assert(wait4(process.pid, &wait_status, 0, &usage) == process.pid);
+    SetTaskProcessExited(&process, wait_status, &usage);
+    ck_assert(IsTaskProcessDone(&process));
+    ck_assert(WIFEXITED(process.wait_status) && WEXITSTATUS(process.wait_status) == 3);
+
+    FinishTaskProcess(&process, loop);
+
+    char* log = ReadWholeFile(config->tasks[0]->log_path);
+    ck_assert_ptr_nonnull(log);
+    ck_assert_str_eq(log,
+        "Executing commands\n"
+        "=== Task output to stdout ===\nout\n=== End of task output to stdout ===\n"
+        "=== Task output to stderr ===\nerr\n=== End of task output to stderr ===\n"
+        "Proccess ended normally with code 3");
+
+    unlink(config->tasks[0]->log_path);
+    free(log);
+    FreeEventLoop(loop);
+    FreeExecutionConfig(config);
+} END_TEST
+
+START_TEST(test_task_process_sleep_log) {
+    FILE* file = fopen("./tests/config_folder/spawn.cfg", "r");
+    ExecutionConfig* config = ReadExecutionConfig(file, "/tmp");
+    ck_assert_ptr_nonnull(config);
+    fclose(file);
+
+    TaskProcess process;
+    ck_assert(StartSleepTask(&process, config->tasks[1], NULL));
+    ck_assert(process.pid == -1);
+    ck_assert(!IsTaskProcessDone(&process));
+
+    WriteTaskLog(&process, "Slept well\n");
+    SetTaskProcessExited(&process, W_EXITCODE(0, 0), NULL);
+    ck_assert(IsTaskProcessDone(&process));
+    FinishTaskProcess(&process, NULL);
+
+    char* log = ReadWholeFile(config->tasks[1]->log_path);
+    ck_assert_ptr_nonnull(log);
+    ck_assert_str_eq(log, "Feeling sleepy..\nSlept well\nProccess ended normally with code 0");
+
+    // EXEC task can't be run as a sleeper
+    ck_assert(!StartSleepTask(&process, config->tasks[0], NULL));
+
+    unlink(config->tasks[1]->log_path);
+    free(log);
+    FreeExecutionConfig(config);
+} END_TEST
+
+START_TEST(test_task_process_timed_out) {
+    FILE* file = fopen("./tests/config_folder/spawn.cfg", "r");
+    ExecutionConfig* config = ReadExecutionConfig(file, "/tmp");
+    ck_assert_ptr_nonnull(config);
+    fclose(file);
+
+    EventLoop* loop = NewEventLoop();
+    ck_assert_ptr_nonnull(loop);
+
+    sigset_t mask;
+    sigemptyset(&mask);
+
+    TaskProcess process;
+    ck_assert(SpawnTaskProcess(&process, config->tasks[0], &mask, loop, OnOutput, loop));
+    ck_assert(!process.timed_out);
+
+    int wait_status;
+    ck_assert(waitpid(process.pid, &wait_status, 0) == process.pid);
+    SetTaskProcessExited(&process, wait_status, NULL);
+
+    // The deadline came after the leader had exited on its own
+    process.timed_out = true;
+    FinishTaskProcess(&process, loop);
+    ck_assert(WIFSIGNALED(process.wait_status) && WTERMSIG(process.wait_status) == SIGKILL);
+
+    char* log = ReadWholeFile(config->tasks[0]->log_path);
+    ck_assert_ptr_nonnull(log);
+    ck_assert_ptr_nonnull(strstr(log, "Proccess aborted with code"));
+
+    unlink(config->tasks[0]->log_path);
+    free(log);
+    FreeEventLoop(loop);
+    FreeExecutionConfig(config);
+} END_TEST
+
+START_TEST(test_task_process_bad_args) {
+    sigset_t mask;
+    sigemptyset(&mask);
+
+    TaskProcess process;
+    ck_assert(!SpawnTaskProcess(&process, NULL, &mask, NULL, OnOutput, NULL));
+    ck_assert(!PumpTaskOutput(NULL, NULL, NULL));
+    ck_assert(!IsTaskProcessDone(NULL));
+} END_TEST
+
+
+Suite* make_task_process_suite(void) {
+    Suite *s = suite_create("Task process tests");
+    TCase *tc;
+
+    tc = tcase_create("SpawnTests");
+    tcase_add_test(tc, test_task_process_output_and_status);
+    tcase_add_test(tc, test_task_process_sleep_log);
+    tcase_add_test(tc, test_task_process_timed_out);
+    tcase_add_test(tc, test_task_process_bad_args);
+
+    suite_add_tcase(s, tc);
+
+    return s;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <check.h>
+#include <stdbool.h>
+
+#include "../src/task_process.h"
+
+Suite* make_task_process_suite(void);
@@ -5,18 +5,48 @@
 #include "graph_test.h"
 #include "map_test.h"
 #include "queue_test.h"
+#include "mpmc_queue_test.h"
 #include "vector_test.h"
 #include "utils_test.h"
 #include "config_test.h"
+#include "scheduler_test.h"
+#include "heap_test.h"
+#include "history_test.h"
+#include "pressure_test.h"
+#include "task_process_test.h"
+#include "timer_wheel_test.h"
+#include "report_test.h"
+#include "trace_test.h"
+#include "latency_test.h"
+#include "tokenizer_test.h"
+#include "arena_test.h"
+#include "intern_test.h"
+#include "dag_cache_test.h"
+#include "event_loop_test.h"
 
 int main(void) {
     SRunner *runner = srunner_create(NULL);
     srunner_add_suite(runner, make_graph_is_acyclic_suite());
     srunner_add_suite(runner, make_map_suite());
     srunner_add_suite(runner, make_queue_suite());
+    srunner_add_suite(runner, make_mpmc_queue_suite());
     srunner_add_suite(runner, make_vector_suite());
     srunner_add_suite(runner, make_utils_suite());
     srunner_add_suite(runner, make_config_suite());
+    srunner_add_suite(runner, make_scheduler_suite());
+    srunner_add_suite(runner, make_heap_suite());
+    srunner_add_suite(runner, make_history_suite());
+    srunner_add_suite(runner, make_pressure_suite());
+    srunner_add_suite(runner, make_task_process_suite());
+    srunner_add_suite(runner, make_timer_wheel_suite());
+    srunner_add_suite(runner, make_report_suite());
+    srunner_add_suite(runner, make_trace_suite());
+    srunner_add_suite(runner, make_latency_suite());
+    srunner_add_suite(runner, make_tokenizer_suite());
+    srunner_add_suite(runner, make_arena_suite());
+    srunner_add_suite(runner, make_intern_suite());
+    srunner_add_suite(runner, make_dag_cache_suite());
+    srunner_add_suite(runner, make_event_loop_suite());
     // TODO:
     // * graph tests
     // * map tests
@@ -0,0 +1,30 @@
+#include "test_utils.h"
+
+void InitFakeConfig(FakeConfig* fake, char** names, size_t num_tasks, int max_concurrent_tasks) {
+    ck_assert(num_tasks <= FAKE_CONFIG_MAX_TASKS);
+
+    memset(fake, 0, sizeof(FakeConfig));
+    for (size_t i = 0; i < num_tasks; ++i) {
+        fake->tasks[i].name = names[i];
+        fake->task_ptrs[i] = &fake->tasks[i];
+    }
+
+    fake->config.max_concurrent_tasks = max_concurrent_tasks;
+    fake->config.num_tasks = num_tasks;
+    fake->config.tasks = fake->task_ptrs;
+}
+
+void MakeTempPath(char* path, const char* prefix) {
+    snprintf(path, 64, "/tmp/%s_XXXXXX", prefix);
+    int fd = mkstemp(path);
+    ck_assert_int_ne(fd, -1);
+    close(fd);
+}
+
+void ReadFile(const char* path, char* buffer, size_t size) {
+    FILE* file = fopen(path, "r");
+    ck_assert_ptr_nonnull(file);
+    size_t nbytes = fread(buffer, 1, size - 1, file);
+    buffer[nbytes] = '\0';
+    fclose(file);
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <check.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../src/config.h"
+
+#define FAKE_CONFIG_MAX_TASKS 8
+
+// Execution config with named tasks only, for modules which never look past the names.
+typedef struct FakeConfig {
+    TaskConfig tasks[FAKE_CONFIG_MAX_TASKS];
+    TaskConfig* task_ptrs[FAKE_CONFIG_MAX_TASKS];
+    ExecutionConfig config;
+} FakeConfig;
+
+// Fill the fake config with num_tasks tasks named after names, every other field zeroed.
+void InitFakeConfig(FakeConfig* fake, char** names, size_t num_tasks, int max_concurrent_tasks);
+
+// Create an empty temporary file /tmp/<prefix>_XXXXXX, path has to hold 64 bytes.
+void MakeTempPath(char* path, const char* prefix);
+
+// Read the whole file into a NUL-terminated buffer, truncated to size - 1 bytes.
+void ReadFile(const char* path, char* buffer, size_t size);
@@ -0,0 +1,185 @@
+#include "timer_wheel_test.h"
+
+START_TEST(test_wheel_simple) {
+    TimerWheel* wheel = NewTimerWheel(1000);
+    ck_assert_ptr_nonnull(wheel);
+
+    WheelTimer t1, t2;
+    InitWheelTimer(&t1, NULL);
+    InitWheelTimer(&t2, NULL);
+
+    ck_assert(ArmWheelTimer(wheel, &t1, 1010));
+    ck_assert(ArmWheelTimer(wheel, &t2, 1005));
+    ck_assert(GetArmedWheelTimerCount(wheel) == 2);
+
+    uint64_t deadline;
+    ck_assert(GetNextWheelDeadline(wheel, &deadline));
+    ck_assert(deadline == 1005);
+
+    AdvanceTimerWheel(wheel, 1004);
+    ck_assert_ptr_null(PopExpiredWheelTimer(wheel));
+
+    AdvanceTimerWheel(wheel, 1005);
+    ck_assert_ptr_eq(PopExpiredWheelTimer(wheel), &t2);
+    ck_assert_ptr_null(PopExpiredWheelTimer(wheel));
+    ck_assert(!IsWheelTimerArmed(&t2));
+
+    AdvanceTimerWheel(wheel, 2000);
+    ck_assert_ptr_eq(PopExpiredWheelTimer(wheel), &t1);
+    ck_assert(GetArmedWheelTimerCount(wheel) == 0);
+    ck_assert(!GetNextWheelDeadline(wheel, &deadline));
+
+    FreeTimerWheel(wheel);
+} END_TEST
+
+START_TEST(test_wheel_cancel_and_rearm) {
+    TimerWheel* wheel = NewTimerWheel(0);
+    WheelTimer t1, t2;
+    InitWheelTimer(&t1, NULL);
+    InitWheelTimer(&t2, NULL);
+
+    ArmWheelTimer(wheel, &t1, 100);
+    ArmWheelTimer(wheel, &t2, 100000);
+    CancelWheelTimer(wheel, &t1);
+    CancelWheelTimer(wheel, &t1);
+    ck_assert(!IsWheelTimerArmed(&t1));
+    ck_assert(GetArmedWheelTimerCount(wheel) == 1);
+
+    // Rearming moves the timer instead of adding it twice
+    ArmWheelTimer(wheel, &t2, 50);
+    ck_assert(GetArmedWheelTimerCount(wheel) == 1);
+
+    AdvanceTimerWheel(wheel, 200000);
+    ck_assert_ptr_eq(PopExpiredWheelTimer(wheel), &t2);
+    ck_assert_ptr_null(PopExpiredWheelTimer(wheel));
+
+    // Past expiries are collected by the next advance, collected ones can still be cancelled
+    ArmWheelTimer(wheel, &t1, 10);
+    ArmWheelTimer(wheel, &t2, 10);
+    AdvanceTimerWheel(wheel, 200000);
+    CancelWheelTimer(wheel, &t1);
+    ck_assert_ptr_eq(PopExpiredWheelTimer(wheel), &t2);
+    ck_assert_ptr_null(PopExpiredWheelTimer(wheel));
+    ck_assert(GetArmedWheelTimerCount(wheel) == 0);
+
+    FreeTimerWheel(wheel);
+} END_TEST
+
+START_TEST(test_wheel_beyond_range) {
+    TimerWheel* wheel = NewTimerWheel(5);
+    WheelTimer timer;
+    InitWheelTimer(&timer, NULL);
+
+    // Farther than the last level covers
+    uint64_t expires = 5 + 3 * ((uint64_t)1 << (WHEEL_SLOT_BITS * WHEEL_LEVELS)) + 17;
+    ArmWheelTimer(wheel, &timer, expires);
+
+    uint64_t deadline;
+    ck_assert(GetNextWheelDeadline(wheel, &deadline));
+    ck_assert(deadline <= expires);
+
+    AdvanceTimerWheel(wheel, expires - 1);
+    ck_assert_ptr_null(PopExpiredWheelTimer(wheel));
+
+    AdvanceTimerWheel(wheel, expires);
+    ck_assert_ptr_eq(PopExpiredWheelTimer(wheel), &timer);
+
+    FreeTimerWheel(wheel);
+} END_TEST
+
+// Every timer must be collected by the first advance reaching its expiry, and not earlier
+START_TEST(test_wheel_random) {
+    const int n = 20000;
+    WheelTimer* timers = malloc(sizeof(WheelTimer) * n);
+    bool* cancelled = calloc(n, sizeof(bool));
+    TimerWheel* wheel = NewTimerWheel(777);
+    srand(42);
+
+    for (int i = 0; i < n; ++i) {
+        InitWheelTimer(&timers[i], NULL);
+
+        uint64_t span = (i % 4 == 0) ? 100 : (i % 4 == 1) ? 10000 : (i % 4 == 2) ? 1000000 : 100000000;
+        ArmWheelTimer(wheel, &timers[i], 777 + rand() % span);
+    }
+
+    for (int i = 0; i < n; i += 7) {
+        CancelWheelTimer(wheel, &timers[i]);
+        cancelled[i] = true;
+    }
+
+    uint64_t now = 777;
+    int collected = 0;
+    bool res = true;
+
+    while (GetArmedWheelTimerCount(wheel) != 0) {
+        uint64_t prev = now;
+        now += 1 + rand() % 300000;
+        AdvanceTimerWheel(wheel, now);
+
+        WheelTimer* timer;
+        while ((timer = PopExpiredWheelTimer(wheel))) {
+            int idx = timer - timers;
+            res = res && !cancelled[idx] && timer->expires_ms_ <= now && (timer->expires_ms_ > prev || prev == 777);
+            collected++;
+        }
+    }
+
+    int expected = 0;
+    for (int i = 0; i < n; ++i) {
+        expected += !cancelled[i];
+    }
+
+    ck_assert(res);
+    ck_assert_int_eq(collected, expected);
+
+    FreeTimerWheel(wheel);
+    free(cancelled);
+    free(timers);
+} END_TEST
+
+// Deadline reported by the wheel never skips over a pending expiry
+START_TEST(test_wheel_deadline_stepping) {
+    TimerWheel* wheel = NewTimerWheel(0);
+    WheelTimer timers[64];
+    srand(7);
+
+    for (int i = 0; i < 64; ++i) {
+        InitWheelTimer(&timers[i], NULL);
+        ArmWheelTimer(wheel, &timers[i], 1 + rand() % 5000000);
+    }
+
+    uint64_t deadline;
+    bool res = true;
+    int collected = 0;
+
+    while (GetNextWheelDeadline(wheel, &deadline)) {
+        AdvanceTimerWheel(wheel, deadline);
+
+        WheelTimer* timer;
+        while ((timer = PopExpiredWheelTimer(wheel))) {
+            res = res && timer->expires_ms_ == deadline;
+            collected++;
+        }
+    }
+
+    ck_assert(res);
+    ck_assert_int_eq(collected, 64);
+    FreeTimerWheel(wheel);
+} END_TEST
+
+
+Suite* make_timer_wheel_suite(void) {
+    Suite *s = suite_create("Timer wheel tests");
+    TCase *tc;
+
+    tc = tcase_create("TimerWheelTests");
+    tcase_add_test(tc, test_wheel_simple);
+    tcase_add_test(tc, test_wheel_cancel_and_rearm);
+    tcase_add_test(tc, test_wheel_beyond_range);
+    tcase_add_test(tc, test_wheel_random);
+    tcase_add_test(tc, test_wheel_deadline_stepping);
+
+    suite_add_tcase(s, tc);
+
+    return s;
+}
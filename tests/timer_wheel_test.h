@@ -0,0 +1,8 @@
+#pragma once
+
+#include <check.h>
+#include <stdbool.h>
+
+#include "../src/timer_wheel.h"
+
+Suite* make_timer_wheel_suite(void);
@@ -0,0 +1,156 @@
+#include "tokenizer_test.h"
+
+static const char* ScanSlowly(const char* begin, const char* end, const char** colon) {
+    *colon = NULL;
+    for (const char* ptr = begin; ptr < end; ++ptr) {
+        if (*ptr == '\n') {
+            return ptr;
+        }
+        if (*ptr == ':' && !*colon) {
+            *colon = ptr;
+        }
+    }
+
+    return end;
+}
+
+START_TEST(test_tokenizer_scan_matches_scalar) {
+    char text[200];
+
+    // Newlines and colons at every position relative to the 16 and 32 byte blocks
+    for (size_t newline = 0; newline < 100; ++newline) {
+        for (size_t colon = 0; colon < 100; colon += 7) {
+            memset(text, 'a', sizeof(text));
+            text[colon] = ':';
+            text[newline] = '\n';
+            text[newline + 40] = ':';
+
+            for (size_t start = 0; start < 33; start += 5) {
+                const char* end = text + 150;
+                const char* expected_colon;
+                const char* found_colon;
+                const char* expected = ScanSlowly(text + start, end, &expected_colon);
+
+                ck_assert_ptr_eq(ScanConfigLine(text + start, end, &found_colon), expected);
+                ck_assert_ptr_eq(found_colon, expected_colon);
+            }
+        }
+    }
+
+    // No newline at all
+    const char* colon;
+    memset(text, 'a', sizeof(text));
+    ck_assert_ptr_eq(ScanConfigLine(text, text + sizeof(text), &colon), text + sizeof(text));
+    ck_assert_ptr_null(colon);
+} END_TEST
+
+START_TEST(test_tokenizer_lines) {
+    const char* text = "[task]\n  name:   a  \n\nrequires: b  c\n# x: y\nlast";
+    ConfigBuffer buffer = {text, strlen(text), NULL, 0};
+    ConfigLineReader reader;
+    ConfigLine line;
+
+    InitConfigLineReader(&reader, &buffer);
+
+    ck_assert(NextConfigLine(&reader, &line));
+    ck_assert(ViewEquals(line.first, "[task]"));
+    ck_assert(line.key.len == 0);
+    ck_assert(line.value.len == 0);
+
+    ck_assert(NextConfigLine(&reader, &line));
+    ck_assert(ViewEquals(line.key, "name:"));
+    ck_assert(ViewEquals(line.value, "a"));
+
+    ck_assert(NextConfigLine(&reader, &line));
+    ck_assert(line.first.len == 0);
+
+    ck_assert(NextConfigLine(&reader, &line));
+    ck_assert(ViewEquals(line.key, "requires:"));
+    ck_assert(ViewEquals(line.value, "b  c"));
+    ck_assert(CountViewTokens(line.value) == 2);
+
+    ck_assert(NextConfigLine(&reader, &line));
+    ck_assert(ViewEquals(line.first, "#"));
+    ck_assert(line.key.len == 0);
+
+    ck_assert(NextConfigLine(&reader, &line));
+    ck_assert(ViewEquals(line.first, "last"));
+    ck_assert(GetConfigLineNumber(&reader) == 6);
+
+    ck_assert(!NextConfigLine(&reader, &line));
+} END_TEST
+
+START_TEST(test_tokenizer_tokens) {
+    const char* text = "  ab c   def ";
+    StringView rest = {text, strlen(text)};
+    StringView token;
+
+    ck_assert(NextViewToken(&rest, &token));
+    ck_assert(ViewEquals(token, "ab"));
+    ck_assert(NextViewToken(&rest, &token));
+    ck_assert(ViewEquals(token, "c"));
+    ck_assert(NextViewToken(&rest, &token));
+    ck_assert(ViewEquals(token, "def"));
+    ck_assert(!NextViewToken(&rest, &token));
+
+    char* str = ViewToString((StringView){text + 2, 2});
+    ck_assert_str_eq(str, "ab");
+    free(str);
+} END_TEST
+
+START_TEST(test_tokenizer_numbers) {
+    ck_assert(ViewToUnsigned((StringView){"42", 2}) == 42);
+    ck_assert(ViewToUnsigned((StringView){"420", 2}) == 42);
+    ck_assert(ViewToUnsigned((StringView){"0", 1}) == 0);
+    ck_assert(ViewToUnsigned((StringView){"4a", 2}) == -1);
+    ck_assert(ViewToUnsigned((StringView){"-1", 2}) == -1);
+    ck_assert(ViewToUnsigned((StringView){NULL, 0}) == -1);
+} END_TEST
+
+START_TEST(test_tokenizer_load_stream) {
+    FILE* file = tmpfile();
+    ck_assert_ptr_nonnull(file);
+
+    fputs("skipped\nname: x\n", file);
+    fflush(file);
+    fseek(file, 8, SEEK_SET);
+
+    // Mapped from the current position
+    ConfigBuffer buffer;
+    ck_assert(LoadConfigBuffer(file, &buffer));
+    ck_assert(buffer.size == 8);
+    ck_assert(memcmp(buffer.data, "name: x\n", 8) == 0);
+    ReleaseConfigBuffer(&buffer);
+    fclose(file);
+
+    // Pipes are read whole
+    int fds[2];
+    ck_assert(pipe(fds) == 0);
+    ck_assert(write(fds[1], "a: b", 4) == 4);
+    close(fds[1]);
+
+    file = fdopen(fds[0], "r");
+    ck_assert(LoadConfigBuffer(file, &buffer));
+    ck_assert(buffer.size == 4);
+    ck_assert(memcmp(buffer.data, "a: b", 4) == 0);
+    ReleaseConfigBuffer(&buffer);
+    fclose(file);
+} END_TEST
+
+Suite* make_tokenizer_suite(void) {
+    Suite *s = suite_create("Tokenizer tests");
+    TCase *tc;
+
+    tc = tcase_create("Scanner");
+    tcase_add_test(tc, test_tokenizer_scan_matches_scalar);
+    tcase_add_test(tc, test_tokenizer_lines);
+    suite_add_tcase(s, tc);
+
+    tc = tcase_create("Views");
+    tcase_add_test(tc, test_tokenizer_tokens);
+    tcase_add_test(tc, test_tokenizer_numbers);
+    tcase_add_test(tc, test_tokenizer_load_stream);
+    suite_add_tcase(s, tc);
+
+    return s;
+}
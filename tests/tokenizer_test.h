@@ -0,0 +1,8 @@
+#pragma once
+
+#include <check.h>
+#include <stdbool.h>
+
+#include "../src/tokenizer.h"
+
+Suite* make_tokenizer_suite(void);
@@ -0,0 +1,102 @@
+#include "trace_test.h"
+
+static char* task_names[] = {"build", "test", "lint"};
+
+static void RecordTaskRun(TraceRecorder* recorder, int task) {
+    RecordTraceEvent(recorder, TRACE_EVENT_SPAWN, task, -1);
+    RecordTraceEvent(recorder, TRACE_EVENT_RUNNING, task, -1);
+    RecordTraceEvent(recorder, TRACE_EVENT_EXITED, task, -1);
+    RecordTraceEvent(recorder, TRACE_EVENT_DONE, task, -1);
+}
+
+static size_t CountOccurrences(const char* str, const char* pattern) {
+    size_t count = 0;
+    for (const char* ptr = strstr(str, pattern); ptr; ptr = strstr(ptr + 1, pattern)) {
+        count++;
+    }
+    return count;
+}
+
+START_TEST(test_trace_spans_and_slots) {
+    FakeConfig fake;
+    InitFakeConfig(&fake, task_names, 3, 2);
+    char path[64];
+    MakeTempPath(path, "trace_test");
+
+    TraceRecorder* recorder = NewTraceRecorder(3);
+    ck_assert_ptr_nonnull(recorder);
+
+    // build and lint run side by side, test is released by build and reuses its slot
+    RecordTraceEvent(recorder, TRACE_EVENT_QUEUED, 0, -1);
+    RecordTraceEvent(recorder, TRACE_EVENT_QUEUED, 2, -1);
+    RecordTraceEvent(recorder, TRACE_EVENT_SPAWN, 0, -1);
+    RecordTraceEvent(recorder, TRACE_EVENT_SPAWN, 2, -1);
+    RecordTraceEvent(recorder, TRACE_EVENT_RUNNING, 0, -1);
+    RecordTraceEvent(recorder, TRACE_EVENT_RUNNING, 2, -1);
+    RecordTraceEvent(recorder, TRACE_EVENT_EXITED, 0, -1);
+    RecordTraceEvent(recorder, TRACE_EVENT_DONE, 0, -1);
+    RecordTraceEvent(recorder, TRACE_EVENT_RELEASE, 1, 0);
+    RecordTraceEvent(recorder, TRACE_EVENT_QUEUED, 1, -1);
+    RecordTaskRun(recorder, 1);
+    RecordTraceEvent(recorder, TRACE_EVENT_EXITED, 2, -1);
+    RecordTraceEvent(recorder, TRACE_EVENT_DONE, 2, -1);
+    ck_assert(GetTraceEventCount(recorder) == 16);
+
+    ck_assert(WriteTrace(recorder, &fake.config, path));
+
+    char buffer[8192];
+    ReadFile(path, buffer, sizeof(buffer));
+    ck_assert(CountOccurrences(buffer, "\"cat\": \"queued\"") == 6);
+    ck_assert(CountOccurrences(buffer, "\"cat\": \"spawn\"") == 3);
+    ck_assert(CountOccurrences(buffer, "\"cat\": \"run\"") == 3);
+    ck_assert(CountOccurrences(buffer, "\"cat\": \"drain\"") == 3);
+    ck_assert(CountOccurrences(buffer, "\"name\": \"thread_name\"") == 2);
+    ck_assert_ptr_nonnull(strstr(buffer, "\"tid\": 0, \"cat\": \"run\", \"name\": \"test\""));
+    ck_assert_ptr_nonnull(strstr(buffer, "\"tid\": 1, \"cat\": \"run\", \"name\": \"lint\""));
+    ck_assert_ptr_nonnull(strstr(buffer, "\"tid\": 0, \"cat\": \"release\", \"name\": \"test\""));
+    ck_assert_ptr_nonnull(strstr(buffer, "\"released_by\": \"build\""));
+    ck_assert_ptr_nonnull(strstr(buffer, "\"dropped_events\": 0"));
+
+    FreeTraceRecorder(recorder);
+    unlink(path);
+} END_TEST
+
+START_TEST(test_trace_buffer_is_bounded) {
+    TraceRecorder* recorder = NewTraceRecorder(1);
+    ck_assert_ptr_nonnull(recorder);
+
+    for (int i = 0; i < 2 * TRACE_EVENTS_PER_TASK; ++i) {
+        RecordTraceEvent(recorder, TRACE_EVENT_QUEUED, 0, -1);
+    }
+    ck_assert(GetTraceEventCount(recorder) == TRACE_EVENTS_PER_TASK);
+    ck_assert(recorder->num_dropped_ == TRACE_EVENTS_PER_TASK);
+
+    // Disabled tracing is a no-op
+    RecordTraceEvent(NULL, TRACE_EVENT_QUEUED, 0, -1);
+
+    FreeTraceRecorder(recorder);
+} END_TEST
+
+START_TEST(test_trace_bad_args) {
+    FakeConfig fake;
+    InitFakeConfig(&fake, task_names, 3, 2);
+
+    TraceRecorder* recorder = NewTraceRecorder(2);
+    ck_assert_ptr_nonnull(recorder);
+    ck_assert(!WriteTrace(recorder, &fake.config, "/tmp/trace_test_mismatch"));
+    ck_assert(errno == EINVAL);
+    FreeTraceRecorder(recorder);
+} END_TEST
+
+Suite* make_trace_suite(void) {
+    Suite *s = suite_create("Trace tests");
+    TCase *tc;
+
+    tc = tcase_create("TraceRecorder");
+    tcase_add_test(tc, test_trace_spans_and_slots);
+    tcase_add_test(tc, test_trace_buffer_is_bounded);
+    tcase_add_test(tc, test_trace_bad_args);
+    suite_add_tcase(s, tc);
+
+    return s;
+}
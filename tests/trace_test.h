@@ -0,0 +1,9 @@
+#pragma once
+
+#include <check.h>
+#include <stdbool.h>
+
+#include "../src/trace.h"
+#include "test_utils.h"
+
+Suite* make_trace_suite(void);
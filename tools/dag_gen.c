@@ -0,0 +1,243 @@
+// Synthetic DAG config generator for scheduler benchmarks.
+// Writes a config in the `[main]`/`[task]` grammar to stdout.
+//
+// Usage: dag_gen <chain|fan|diamond|layered|random> <num_tasks> [--exec] [--seed N] [--degree N] [--concurrency N]
+//
+// chain    task i requires task i - 1
+// fan      out-tree of the given degree followed by a mirrored in-tree, i.e. fan-out then fan-in
+// diamond  square lattice, every task requires its upper and left neighbours
+// layered  layers of sqrt(n) tasks, every task requires up to degree random tasks of the previous layer
+// random   Erdos-Renyi DAG, every earlier task is required with probability 2 * degree / n
+//
+// Tasks take no time: SLEEP with zero duration, or `true` with --exec.
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct GenArgs {
+    const char* shape;
+    size_t num_tasks;
+    bool exec;
+    uint64_t seed;
+    size_t degree;
+    size_t concurrency;
+} GenArgs;
+
+// xorshift64*, so that a seed gives the same config everywhere
+static uint64_t rng_state;
+
+static uint64_t NextRandom(void) {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 2685821657736338717ULL;
+}
+
+// Uniform in (0, 1]
+static double NextUniform(void) {
+    return ((NextRandom() >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+static void PrintRequirements(const size_t* requirements, size_t num_requirements) {
+    if (num_requirements == 0) {
+        return;
+    }
+
+    printf("requires:");
+    for (size_t i = 0; i < num_requirements; ++i) {
+        printf(" t%zu", requirements[i]);
+    }
+    printf("\n");
+}
+
+static void PrintTask(const GenArgs* args, size_t task, const size_t* requirements, size_t num_requirements) {
+    printf("[task]\nname: t%zu\n", task);
+    if (args->exec) {
+        printf("type: EXEC\nexec_command: true\n");
+    } else {
+        printf("type: SLEEP\nsleep_duration: 0\n");
+    }
+    PrintRequirements(requirements, num_requirements);
+    printf("\n");
+}
+
+static void GenerateChain(const GenArgs* args, size_t* requirements) {
+    for (size_t i = 0; i < args->num_tasks; ++i) {
+        requirements[0] = i - 1;
+        PrintTask(args, i, requirements, i > 0);
+    }
+}
+
+// Out-tree on the first half, its mirror image on the second: the in-tree node
+// mirroring out-tree node k requires the mirrors of k's children, or k itself for a leaf.
+static void GenerateFan(const GenArgs* args, size_t* requirements) {
+    size_t n = args->num_tasks;
+    size_t half = (n + 1) / 2;
+    size_t degree = args->degree;
+
+    for (size_t i = 0; i < half; ++i) {
+        requirements[0] = (i - 1) / degree;
+        PrintTask(args, i, requirements, i > 0);
+    }
+
+    for (size_t i = half; i < n; ++i) {
+        size_t mirrored = n - 1 - i;
+        size_t num_requirements = 0;
+
+        for (size_t child = mirrored * degree + 1; child <= mirrored * degree + degree && child < half; ++child) {
+            if (n - 1 - child >= half) {
+                requirements[num_requirements++] = n - 1 - child;
+            }
+        }
+        if (num_requirements == 0) {
+            requirements[num_requirements++] = mirrored;
+        }
+
+        PrintTask(args, i, requirements, num_requirements);
+    }
+}
+
+static void GenerateDiamond(const GenArgs* args, size_t* requirements) {
+    size_t width = (size_t)sqrt((double)args->num_tasks);
+    if (width == 0) {
+        width = 1;
+    }
+
+    for (size_t i = 0; i < args->num_tasks; ++i) {
+        size_t num_requirements = 0;
+
+        if (i >= width) {
+            requirements[num_requirements++] = i - width;
+        }
+        if (i % width != 0) {
+            requirements[num_requirements++] = i - 1;
+        }
+
+        PrintTask(args, i, requirements, num_requirements);
+    }
+}
+
+static void GenerateLayered(const GenArgs* args, size_t* requirements) {
+    size_t width = (size_t)sqrt((double)args->num_tasks);
+    if (width == 0) {
+        width = 1;
+    }
+
+    for (size_t i = 0; i < args->num_tasks; ++i) {
+        size_t num_requirements = 0;
+
+        if (i >= width) {
+            size_t layer_start = (i / width - 1) * width;
+            size_t wanted = 1 + NextRandom() % args->degree;
+
+            for (size_t k = 0; k < wanted; ++k) {
+                size_t required = layer_start + NextRandom() % width;
+                bool duplicate = false;
+
+                for (size_t j = 0; j < num_requirements; ++j) {
+                    duplicate |= requirements[j] == required;
+                }
+                if (!duplicate) {
+                    requirements[num_requirements++] = required;
+                }
+            }
+        }
+
+        PrintTask(args, i, requirements, num_requirements);
+    }
+}
+
+// Geometric skips over the candidates keep generation linear in tasks plus edges
+static void GenerateRandom(const GenArgs* args, size_t* requirements, size_t max_requirements) {
+    double p = 2.0 * args->degree / args->num_tasks;
+    if (p >= 1.0) {
+        p = 0.5;
+    }
+    double log_q = log(1.0 - p);
+
+    for (size_t i = 0; i < args->num_tasks; ++i) {
+        size_t num_requirements = 0;
+        double candidate = floor(log(NextUniform()) / log_q);
+
+        while (candidate < i && num_requirements < max_requirements) {
+            requirements[num_requirements++] = i - 1 - (size_t)candidate;
+            candidate += 1 + floor(log(NextUniform()) / log_q);
+        }
+
+        PrintTask(args, i, requirements, num_requirements);
+    }
+}
+
+static void Usage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s <chain|fan|diamond|layered|random> <num_tasks> "
+            "[--exec] [--seed N] [--degree N] [--concurrency N]\n",
+            program);
+    exit(1);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        Usage(argv[0]);
+    }
+
+    GenArgs args = {
+        .shape = argv[1],
+        .num_tasks = strtoull(argv[2], NULL, 10),
+        .exec = false,
+        .seed = 1,
+        .degree = 4,
+        .concurrency = 64
+    };
+
+    for (int i = 3; i < argc; ++i) {
+        if (strcmp(argv[i], "--exec") == 0) {
+            args.exec = true;
+        } else if (i + 1 < argc && strcmp(argv[i], "--seed") == 0) {
+            args.seed = strtoull(argv[++i], NULL, 10);
+        } else if (i + 1 < argc && strcmp(argv[i], "--degree") == 0) {
+            args.degree = strtoull(argv[++i], NULL, 10);
+        } else if (i + 1 < argc && strcmp(argv[i], "--concurrency") == 0) {
+            args.concurrency = strtoull(argv[++i], NULL, 10);
+        } else {
+            Usage(argv[0]);
+        }
+    }
+
+    if (args.num_tasks == 0 || args.degree == 0 || args.concurrency == 0) {
+        Usage(argv[0]);
+    }
+
+    // Requirement lines are bounded, so that they fit into the parser line buffer
+    const size_t max_requirements = args.degree < 16 ? 16 : args.degree;
+    size_t* requirements = malloc(sizeof(size_t) * max_requirements);
+    if (!requirements) {
+        perror("dag_gen");
+        return 1;
+    }
+
+    rng_state = args.seed * 0x9E3779B97F4A7C15ULL + 1;
+    printf("[main]\nmax_concurrent_tasks: %zu\ndefault_timeout: 10\n\n", args.concurrency);
+
+    if (strcmp(args.shape, "chain") == 0) {
+        GenerateChain(&args, requirements);
+    } else if (strcmp(args.shape, "fan") == 0) {
+        GenerateFan(&args, requirements);
+    } else if (strcmp(args.shape, "diamond") == 0) {
+        GenerateDiamond(&args, requirements);
+    } else if (strcmp(args.shape, "layered") == 0) {
+        GenerateLayered(&args, requirements);
+    } else if (strcmp(args.shape, "random") == 0) {
+        GenerateRandom(&args, requirements, max_requirements);
+    } else {
+        free(requirements);
+        Usage(argv[0]);
+    }
+
+    free(requirements);
+    return 0;
+}